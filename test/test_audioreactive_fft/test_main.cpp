@@ -0,0 +1,270 @@
+/*
+ * Host test of the audioreactive fixed-point FFT (SR_FFT_BACKEND 1) against a float FFT (what ArduinoFFT computes)
+ *
+ * Audio is read from WAV files and run through both FFTs and the same post-processing as FFTcode(), the resulting
+ * GEQ channels and beats must agree. Synthetic WAV files (sines, chords, noise) are always tested, set
+ * WLED_TEST_WAV_DIR to a directory of .wav files (mono or stereo, 16 bit PCM, any sample rate) to test real audio.
+ *   pio test -e native -f test_audioreactive_fft
+ */
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <dirent.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// stand-ins for wled.h and the settings of audio_reactive.cpp used by audio_fft.h (defaults of the usermod)
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+static unsigned long mockMillis = 0;
+static unsigned long millis() { return mockMillis; }
+static float mapf(float x, float in_min, float in_max, float out_min, float out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+using std::min;
+using std::max;
+
+#define NUM_GEQ_CHANNELS 16
+#define SR_FFT_BACKEND 1
+static float    multAgc = 1.0f;
+static float    sampleAvg = 10.0f;              // noise gate is kept open
+static uint8_t  soundAgc = 0;
+static bool     limiterOn = true;
+static uint16_t decayTime = 1400;
+static uint8_t  maxVol = 31;
+static uint8_t  binNum = 8;
+static uint8_t  inputLevel = 128;
+static uint8_t  sampleGain = 60;
+static uint8_t  FFTScalingMode = 3;
+static bool     useBandPassFilter = false;
+static unsigned long timeOfPeak = 0;
+
+#include "../../usermods/audioreactive/audio_fft.h"
+
+constexpr unsigned SAMPLE_RATE = 22050;
+
+// float FFT: ArduinoFFT dcRemoval() + windowing(Flat_top) + compute() + complexToMagnitude()
+static void floatCompute(float *samples) {
+  static float re[samplesFFT], im[samplesFFT];
+  float mean = 0.0f;
+  for (int i = 0; i < samplesFFT; i++) mean += samples[i];
+  mean /= samplesFFT;
+  for (int i = 0; i < samplesFFT; i++) {
+    unsigned j = 0;                               // bit reversal
+    for (unsigned b = 1, n = i; b < samplesFFT; b <<= 1, n >>= 1) j = (j << 1) | (n & 1);
+    re[j] = (samples[i] - mean) * fftFlatTop(i < samplesFFT_2 ? i : samplesFFT - 1 - i);
+    im[j] = 0.0f;
+  }
+  for (unsigned len = 2; len <= samplesFFT; len <<= 1) {
+    for (unsigned k = 0; k < len/2; k++) {
+      const float wr = cosf(2.0f * float(M_PI) * k / len), wi = -sinf(2.0f * float(M_PI) * k / len);
+      for (unsigned i = k; i < samplesFFT; i += len) {
+        const unsigned j = i + len/2;
+        const float tr = re[j] * wr - im[j] * wi, ti = re[j] * wi + im[j] * wr;
+        re[j] = re[i] - tr; im[j] = im[i] - ti;
+        re[i] += tr; im[i] += ti;
+      }
+    }
+  }
+  for (int k = 0; k < samplesFFT; k++) samples[k] = sqrtf(re[k] * re[k] + im[k] * im[k]);
+}
+
+// WAV files (16 bit PCM)
+static bool writeWav(const char *path, const std::vector<int16_t> &pcm, unsigned rate) {
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+  const uint32_t dataLen = pcm.size() * 2, riffLen = 36 + dataLen, fmtLen = 16, byteRate = rate * 2;
+  const uint16_t format = 1, channels = 1, align = 2, bits = 16;
+  fwrite("RIFF", 1, 4, f); fwrite(&riffLen, 4, 1, f); fwrite("WAVEfmt ", 1, 8, f);
+  fwrite(&fmtLen, 4, 1, f); fwrite(&format, 2, 1, f); fwrite(&channels, 2, 1, f); fwrite(&rate, 4, 1, f);
+  fwrite(&byteRate, 4, 1, f); fwrite(&align, 2, 1, f); fwrite(&bits, 2, 1, f);
+  fwrite("data", 1, 4, f); fwrite(&dataLen, 4, 1, f); fwrite(pcm.data(), 2, pcm.size(), f);
+  fclose(f);
+  return true;
+}
+
+// first channel of a 16 bit PCM WAV file, resampled to SAMPLE_RATE (linear interpolation)
+static bool readWav(const char *path, std::vector<float> &out) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return false;
+  char id[4]; uint32_t len, rate = 0; uint16_t format = 0, channels = 0, bits = 0;
+  std::vector<int16_t> pcm;
+  if (fread(id, 1, 4, f) != 4 || memcmp(id, "RIFF", 4) || fread(&len, 4, 1, f) != 1 || fread(id, 1, 4, f) != 4 || memcmp(id, "WAVE", 4)) {
+    fclose(f); return false;
+  }
+  while (fread(id, 1, 4, f) == 4 && fread(&len, 4, 1, f) == 1) {
+    if (!memcmp(id, "fmt ", 4)) {
+      uint8_t fmt[16];
+      if (len < 16 || fread(fmt, 1, 16, f) != 16) break;
+      memcpy(&format, fmt, 2); memcpy(&channels, fmt + 2, 2); memcpy(&rate, fmt + 4, 4); memcpy(&bits, fmt + 14, 2);
+      fseek(f, len - 16 + (len & 1), SEEK_CUR);
+    } else if (!memcmp(id, "data", 4) && format == 1 && bits == 16 && channels > 0) {
+      std::vector<int16_t> raw(len / 2);
+      raw.resize(fread(raw.data(), 2, raw.size(), f));
+      for (size_t i = 0; i < raw.size(); i += channels) pcm.push_back(raw[i]);
+      break;
+    } else fseek(f, len + (len & 1), SEEK_CUR);
+  }
+  fclose(f);
+  if (pcm.size() < 2 || rate == 0) return false;
+  out.clear();
+  for (double t = 0; t < pcm.size() - 1; t += double(rate) / SAMPLE_RATE) {
+    const size_t i = size_t(t);
+    out.push_back(float(pcm[i] + (pcm[i+1] - pcm[i]) * (t - i)));
+  }
+  return true;
+}
+
+typedef struct { uint8_t geq[NUM_GEQ_CHANNELS]; bool beat; } frameResult_t;
+
+// the part of FFTcode() that turns a batch of samples into GEQ channels and beats (one frame every 23ms)
+static std::vector<frameResult_t> processAudio(const std::vector<float> &audio, bool fixedPoint) {
+  static float   real[samplesFFT], imag[samplesFFT];
+  vReal = real; vImag = imag;
+  fftFixedInit();
+  memset(fftCalc, 0, sizeof(fftCalc));
+  memset(fftAvg, 0, sizeof(fftAvg));
+  mockMillis = 1000; timeOfPeak = 0;
+  std::vector<frameResult_t> frames;
+  for (size_t pos = 0; pos + samplesFFT <= audio.size(); pos += samplesFFT) {
+    memcpy(vReal, &audio[pos], sizeof(real));
+    if (fixedPoint) fftFixedCompute(vReal, fftWork);
+    else            floatCompute(vReal);
+    vReal[0] = 0;
+    fftResultsToChannels();
+    frameResult_t r;
+    postProcessFFTResults(true, NUM_GEQ_CHANNELS, r.geq);
+    r.beat = detectSamplePeak();
+    if (r.beat) timeOfPeak = millis();          // done by AudioReactive::loop() when it takes the frame
+    frames.push_back(r);
+    mockMillis += 23;
+  }
+  return frames;
+}
+
+// runs both FFTs on a WAV file and checks that GEQ channels and beats agree
+// GEQ channels may differ a lot in single frames, where a channel is close to the threshold of FFTScalingMode (0 or >20).
+// The beat detector triggers every 100ms while a bin is loud, so a beat one frame earlier or later counts as matching.
+static void compareWav(const char *path) {
+  std::vector<float> audio;
+  char msg[256];
+  snprintf(msg, sizeof(msg), "cannot read %s", path);
+  TEST_ASSERT_TRUE_MESSAGE(readWav(path, audio), msg);
+  const std::vector<frameResult_t> ref = processAudio(audio, false);
+  const std::vector<frameResult_t> fix = processAudio(audio, true);
+  TEST_ASSERT_EQUAL(ref.size(), fix.size());
+  unsigned values = 0, close = 0, maxDiff = 0, beats = 0, beatDiff = 0;
+  for (size_t f = 0; f < ref.size(); f++) {
+    for (int i = 0; i < NUM_GEQ_CHANNELS; i++) {
+      const unsigned d = abs(int(ref[f].geq[i]) - int(fix[f].geq[i]));
+      values++;
+      if (d <= 2) close++;
+      if (d > maxDiff) maxDiff = d;
+    }
+    beats += ref[f].beat;
+    if (ref[f].beat != fix[f].beat) {
+      const std::vector<frameResult_t> &other = ref[f].beat ? fix : ref;
+      if (!(f > 0 && other[f-1].beat) && !(f+1 < other.size() && other[f+1].beat)) beatDiff++;
+    }
+  }
+  snprintf(msg, sizeof(msg), "%s: %u frames, %.2f%% GEQ values within +/-2 (max difference %u), %u beats, %u not matched",
+           path, unsigned(ref.size()), 100.0 * close / max(values, 1u), maxDiff, beats, beatDiff);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_GREATER_OR_EQUAL_MESSAGE(values * 99 / 100, close, msg);
+  TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(ref.size() / 100, beatDiff, msg);
+}
+
+static void synthWav(const char *path, unsigned seconds, float (*signal)(float t, unsigned n)) {
+  std::vector<int16_t> pcm;
+  for (unsigned n = 0; n < seconds * SAMPLE_RATE; n++) pcm.push_back(int16_t(constrain(lrintf(signal(float(n) / SAMPLE_RATE, n)), -32767L, 32767L)));
+  TEST_ASSERT_TRUE(writeWav(path, pcm, SAMPLE_RATE));
+}
+
+static float noise() { return float(rand() % 20001 - 10000) / 10000.0f; }
+
+void setUp(void) { srand(1); }
+void tearDown(void) {}
+
+// magnitudes of single bins: error relative to the strongest bin, from very quiet to full scale input
+void test_fixed_fft_bins(void) {
+  TEST_ASSERT_TRUE(fftFixedInit());
+  static float ref[samplesFFT], fix[samplesFFT];
+  static int16_t work[samplesFFT];
+  const float amplitudes[] = {0.5f, 4.0f, 60.0f, 1000.0f, 30000.0f};
+  for (float a : amplitudes) {
+    for (int run = 0; run < 20; run++) {
+      const float f1 = 40 + rand() % 4000, f2 = 100 + rand() % 9000;
+      for (int i = 0; i < samplesFFT; i++) {
+        ref[i] = fix[i] = 100.0f + a * (0.6f * sinf(2 * float(M_PI) * f1 * i / SAMPLE_RATE) + 0.3f * sinf(2 * float(M_PI) * f2 * i / SAMPLE_RATE + 1) + 0.1f * noise());
+      }
+      floatCompute(ref);
+      fftFixedCompute(fix, work);
+      float peak = 0.0f, err = 0.0f;
+      for (int k = 1; k < samplesFFT; k++) peak = max(peak, ref[k]);
+      for (int k = 1; k < samplesFFT; k++) err = max(err, fabsf(fix[k] - ref[k]));
+      TEST_ASSERT_LESS_THAN(1e-3f * peak, err);
+    }
+  }
+  for (int i = 0; i < samplesFFT; i++) fix[i] = 0.0f;  // silence
+  fftFixedCompute(fix, work);
+  for (int k = 0; k < samplesFFT; k++) TEST_ASSERT_EQUAL(0, fix[k] != 0.0f);
+}
+
+void test_geq_synthetic_wavs(void) {
+  const char *path = "test_audioreactive_fft.wav";
+  synthWav(path, 10, [](float t, unsigned) {           // sine sweep 40Hz - 10kHz: quiet, medium and loud (GEQ saturated)
+    const float level = (t < 3.3f) ? 40.0f : (t < 6.6f) ? 150.0f : 1000.0f;
+    return level * sinf(2 * float(M_PI) * 40.0f * (powf(250.0f, t / 10.0f) - 1.0f) * 10.0f / logf(250.0f));
+  });
+  compareWav(path);
+  synthWav(path, 10, [](float t, unsigned) {           // chords and kick drum every 0.5s
+    const float kick = fmodf(t, 0.5f) < 0.08f ? 3000.0f * expf(-fmodf(t, 0.5f) * 40.0f) * sinf(2 * float(M_PI) * 60.0f * t) : 0.0f;
+    const float base = (fmodf(t, 2.0f) < 1.0f) ? 220.0f : 196.0f;
+    return kick + 300.0f * (sinf(2 * float(M_PI) * base * t) + sinf(2 * float(M_PI) * base * 1.26f * t) + sinf(2 * float(M_PI) * base * 1.5f * t));
+  });
+  compareWav(path);
+  synthWav(path, 5, [](float, unsigned) { return 800.0f * noise(); });  // white noise
+  compareWav(path);
+  remove(path);
+}
+
+void test_geq_wav_dir(void) {
+  const char *dirName = getenv("WLED_TEST_WAV_DIR");
+  if (!dirName) TEST_IGNORE_MESSAGE("set WLED_TEST_WAV_DIR to test with real audio");
+  DIR *dir = opendir(dirName);
+  TEST_ASSERT_NOT_NULL_MESSAGE(dir, dirName);
+  while (struct dirent *e = readdir(dir)) {
+    const std::string name = e->d_name;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".wav") == 0) compareWav((std::string(dirName) + "/" + name).c_str());
+  }
+  closedir(dir);
+}
+
+// runtime on the host, for comparison of both FFTs only
+void test_benchmark(void) {
+  static float samples[samplesFFT];
+  static int16_t work[samplesFFT];
+  for (int b = 0; b < 2; b++) {
+    const clock_t start = clock();
+    for (int run = 0; run < 2000; run++) {
+      for (int i = 0; i < samplesFFT; i++) samples[i] = 500.0f * sinf(i * 0.3f) + 50.0f * noise();
+      if (b) fftFixedCompute(samples, work);
+      else   floatCompute(samples);
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%s FFT: %.1f us", b ? "fixed-point" : "float", 1e6 * double(clock() - start) / CLOCKS_PER_SEC / 2000);
+    TEST_MESSAGE(msg);
+  }
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_fft_bins);
+  RUN_TEST(test_geq_synthetic_wavs);
+  RUN_TEST(test_geq_wav_dir);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,172 @@
+/*
+ * Re-encoding only changed pixels of a double buffered digital bus (bus_encode.h)
+ *
+ * bus_manager.cpp needs Arduino and NeoPixelBus, so BusDigital::show() is modelled here with the same BusDirtyRange
+ * against a mock of NeoPixelBus' edit/send buffers: show(false) swaps buffers (the new edit buffer holds an old frame),
+ * show(true) copies the send buffer back. Output must be the same as encoding all pixels on every frame.
+ *   pio test -e native -f test_bus_dirty_encode
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include "bus_encode.h"
+
+// NeoPixelBus with separate edit and send buffers (RMT, I2S)
+struct MockPolyBus {
+  std::vector<uint32_t> edit, send;
+  unsigned encoded = 0;
+  explicit MockPolyBus(unsigned len) : edit(len, 0), send(len, 0) {}
+  void setPixelColor(unsigned pix, uint32_t c, uint8_t co, uint8_t bri) {
+    edit[pix] = ((((c >> 16) & 0xFF) * (bri+1)) >> 8 << 16 | (((c >> 8) & 0xFF) * (bri+1)) >> 8 << 8 | ((c & 0xFF) * (bri+1)) >> 8) ^ (uint32_t(co) << 24);
+    encoded++;
+  }
+  void show(bool consistent) { if (consistent) send = edit; else std::swap(edit, send); }
+};
+
+// color order runs of a bus (see BusDigital::buildColorOrderRuns())
+struct ColorOrderRun { uint16_t start; uint8_t colorOrder; };
+
+// model of BusDigital with double buffer (_data)
+struct Bus {
+  unsigned len;
+  bool dirtyTracking;                           // false: old behaviour, all pixels are encoded on every show()
+  std::vector<uint32_t> data;
+  std::vector<ColorOrderRun> runs;
+  MockPolyBus bus;
+  BusDirtyRange dirty;
+  uint8_t  bri = 255;
+
+  Bus(unsigned l, bool tracking) : len(l), dirtyTracking(tracking), data(l, 0), bus(l), dirty(l) {
+    for (unsigned i = 0; i < len; i++) {        // ColorOrderMap: a different color order every 100 pixels
+      const uint8_t co = (i / 100) % 3;
+      if (runs.empty() || runs.back().colorOrder != co) runs.push_back({uint16_t(i), co});
+    }
+  }
+  void setPixelColor(unsigned pix, uint32_t c) {
+    if (data[pix] == c) return;
+    data[pix] = c;
+    dirty.mark(pix);
+  }
+  void encodePixels(unsigned from, unsigned to) {
+    unsigned run = 0;
+    while (run + 1 < runs.size() && runs[run + 1].start <= from) run++;
+    while (from < to) {
+      const unsigned end = std::min(to, run + 1 < runs.size() ? unsigned(runs[run + 1].start) : len);
+      for (unsigned i = from; i < end; i++) bus.setPixelColor(i, data[i], runs[run].colorOrder, bri);
+      from = end;
+      run++;
+    }
+  }
+  void show() {
+    if (!dirtyTracking) {
+      encodePixels(0, len);
+      bus.show(false);
+      return;
+    }
+    const BusEncodeRange r = dirty.next(bri, 0);
+    if (r.from < r.to) encodePixels(r.from, r.to);
+    bus.show(r.consistent);
+  }
+};
+
+static std::mt19937 rng;
+
+void setUp(void) { rng.seed(1); }
+void tearDown(void) {}
+
+// frames: full changes, small overlays, static frames and brightness (ABL) changes
+static void runFrames(Bus &a, Bus &b, unsigned frames, unsigned overlay) {
+  for (unsigned f = 0; f < frames; f++) {
+    const bool full = (f % 50) < 3;
+    for (unsigned i = 0; i < a.len; i++) {
+      uint32_t c = full ? rng() & 0xFFFFFF : ((i >= 500 && i < 500 + overlay) ? (f * 7 + i) & 0xFFFFFF : 0x102030);
+      if (f % 10 == 9) c = a.data[i];            // static frame
+      a.setPixelColor(i, c);
+      b.setPixelColor(i, c);
+    }
+    a.bri = b.bri = (f % 97 == 0) ? 128 + f % 64 : 255;
+    a.show();
+    b.show();
+    char msg[32];
+    snprintf(msg, sizeof(msg), "frame %u", f);
+    TEST_ASSERT_TRUE_MESSAGE(a.bus.send == b.bus.send, msg);
+  }
+}
+
+void test_output_matches_full_encoding(void) {
+  Bus full(1024, false), dirty(1024, true);
+  runFrames(full, dirty, 2000, 20);
+  char msg[96];
+  snprintf(msg, sizeof(msg), "pixels encoded: all %u, changed only %u", full.bus.encoded, dirty.bus.encoded);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_THAN(full.bus.encoded / 4, dirty.bus.encoded);
+}
+
+void test_single_pixel_changes(void) {
+  Bus full(300, false), dirty(300, true);
+  for (unsigned f = 0; f < 500; f++) {
+    const unsigned pix = rng() % 300;
+    const uint32_t c = rng() & 0xFFFFFF;
+    full.setPixelColor(pix, c);
+    dirty.setPixelColor(pix, c);
+    full.show();
+    dirty.show();
+    TEST_ASSERT_TRUE(full.bus.send == dirty.bus.send);
+  }
+}
+
+// first show() and brightness changes encode everything, WS2812_1CH_X3 ranges cover whole ICs
+void test_range(void) {
+  BusDirtyRange d(30);
+  BusEncodeRange r = d.next(255, 0, false, 3);
+  TEST_ASSERT_TRUE(r.from == 0 && r.to == 30 && !r.consistent);
+  r = d.next(255, 0, false, 3);
+  TEST_ASSERT_TRUE(r.from == 0 && r.to == 30);  // nothing changed, but buffer was swapped on last show()
+  r = d.next(255, 0, false, 3);
+  TEST_ASSERT_TRUE(r.from >= r.to);
+  d.mark(4);
+  d.mark(7);
+  r = d.next(255, 0, false, 3);
+  TEST_ASSERT_TRUE(r.from == 3 && r.to == 9 && r.consistent);
+  d.mark(29);
+  r = d.next(128, 0);
+  TEST_ASSERT_TRUE(r.from == 0 && r.to == 30 && r.consistent);
+  d.mark(29);
+  r = d.next(128, 0, true);                     // dithering
+  TEST_ASSERT_TRUE(r.from == 0 && r.to == 30 && !r.consistent);
+}
+
+void test_benchmark(void) {
+  Bus full(1024, false), dirty(1024, true);
+  double t[2] = {0, 0};
+  for (unsigned f = 0; f < 2000; f++) {
+    for (unsigned i = 0; i < 1024; i++) {
+      const uint32_t c = (i >= 500 && i < 520) ? (f * 7 + i) & 0xFFFFFF : 0x102030;
+      full.setPixelColor(i, c);
+      dirty.setPixelColor(i, c);
+    }
+    clock_t start = clock();
+    full.show();
+    t[0] += clock() - start;
+    start = clock();
+    dirty.show();
+    t[1] += clock() - start;
+  }
+  char msg[96];
+  snprintf(msg, sizeof(msg), "show() of 1024 pixels with 20 changing: all %.1f us, changed only %.1f us",
+           1e6 * t[0] / CLOCKS_PER_SEC / 2000, 1e6 * t[1] / CLOCKS_PER_SEC / 2000);
+  TEST_MESSAGE(msg);
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_output_matches_full_encoding);
+  RUN_TEST(test_single_pixel_changes);
+  RUN_TEST(test_range);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,118 @@
+/*
+ * Temporal dithering of 8 bit digital buses (ditherPixel() in bus_encode.h)
+ *
+ * bus_manager.cpp needs Arduino and NeoPixelBus, so the loops of BusDigital::encodeDither() and of
+ * BusDigital::encodePlain() (with luminance scaling as NeoPixelBusLg applies it) are modelled here.
+ *   pio test -e native -f test_bus_dither
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "bus_encode.h"
+
+static uint8_t out[4];                          // pixel written to the bus (single pixel tests)
+
+// NeoPixelBusLg: luminance is applied when a pixel is set, result is truncated
+template<unsigned chans>
+static void encodePlain(const uint8_t *data, unsigned len, unsigned bri, uint8_t *dst = out) {
+  for (unsigned i = 0; i < len; i++, data += chans, dst += chans)
+    for (unsigned ch = 0; ch < chans; ch++) dst[ch] = (data[ch] * (bri + 1)) >> 8;
+}
+
+// BusDigital::encodeDither() writing WRGB from ditherPixel() into the bus
+template<unsigned chans>
+static void encodeDither(const uint8_t *data, uint8_t *err, unsigned len, unsigned bri, uint8_t *dst = out) {
+  for (unsigned i = 0; i < len; i++, data += chans, err += chans, dst += chans) {
+    const uint32_t c = ditherPixel<chans>(data, err, bri);
+    dst[0] = c >> 16;
+    dst[1] = c >> 8;
+    dst[2] = c;
+    if (chans > 3) dst[3] = c >> 24;
+  }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// averaged over 256 frames dithered output matches the exact scaled value, truncation is off by up to 1
+void test_mean_output_is_exact(void) {
+  double maxErrPlain = 0, maxErrDither = 0;
+  for (unsigned bri = 1; bri < 256; bri += 3) {
+    for (unsigned v = 0; v < 256; v++) {
+      const uint8_t data[3] = {uint8_t(v), 0, 0};
+      uint8_t err[3] = {0, 0, 0};
+      unsigned sum = 0;
+      for (int f = 0; f < 256; f++) { encodeDither<3>(data, err, 1, bri); sum += out[0]; }
+      const double exact = v * (bri + 1) / 256.0;
+      maxErrDither = fmax(maxErrDither, fabs(sum / 256.0 - exact));
+      encodePlain<3>(data, 1, bri);
+      maxErrPlain = fmax(maxErrPlain, exact - out[0]);
+    }
+  }
+  char msg[96];
+  snprintf(msg, sizeof(msg), "max error of mean output: truncated %.3f, dithered %.4f LSB", maxErrPlain, maxErrDither);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_THAN(0.01, maxErrDither);
+}
+
+// output never differs from truncated value by more than one step (no visible flicker)
+void test_output_within_one_step(void) {
+  for (unsigned bri = 0; bri < 256; bri += 5) {
+    for (unsigned v = 0; v < 256; v += 3) {
+      const uint8_t data[4] = {uint8_t(v), uint8_t(255 - v), uint8_t(v / 2), uint8_t(v / 3)};
+      uint8_t err[4] = {0, 0, 0, 0};
+      uint8_t plain[4];
+      encodePlain<4>(data, 1, bri);
+      for (int ch = 0; ch < 4; ch++) plain[ch] = out[ch];
+      for (int f = 0; f < 64; f++) {
+        encodeDither<4>(data, err, 1, bri);
+        for (int ch = 0; ch < 4; ch++) TEST_ASSERT_TRUE(out[ch] == plain[ch] || out[ch] == plain[ch] + 1);
+      }
+    }
+  }
+}
+
+// brightness 0 must not leave residual light, full brightness is not changed by dithering
+void test_off_and_full_brightness(void) {
+  const uint8_t data[3] = {255, 128, 1};
+  uint8_t err[3] = {0, 0, 0};
+  for (int f = 0; f < 100; f++) {
+    encodeDither<3>(data, err, 1, 0);
+    TEST_ASSERT_EQUAL(0, out[0] | out[1] | out[2]);
+  }
+  for (int f = 0; f < 100; f++) {
+    encodeDither<3>(data, err, 1, 255);
+    TEST_ASSERT_EQUAL(255, out[0]);
+    TEST_ASSERT_EQUAL(128, out[1]);
+    TEST_ASSERT_EQUAL(1, out[2]);
+  }
+}
+
+void test_benchmark(void) {
+  const unsigned len = 1500, frames = 2000;
+  std::vector<uint8_t> data(len * 4), err(len * 4), bus(len * 4);
+  for (unsigned i = 0; i < data.size(); i++) data[i] = i * 37;
+  double t[2];
+  for (int d = 0; d < 2; d++) {
+    const clock_t start = clock();
+    for (unsigned f = 0; f < frames; f++) {
+      if (d) encodeDither<4>(data.data(), err.data(), len, 20, bus.data());
+      else   encodePlain<4>(data.data(), len, 20, bus.data());
+    }
+    t[d] = 1e9 * double(clock() - start) / CLOCKS_PER_SEC / frames / len;
+  }
+  char msg[80];
+  snprintf(msg, sizeof(msg), "RGBW encoding: truncated %.2f ns/LED, dithered %.2f ns/LED", t[0], t[1]);
+  TEST_MESSAGE(msg);
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_mean_output_is_exact);
+  RUN_TEST(test_output_within_one_step);
+  RUN_TEST(test_off_and_full_brightness);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
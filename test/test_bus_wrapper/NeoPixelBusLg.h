@@ -0,0 +1,190 @@
+#pragma once
+/*
+ * NeoPixelBus stand-in for compiling bus_wrapper.h on the host (ESP8266 and SPI bus types)
+ *
+ * Pixels are written the way NeoPixelBusLg does it: luminance is applied with Dim() (NeoGammaNullMethod), then the
+ * feature stores the channels in wire order into the pixel buffer. Methods (drivers) do nothing.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+typedef uint8_t byte; // from Arduino.h
+using std::max;
+
+static inline uint8_t npbDim8(uint8_t v, uint8_t ratio) { return (uint16_t(v) * (uint16_t(ratio) + 1)) >> 8; }
+static inline uint16_t npbDim16(uint16_t v, uint8_t ratio) { return (uint32_t(v) * (uint32_t(ratio) + 1)) >> 8; }
+
+struct RgbColor;
+
+struct RgbwColor {
+  static const unsigned Count = 4;
+  uint8_t R, G, B, W;
+  RgbwColor(uint8_t r, uint8_t g, uint8_t b, uint8_t w) : R(r), G(g), B(b), W(w) {}
+  RgbwColor(uint8_t brightness = 0) : R(0), G(0), B(0), W(brightness) {}
+  RgbwColor(const RgbColor &c);
+  uint8_t  operator[](size_t i) const { return i == 0 ? R : i == 1 ? G : i == 2 ? B : W; }
+  uint8_t& operator[](size_t i)       { return i == 0 ? R : i == 1 ? G : i == 2 ? B : W; }
+  RgbwColor Dim(uint8_t ratio) const { return RgbwColor(npbDim8(R, ratio), npbDim8(G, ratio), npbDim8(B, ratio), npbDim8(W, ratio)); }
+};
+
+struct RgbColor {
+  static const unsigned Count = 3;
+  uint8_t R, G, B;
+  RgbColor(uint8_t r, uint8_t g, uint8_t b) : R(r), G(g), B(b) {}
+  RgbColor(uint8_t brightness = 0) : R(brightness), G(brightness), B(brightness) {}
+  RgbColor(const RgbwColor &c) : R(c.R), G(c.G), B(c.B) {}
+  uint8_t  operator[](size_t i) const { return i == 0 ? R : i == 1 ? G : B; }
+  uint8_t& operator[](size_t i)       { return i == 0 ? R : i == 1 ? G : B; }
+  RgbColor Dim(uint8_t ratio) const { return RgbColor(npbDim8(R, ratio), npbDim8(G, ratio), npbDim8(B, ratio)); }
+};
+
+inline RgbwColor::RgbwColor(const RgbColor &c) : R(c.R), G(c.G), B(c.B), W(0) {}
+
+struct RgbwwColor {
+  static const unsigned Count = 5;
+  uint8_t R, G, B, WW, CW;
+  RgbwwColor(uint8_t r, uint8_t g, uint8_t b, uint8_t ww, uint8_t cw) : R(r), G(g), B(b), WW(ww), CW(cw) {}
+  RgbwwColor(uint8_t brightness = 0) : R(0), G(0), B(0), WW(brightness), CW(brightness) {}
+  uint8_t  operator[](size_t i) const { return i == 0 ? R : i == 1 ? G : i == 2 ? B : i == 3 ? WW : CW; }
+  uint8_t& operator[](size_t i)       { return i == 0 ? R : i == 1 ? G : i == 2 ? B : i == 3 ? WW : CW; }
+  RgbwwColor Dim(uint8_t ratio) const { return RgbwwColor(npbDim8(R, ratio), npbDim8(G, ratio), npbDim8(B, ratio), npbDim8(WW, ratio), npbDim8(CW, ratio)); }
+};
+
+struct Rgb48Color {
+  static const unsigned Count = 3;
+  uint16_t R, G, B;
+  Rgb48Color(uint16_t r, uint16_t g, uint16_t b) : R(r), G(g), B(b) {}
+  Rgb48Color(uint16_t brightness = 0) : R(brightness), G(brightness), B(brightness) {}
+  Rgb48Color(const RgbColor &c) : R(c.R * 257), G(c.G * 257), B(c.B * 257) {}
+  uint16_t  operator[](size_t i) const { return i == 0 ? R : i == 1 ? G : B; }
+  uint16_t& operator[](size_t i)       { return i == 0 ? R : i == 1 ? G : B; }
+  Rgb48Color Dim(uint8_t ratio) const { return Rgb48Color(npbDim16(R, ratio), npbDim16(G, ratio), npbDim16(B, ratio)); }
+};
+
+struct Rgbw64Color {
+  static const unsigned Count = 4;
+  uint16_t R, G, B, W;
+  Rgbw64Color(uint16_t r, uint16_t g, uint16_t b, uint16_t w) : R(r), G(g), B(b), W(w) {}
+  Rgbw64Color(uint16_t brightness = 0) : R(0), G(0), B(0), W(brightness) {}
+  Rgbw64Color(const RgbwColor &c) : R(c.R * 257), G(c.G * 257), B(c.B * 257), W(c.W * 257) {}
+  uint16_t  operator[](size_t i) const { return i == 0 ? R : i == 1 ? G : i == 2 ? B : W; }
+  uint16_t& operator[](size_t i)       { return i == 0 ? R : i == 1 ? G : i == 2 ? B : W; }
+  Rgbw64Color Dim(uint8_t ratio) const { return Rgbw64Color(npbDim16(R, ratio), npbDim16(G, ratio), npbDim16(B, ratio), npbDim16(W, ratio)); }
+};
+
+struct Rgbww80Color {
+  static const unsigned Count = 5;
+  uint16_t R, G, B, WW, CW;
+  Rgbww80Color(uint16_t r, uint16_t g, uint16_t b, uint16_t ww, uint16_t cw) : R(r), G(g), B(b), WW(ww), CW(cw) {}
+  Rgbww80Color(uint16_t brightness = 0) : R(0), G(0), B(0), WW(brightness), CW(brightness) {}
+  uint16_t  operator[](size_t i) const { return i == 0 ? R : i == 1 ? G : i == 2 ? B : i == 3 ? WW : CW; }
+  uint16_t& operator[](size_t i)       { return i == 0 ? R : i == 1 ? G : i == 2 ? B : i == 3 ? WW : CW; }
+  Rgbww80Color Dim(uint8_t ratio) const { return Rgbww80Color(npbDim16(R, ratio), npbDim16(G, ratio), npbDim16(B, ratio), npbDim16(WW, ratio), npbDim16(CW, ratio)); }
+};
+
+// channels of C in wire order (indices into C), 8 or 16 bit per channel
+template<class C, unsigned... order>
+struct MockFeature {
+  typedef C ColorObject;
+  static const size_t ElementSize = sizeof(C) / C::Count;
+  static const size_t PixelSize = ElementSize * sizeof...(order);
+  static void applyPixelColor(uint8_t *pixels, uint16_t i, const C &c) {
+    uint8_t *p = pixels + i * PixelSize;
+    for (unsigned ch : {order...}) {
+      if (ElementSize > 1) *p++ = c[ch] >> 8;
+      *p++ = c[ch];
+    }
+  }
+  static C retrievePixelColor(const uint8_t *pixels, uint16_t i) {
+    C c;
+    const uint8_t *p = pixels + i * PixelSize;
+    for (unsigned ch : {order...}) {
+      unsigned v = *p++;
+      if (ElementSize > 1) v = v << 8 | *p++;
+      c[ch] = v;
+    }
+    return c;
+  }
+};
+
+typedef MockFeature<RgbColor, 1, 0, 2>        NeoGrbFeature;
+typedef MockFeature<RgbColor, 2, 0, 1>        NeoBrgFeature;
+typedef MockFeature<RgbColor, 0, 2, 1>        NeoRbgFeature;
+typedef MockFeature<RgbColor, 0, 1, 2>        NeoRgbTm1914Feature;
+typedef MockFeature<RgbColor, 1, 0, 2>        NeoGrbTm1914Feature;
+typedef MockFeature<RgbColor, 2, 1, 0>        DotStarBgrFeature;
+typedef MockFeature<RgbColor, 1, 0, 2>        Lpd8806GrbFeature;
+typedef MockFeature<RgbColor, 1, 0, 2>        Lpd6803GrbFeature;
+typedef MockFeature<RgbColor, 2, 1, 0>        P9813BgrFeature;
+typedef MockFeature<RgbwColor, 1, 0, 2, 3>    NeoGrbwFeature;
+typedef MockFeature<RgbwColor, 3, 0, 1, 2>    NeoWrgbTm1814Feature;
+typedef MockFeature<Rgb48Color, 0, 1, 2>      NeoRgbUcs8903Feature;
+typedef MockFeature<Rgbw64Color, 0, 1, 2, 3>  NeoRgbwUcs8904Feature;
+typedef MockFeature<RgbwwColor, 1, 0, 2, 4, 3>   NeoGrbcwxFeature;
+typedef MockFeature<RgbwwColor, 1, 0, 2, 3, 4>   NeoGrbwwFeature;
+typedef MockFeature<Rgbww80Color, 0, 1, 2, 4, 3> NeoRgbcwSm16825eFeature;
+typedef MockFeature<Rgbww80Color, 0, 1, 2, 3, 4> NeoRgbwcSm16825eFeature;
+
+struct NeoGammaNullMethod {};
+struct NeoSpiSettings { explicit NeoSpiSettings(uint32_t) {} };
+struct NeoTm1814Settings { NeoTm1814Settings(uint16_t, uint16_t, uint16_t, uint16_t) {} };
+enum NeoTm1914_Mode { NeoTm1914_Mode_DinFdinAutoSwitch, NeoTm1914_Mode_DinOnly, NeoTm1914_Mode_FdinOnly };
+struct NeoTm1914Settings { NeoTm1914Settings(NeoTm1914_Mode = NeoTm1914_Mode_DinOnly) {} };
+
+#define MOCK_METHOD(name) struct name {};
+MOCK_METHOD(NeoEsp8266Uart0Ws2813Method)   MOCK_METHOD(NeoEsp8266Uart1Ws2813Method)
+MOCK_METHOD(NeoEsp8266Dma800KbpsMethod)    MOCK_METHOD(NeoEsp8266BitBang800KbpsMethod)
+MOCK_METHOD(NeoEsp8266BitBangWs2813Method)
+MOCK_METHOD(NeoEsp8266Uart0400KbpsMethod)  MOCK_METHOD(NeoEsp8266Uart1400KbpsMethod)
+MOCK_METHOD(NeoEsp8266Dma400KbpsMethod)    MOCK_METHOD(NeoEsp8266BitBang400KbpsMethod)
+MOCK_METHOD(NeoEsp8266Uart0Tm1814Method)   MOCK_METHOD(NeoEsp8266Uart1Tm1814Method)
+MOCK_METHOD(NeoEsp8266DmaTm1814Method)     MOCK_METHOD(NeoEsp8266BitBangTm1814Method)
+MOCK_METHOD(NeoEsp8266Uart0Tm1829Method)   MOCK_METHOD(NeoEsp8266Uart1Tm1829Method)
+MOCK_METHOD(NeoEsp8266DmaTm1829Method)     MOCK_METHOD(NeoEsp8266BitBangTm1829Method)
+MOCK_METHOD(NeoEsp8266Uart0Apa106Method)   MOCK_METHOD(NeoEsp8266Uart1Apa106Method)
+MOCK_METHOD(NeoEsp8266DmaApa106Method)     MOCK_METHOD(NeoEsp8266BitBangApa106Method)
+MOCK_METHOD(NeoEsp8266Uart0Ws2805Method)   MOCK_METHOD(NeoEsp8266Uart1Ws2805Method)
+MOCK_METHOD(NeoEsp8266DmaWs2805Method)     MOCK_METHOD(NeoEsp8266BitBangWs2805Method)
+MOCK_METHOD(NeoEsp8266Uart0Tm1914Method)   MOCK_METHOD(NeoEsp8266Uart1Tm1914Method)
+MOCK_METHOD(NeoEsp8266DmaTm1914Method)     MOCK_METHOD(NeoEsp8266BitBangTm1914Method)
+MOCK_METHOD(DotStarSpiHzMethod)            MOCK_METHOD(DotStarMethod)
+MOCK_METHOD(Lpd8806SpiHzMethod)            MOCK_METHOD(Lpd8806Method)
+MOCK_METHOD(Lpd6803SpiHzMethod)            MOCK_METHOD(Lpd6803Method)
+MOCK_METHOD(Ws2801SpiHzMethod)             MOCK_METHOD(Ws2801Method)
+MOCK_METHOD(P9813SpiHzMethod)              MOCK_METHOD(P9813Method)
+#undef MOCK_METHOD
+
+template<class F, class M, class G>
+class NeoPixelBusLg {
+  public:
+    typedef typename F::ColorObject ColorObject;
+    template<class... A> NeoPixelBusLg(uint16_t count, A...) : _count(count), _pixels((uint8_t*)calloc(count, F::PixelSize)) {}
+    ~NeoPixelBusLg() { free(_pixels); }
+    void Begin() {}
+    void Begin(int8_t, int8_t, int8_t, int8_t) {}
+    void Show(bool = true) { _dirty = false; }
+    bool CanShow() const { return true; }
+    bool IsDirty() const { return _dirty; }
+    void SetLuminance(uint8_t l) { _luminance = l; }
+    uint8_t GetLuminance() const { return _luminance; }
+    template<class S> void SetPixelSettings(const S&) {}
+    template<class S> void SetMethodSettings(const S&) {}
+    void SetPixelColor(uint16_t i, ColorObject c) {
+      if (i >= _count) return;
+      F::applyPixelColor(_pixels, i, c.Dim(_luminance));
+      _dirty = true;
+    }
+    ColorObject GetPixelColor(uint16_t i) const { return i < _count ? F::retrievePixelColor(_pixels, i) : ColorObject(); }
+    const uint8_t* Pixels() const { return _pixels; }
+    size_t PixelsSize() const { return _count * F::PixelSize; }
+    uint16_t PixelCount() const { return _count; }
+
+  private:
+    uint16_t _count;
+    uint8_t *_pixels;
+    uint8_t  _luminance = 255;
+    bool     _dirty = false;
+};
@@ -0,0 +1,126 @@
+/*
+ * Per-type pixel writers (PolyBus::getPixelWriter() in bus_wrapper.h) against PolyBus::setPixelColor()
+ *
+ * bus_wrapper.h is compiled for ESP8266 bus types against a NeoPixelBus stand-in (NeoPixelBusLg.h in this folder).
+ * Every writer must leave the same bytes in the pixel buffer as setPixelColor(), for all color orders and W swaps.
+ * The benchmark writes frames the way BusDigital does: through the writer selected at construction for WS2812 RGB
+ * and SK6812 RGBW, through setPixelColor() (as before) for each, and for WS2811 WWA which keeps the generic path.
+ *   pio test -e native -f test_bus_wrapper
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <random>
+#define ESP8266 // ESP8266 bus types (no RMT/I2S drivers needed)
+#include "NeoPixelBusLg.h"
+#include "const.h"
+
+typedef void (*PixelWriter)(void* busPtr, uint16_t pix, uint32_t c, uint8_t co, uint16_t wwcw); // as in bus_manager.h
+struct Bus { // only used by PolyBus::getI()
+  static bool isDigital(uint8_t type);
+  static bool is2Pin(uint8_t type);
+};
+#include "bus_wrapper.h"
+
+bool PolyBus::_useParallelI2S = false;
+
+static std::mt19937 rng;
+static volatile uint8_t busTypeAtRuntime; // keeps the compiler from resolving setPixelColor()'s switch at compile time
+
+void setUp(void) { rng.seed(1); }
+void tearDown(void) {}
+
+static const uint8_t colorOrders[] = {0, 1, 2, 3, 4, 5, 0x10, 0x21, 0x32, 0x14};
+
+// same buffer contents as setPixelColor() for every bus type that has a writer
+void test_writers_match_setPixelColor(void) {
+  const uint16_t len = 64;
+  uint8_t pins[2] = {3, 0};
+  unsigned writers = 0;
+  for (unsigned t = 1; t < 128; t++) {
+    PixelWriter writer = PolyBus::getPixelWriter(t);
+    if (!writer) continue;
+    void *a = PolyBus::create(t, pins, len, 0);
+    void *b = PolyBus::create(t, pins, len, 0);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    for (unsigned f = 0; f < 50; f++) {
+      const uint8_t lum = f ? rng() : 255;
+      PolyBus::setBrightness(a, t, lum);
+      PolyBus::setBrightness(b, t, lum);
+      for (uint16_t i = 0; i < len; i++) {
+        const uint32_t c = rng();
+        const uint8_t co = colorOrders[rng() % sizeof(colorOrders)];
+        writer(a, i, c, co, 0);
+        PolyBus::setPixelColor(b, t, i, c, co, 0);
+      }
+      const unsigned size = PolyBus::getDataSize(a, t);
+      TEST_ASSERT_EQUAL(PolyBus::getDataSize(b, t), size);
+      char msg[32];
+      snprintf(msg, sizeof(msg), "bus type %u", t);
+      for (uint16_t i = 0; i < len; i++) {
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(PolyBus::getPixelColor(b, t, i, 0), PolyBus::getPixelColor(a, t, i, 0), msg);
+      }
+    }
+    PolyBus::cleanup(a, t);
+    PolyBus::cleanup(b, t);
+    writers++;
+  }
+  char msg[48];
+  snprintf(msg, sizeof(msg), "%u bus types with pixel writer", writers);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(writers >= 20);
+  TEST_ASSERT_NULL(PolyBus::getPixelWriter(I_8266_DM_UCS_3)); // 16 bit and 5 channel types keep the generic path
+  TEST_ASSERT_NULL(PolyBus::getPixelWriter(I_8266_DM_2805_5));
+}
+
+// ns per pixel for a 1000 pixel frame written through writer (or setPixelColor() if writer is nullptr)
+static double frameTime(uint8_t busType, PixelWriter writer, bool cct) {
+  const uint16_t len = 1000;
+  const unsigned frames = 3000;
+  uint8_t pins[2] = {3, 0};
+  void *bus = PolyBus::create(busType, pins, len, 0);
+  std::vector<uint32_t> colors(len);
+  for (auto &c : colors) c = rng();
+  busTypeAtRuntime = busType;
+  const clock_t start = clock();
+  for (unsigned f = 0; f < frames; f++) {
+    const uint8_t t = busTypeAtRuntime;
+    const uint8_t co = f & 1;
+    for (uint16_t i = 0; i < len; i++) {
+      const uint32_t c = colors[i] + f;
+      if (writer) writer(bus, i, c, co, 0);
+      else        PolyBus::setPixelColor(bus, t, i, c, co, cct ? (c >> 16 & 0xFF00) | (c >> 24) : 0);
+    }
+  }
+  const double ns = 1e9 * double(clock() - start) / CLOCKS_PER_SEC / frames / len;
+  PolyBus::cleanup(bus, busType);
+  return ns;
+}
+
+void test_benchmark(void) {
+  const struct { const char *name; uint8_t type; bool cct; } buses[] = {
+    {"WS2812 RGB",  I_8266_DM_NEO_3, false},
+    {"SK6812 RGBW", I_8266_DM_NEO_4, false},
+    {"WS2811 WWA",  I_8266_DM_NEO_3, true},  // CCT bus, BusDigital does not use a writer
+  };
+  for (const auto &b : buses) {
+    const double generic = frameTime(b.type, nullptr, b.cct);
+    char msg[112];
+    if (b.cct) {
+      snprintf(msg, sizeof(msg), "%-12s setPixelColor() %.2f ns/pixel (generic path, unchanged)", b.name, generic);
+    } else {
+      const double writer = frameTime(b.type, PolyBus::getPixelWriter(b.type), false);
+      snprintf(msg, sizeof(msg), "%-12s setPixelColor() %.2f ns/pixel, writer %.2f ns/pixel (x%.2f)", b.name, generic, writer, generic / writer);
+    }
+    TEST_MESSAGE(msg);
+  }
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_writers_match_setPixelColor);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
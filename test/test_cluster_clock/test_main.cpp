@@ -0,0 +1,249 @@
+/*
+ * Cluster clock (cluster_clock.h): master election, clock agreement and playlist entry timing across nodes
+ *
+ * Nodes are simulated with different boot times, clock drift (+-50 ppm), loop latency (1-20 ms) and a network with
+ * 1 ms + exponential latency (mean 3 ms, 5% spikes of 50 ms) and 5% packet loss. The master is switched off halfway.
+ * Playlists are timed like handlePlaylist(): in local ms, shifted by cluster clock corrections (clusterClockShift()),
+ * started at the time given with "at" (getTimedStateDelay()). Like WLED::loop() a node wakes up early for a timed state
+ * or playlist entry that is due (getTimeToNextTimedState(), getTimeToNextPlaylistEntry()).
+ * Nodes must agree within one frame at 60 fps.
+ *   pio test -e native -f test_cluster_clock
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include <random>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include "cluster_clock.h"
+
+static const double SIM_TIME  = 300;            // s
+static const double KILL_AT   = 150;            // master is switched off
+static const double START_AT  = 30;             // playlist start is sent with "at" (1 s ahead of master's cluster time)
+static const unsigned ENTRY_DUR = 20;           // playlist entry duration (tenths of seconds)
+static const double FRAME_MS    = 1000.0 / 60;  // one frame at 60 fps (default WLED_FPS is 42)
+
+struct Packet {
+  double at;
+  int to, from;
+  std::vector<uint8_t> data;
+  bool operator<(const Packet &o) const { return at > o.at; }
+};
+
+// playlist entry timing as in handlePlaylist()
+struct Playlist {
+  bool running = false;
+  uint16_t entryDur = 0;
+  uint32_t cycled = 0;                          // presetCycledTime
+  uint32_t start = 0;                           // playlistStartTime
+  int64_t lastOffset = 0;                       // clusterClockShift() state
+  std::vector<double> changes;                  // real time of each entry change
+
+  int32_t shift(const ClusterClock &cc) {
+    int64_t offset = cc.offset();
+    offset = offset >= 0 ? offset / 1000 : -((999 - offset) / 1000);
+    int32_t s = offset - lastOffset;
+    lastOffset = offset;
+    return s;
+  }
+  void load(uint32_t now, uint32_t late) {
+    running = true;
+    start = now - late;
+  }
+  uint32_t timeToNext(uint32_t now) const {      // getTimeToNextPlaylistEntry()
+    if (!running) return UINT32_MAX;
+    long left = 100L * entryDur - (long)(now - cycled);
+    return left < 0 ? 0 : left + 1;
+  }
+  void handle(const ClusterClock &cc, uint32_t now, double t) {
+    int32_t s = shift(cc);
+    if (!running) return;
+    if (s && (unsigned)abs(s) < 100U * entryDur) cycled -= s;
+    long elapsed = (long)(now - cycled);
+    if (entryDur < UINT16_MAX && (entryDur == 0 || elapsed > 100L * entryDur)) {
+      if (entryDur > 0 && elapsed < 200L * entryDur) cycled += 100 * entryDur;
+      else if (changes.empty() && (long)(now - start) < 1000) cycled = start;
+      else cycled = now;
+      entryDur = ENTRY_DUR;
+      changes.push_back(t);
+    }
+  }
+};
+
+struct Node {
+  uint32_t id;
+  double boot, drift, phase, nextLoop;
+  bool up = true, started = false;
+  ClusterClock cc;
+  Playlist pl;
+  std::vector<Packet> inbox;
+  uint64_t local(double t) const { return (uint64_t)((t - boot) * (1 + drift) * 1e6 + phase); }
+};
+
+struct Sim {
+  std::mt19937_64 rng;
+  std::vector<Node> nodes;
+  std::priority_queue<Packet> net;
+  double maxErr = 0, sumErr = 0, maxErrFailover = 0;
+  uint64_t startAt = UINT64_MAX;                // cluster time (us) of {"at":...} playlist start
+  unsigned samples = 0;
+
+  double urand(double a, double b) { return std::uniform_real_distribution<double>(a, b)(rng); }
+
+  void send(int from, int to, const uint8_t *buf, size_t len, double t) {
+    for (int j = 0; j < (int)nodes.size(); j++) {
+      if (j == from || (to >= 0 && j != to) || urand(0, 1) < 0.05) continue;
+      double lat = 0.001 + std::exponential_distribution<double>(1 / 0.003)(rng) + (urand(0, 1) < 0.05 ? 0.05 : 0);
+      net.push({t + lat, j, from, std::vector<uint8_t>(buf, buf + len)});
+    }
+  }
+
+  void run(unsigned n, uint64_t seed) {
+    rng.seed(seed);
+    nodes.resize(n);
+    for (unsigned i = 0; i < n; i++) {
+      Node &x = nodes[i];
+      x.id = 100 + (i * 37) % n;
+      x.boot = urand(0, 10);
+      x.drift = urand(-50e-6, 50e-6);
+      x.phase = urand(0, 1e9);
+      x.nextLoop = x.boot;
+    }
+    bool killed = false;
+    for (double t = 0; t < SIM_TIME; t += 0.0005) {
+      while (!net.empty() && net.top().at <= t) { nodes[net.top().to].inbox.push_back(net.top()); net.pop(); }
+      if (startAt == UINT64_MAX && t >= START_AT) {
+        for (auto &x : nodes) if (x.cc.isMaster()) startAt = x.cc.time(x.local(t)) + 1000000;
+      }
+      if (!killed && t >= KILL_AT) {
+        for (auto &x : nodes) if (x.cc.isMaster()) x.up = false;
+        killed = true;
+      }
+      for (int i = 0; i < (int)n; i++) {
+        Node &x = nodes[i];
+        if (!x.up || t < x.nextLoop) continue;
+        if (x.nextLoop == x.boot) x.cc.begin(x.id, x.local(t));
+        const uint64_t now = x.local(t);
+        uint8_t out[CLUSTER_PACKET_SIZE], resp[CLUSTER_PACKET_SIZE];
+        for (auto &p : x.inbox) {
+          size_t len = x.cc.receive(p.data.data(), p.data.size(), nodes[p.from].id, now, resp);
+          if (len) send(i, p.from, resp, len, t);
+        }
+        x.inbox.clear();
+        x.cc.update(now);
+        if (x.cc.announceDue(now)) send(i, -1, out, x.cc.buildAnnounce(out, now, 0), t);
+        if (x.cc.requestDue(now)) {
+          for (int j = 0; j < (int)n; j++) if (nodes[j].id == x.cc.master()) send(i, j, out, x.cc.buildRequest(out, now), t);
+        }
+        // {"at":startAt,"playlist":...} sent to all nodes, applied by applyTimedStates()
+        if (!x.started && x.cc.time(now) >= startAt) {
+          x.started = true;
+          x.pl.load(now / 1000, (uint32_t)(x.cc.time(now) / 1000 - startAt / 1000));
+        }
+        x.pl.handle(x.cc, now / 1000, t);
+        // next loop after 1-20 ms, earlier if a timed state or playlist entry is due
+        uint32_t due = x.pl.timeToNext(now / 1000);
+        if (!x.started && startAt != UINT64_MAX) due = std::min(due, (uint32_t)((startAt - std::min(startAt, x.cc.time(now))) / 1000));
+        x.nextLoop = t + std::min(urand(0.001, 0.020), due / 1000.0);
+      }
+      if (fmod(t, 0.01) < 0.0005 && t > 20) measure(t);
+    }
+  }
+
+  // max pairwise cluster time difference of locked nodes
+  void measure(double t) {
+    double lo = 1e300, hi = -1e300;
+    unsigned locked = 0, up = 0;
+    for (auto &x : nodes) {
+      if (!x.up) continue;
+      up++;
+      if (!x.cc.isLocked()) continue;
+      locked++;
+      double c = (double)x.cc.time(x.local(t));
+      lo = std::min(lo, c);
+      hi = std::max(hi, c);
+    }
+    if (locked != up) return;
+    double e = (hi - lo) / 1000;
+    if (t < KILL_AT || t > KILL_AT + 20) { maxErr = std::max(maxErr, e); sumErr += e; samples++; }
+    else maxErrFailover = std::max(maxErrFailover, e);
+  }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_packets(void) {
+  ClusterClock a, b;
+  a.begin(1, 0);
+  b.begin(2, 0);
+  uint8_t out[CLUSTER_PACKET_SIZE], resp[CLUSTER_PACKET_SIZE];
+  size_t len = a.buildRequest(out, 1000);
+  TEST_ASSERT_EQUAL(0, b.receive(out, len, 1, 1000, resp));    // not master, no response
+  len = a.buildAnnounce(out, 1000, 0);
+  out[1] = CLUSTER_VERSION + 1;
+  TEST_ASSERT_EQUAL(0, b.receive(out, len, 1, 1000, resp));    // unknown version is ignored
+  out[1] = CLUSTER_VERSION;
+  b.receive(out, len, 1, 1000, resp);
+  TEST_ASSERT_EQUAL(1, b.numNodes(1000));
+  TEST_ASSERT_EQUAL(0, a.receive(out, len, 1, 1000, resp));    // own packet
+  b.update(CLUSTER_TIMEOUT_US);
+  TEST_ASSERT_FALSE(b.isMaster());                              // node 1 has lower id
+  a.update(CLUSTER_TIMEOUT_US);
+  TEST_ASSERT_TRUE(a.isMaster());
+}
+
+void test_agreement_and_failover(void) {
+  Sim sim;
+  sim.run(6, 5);
+  unsigned masters = 0, locked = 0;
+  for (auto &x : sim.nodes) if (x.up) { masters += x.cc.isMaster(); locked += x.cc.isLocked(); }
+  char msg[160];
+  snprintf(msg, sizeof(msg), "cluster time between nodes: max %.2f ms, mean %.2f ms, max during failover %.2f ms",
+           sim.maxErr, sim.sumErr / sim.samples, sim.maxErrFailover);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL(1, masters);
+  TEST_ASSERT_EQUAL(5, locked);
+  TEST_ASSERT_TRUE(sim.maxErr < FRAME_MS);
+}
+
+// playlist started with "at" changes entries together on all nodes, also across master failover
+void test_playlist_alignment(void) {
+  Sim sim;
+  sim.run(6, 7);
+  const unsigned expected = (unsigned)((SIM_TIME - START_AT - 1) * 10 / ENTRY_DUR) + 1;
+  size_t minChanges = SIZE_MAX, maxChanges = 0;
+  for (auto &x : sim.nodes) {
+    if (!x.up) continue;
+    minChanges = std::min(minChanges, x.pl.changes.size());
+    maxChanges = std::max(maxChanges, x.pl.changes.size());
+  }
+  double spread = 0;
+  for (size_t k = 0; k < minChanges; k++) {
+    double lo = 1e300, hi = -1e300;
+    for (auto &x : sim.nodes) if (x.up) { lo = std::min(lo, x.pl.changes[k]); hi = std::max(hi, x.pl.changes[k]); }
+    spread = std::max(spread, hi - lo);
+  }
+  double dev = 0;                               // deviation from the schedule in real time
+  for (auto &x : sim.nodes) {
+    if (!x.up) continue;
+    for (size_t k = 0; k < x.pl.changes.size(); k++) dev = std::max(dev, fabs(x.pl.changes[k] - (x.pl.changes[0] + k * ENTRY_DUR / 10.0)));
+  }
+  char msg[160];
+  snprintf(msg, sizeof(msg), "playlist entries: %u-%u changes (expected %u), max spread between nodes %.1f ms, max drift from schedule %.1f ms",
+           (unsigned)minChanges, (unsigned)maxChanges, expected, spread * 1000, dev * 1000);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(minChanges + 1 >= expected && maxChanges <= expected + 1); // no skipped or repeated entries
+  TEST_ASSERT_TRUE(maxChanges - minChanges <= 1);
+  TEST_ASSERT_TRUE(spread * 1000 < FRAME_MS);   // clock error and ms resolution, not loop latency
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_packets);
+  RUN_TEST(test_agreement_and_failover);
+  RUN_TEST(test_playlist_alignment);
+  return UNITY_END();
+}
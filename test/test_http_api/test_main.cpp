@@ -0,0 +1,209 @@
+/*
+ * HTTP API (http_api.cpp, http_api.h) against the String based handleSet() it replaced (legacy_set.h)
+ *
+ * Both run against the same mocked state (wled_mock.h) for random requests: every global, every segment field and
+ * the sequence of calls (setColor(), stateUpdated(), presets, XML response, ...) must be the same, for handleSet()
+ * with and without a request and for handleHttpApi(). Also measures requests per second of both parsers.
+ *   pio test -e native -f test_http_api
+ */
+#include <unity.h>
+#include <time.h>
+#include <random>
+#include "wled_mock.h"
+
+bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=true);
+bool handleHttpApi(const char *params, bool apply=true);
+#include "http_api.cpp"
+#include "legacy_set.h"
+
+static std::mt19937 rng;
+
+void setUp(void) { rng.seed(1); }
+void tearDown(void) {}
+
+static std::string keyName(unsigned k) {
+  std::string s = httpApiKeys[k];
+  if (s.back() == '=') s.pop_back();
+  return s;
+}
+
+static bool isFlag(unsigned k) { return httpApiKeys[k][strlen(httpApiKeys[k]) - 1] != '='; }
+
+static std::string value(unsigned k) {
+  static const char *text[] = {"H2F00FF", "xSRy", "NDNN", "SC", "RBIN", "K2"}; // flag names inside values
+  char b[32];
+  switch (rng() % 12) {
+    case 0: return "";
+    case 1: snprintf(b, sizeof(b), "-%u", (unsigned)rng() % 300); return b;
+    case 2: return rng() % 2 ? "~" : "~-";
+    case 3: snprintf(b, sizeof(b), "~%d", (int)(rng() % 40) - 20); return b;
+    case 4: return "r";
+    case 5: snprintf(b, sizeof(b), "w~%d", (int)(rng() % 3) - 1); return b;
+    case 6: snprintf(b, sizeof(b), "%c%X", "h#H"[rng() % 3], (unsigned)rng()); return b;
+    case 7: snprintf(b, sizeof(b), "%u~%u~", 1 + (unsigned)rng() % 5, 5 + (unsigned)rng() % 5); return b;
+    case 8: snprintf(b, sizeof(b), "%u", (unsigned)rng()); return b;
+    case 9: return text[rng() % 6];
+    default: snprintf(b, sizeof(b), "%u", (unsigned)rng() % (k == API_SS || k == API_SM ? 5 : 300)); return b;
+  }
+}
+
+// random keys (with duplicates, bare flags and unknown keys) in random order
+static std::string request() {
+  static const char *unknown[] = {"QQ=1", "ZZ", "v=3", "XYZ=7", "NDX=1"};
+  std::string r;
+  const unsigned n = rng() % 12;
+  for (unsigned i = 0; i < n; i++) {
+    if (!r.empty()) r += '&';
+    if (rng() % 20 == 0) { r += unknown[rng() % 5]; continue; }
+    const unsigned k = rng() % API_KEY_COUNT;
+    r += keyName(k);
+    if (!isFlag(k) || rng() % 2) r += "=" + value(k);
+  }
+  return r;
+}
+
+// random segments and globals, same for the same seed
+static void reset(uint32_t seed) {
+  std::mt19937 s(seed);
+  rnd = seed;
+  trace.clear();
+  strip.numSegs = 1 + s() % 4;
+  strip.mainSeg = 0;
+  for (auto &g : strip.seg) {
+    g = Segment();
+    g.colors[0] = s(); g.colors[1] = s(); g.colors[2] = s();
+    g.mode = s() % 100; g.speed = s(); g.intensity = s(); g.palette = s() % 50;
+    g.custom1 = s(); g.custom2 = s(); g.custom3 = s() % 32; g.check1 = s() % 2;
+    g.selected = s() % 2; g.active = s() % 4; g.on = s() % 2; g.reverse = s() % 2;
+    g.start = 0; g.stop = 30; g.startY = 0; g.stopY = 1; g.grouping = 1; g.spacing = 0;
+  }
+  realtimeMode = s() % 2; presetCycMin = 1; presetCycMax = 5; presetCycCurr = 3; bri = s() % 3 ? s() : 0; briLast = 128;
+  nightlightDelayMins = 60; nightlightDelayMinsDefault = 30; nightlightTargetBri = 0; nightlightMode = 1;
+  realtimeOverride = 0; receiveGroups = 1; overlayCurrent = 0;
+  doAdvancePlaylist = nightlightActive = nightlightActiveOld = false; countdownOverTriggered = true;
+  useMainSegmentOnly = s() % 2; doReboot = countdownMode = false; notifyDirect = receiveDirect = true; stateChanged = false;
+  transitionDelay = 700; userVar0 = userVar1 = 0; nightlightStartTime = 0; countdownTime = 0;
+}
+
+// calls made plus everything the parser can change
+static std::string state(bool ret) {
+  char b[256];
+  snprintf(b, sizeof(b), "=%d|%d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %u %lu %lu %u",
+    ret, realtimeMode, presetCycMin, presetCycMax, presetCycCurr, bri, briLast, nightlightDelayMins, nightlightTargetBri,
+    nightlightMode, realtimeOverride, receiveGroups, overlayCurrent, doAdvancePlaylist, nightlightActive, nightlightActiveOld,
+    countdownOverTriggered, doReboot, countdownMode, notifyDirect, receiveDirect, stateChanged, transitionDelay, userVar0,
+    userVar1, strip.mainSeg, nightlightStartTime, countdownTime, rnd);
+  std::string r = trace + b;
+  for (auto &g : strip.seg) {
+    snprintf(b, sizeof(b), "[%08x %08x %08x %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d]",
+      g.colors[0], g.colors[1], g.colors[2], g.mode, g.speed, g.intensity, g.palette, g.custom1, g.custom2, g.custom3,
+      g.check1, g.check2, g.check3, g.selected, g.reverse, g.mirror, g.on, g.freeze, g.start, g.stop, g.startY, g.stopY,
+      g.grouping, g.spacing);
+    r += b;
+  }
+  return r;
+}
+
+static void compare(const char *what, const std::string &params, const std::string &legacy, const std::string &current) {
+  if (legacy == current) return;
+  char msg[1024];
+  snprintf(msg, sizeof(msg), "%s \"%s\"\n was %s\n now %s", what, params.c_str(), legacy.c_str(), current.c_str());
+  TEST_FAIL_MESSAGE(msg);
+}
+
+// every key is found in its hash slot, unknown keys and value keys without value are not
+void test_key_lookup(void) {
+  for (unsigned k = 0; k < API_KEY_COUNT; k++) {
+    const std::string name = keyName(k);
+    TEST_ASSERT_EQUAL(k, httpApiKey(name.c_str(), name.size(), true));
+    TEST_ASSERT_EQUAL(isFlag(k) ? (int)k : -1, httpApiKey(name.c_str(), name.size(), false));
+  }
+  TEST_ASSERT_EQUAL(-1, httpApiKey("QQ", 2, true));
+  TEST_ASSERT_EQUAL(-1, httpApiKey("FXDX", 4, true));
+  TEST_ASSERT_EQUAL(-1, httpApiKey("", 0, true));
+  TEST_ASSERT_EQUAL(-1, httpApiKey("win", 3, false));
+}
+
+// flags are found where String::indexOf() found them, values only after their key
+void test_flags(void) {
+  const char *v[API_KEY_COUNT];
+  httpApiParse("HU=100&SA=200&H2", v);
+  TEST_ASSERT_NOT_NULL(v[API_H2]);
+  TEST_ASSERT_NULL(v[API_K2]);
+  httpApiParse("CL=H2F00FF&K=2700", v);
+  TEST_ASSERT_NOT_NULL(v[API_H2]);                     // inside a value, as before
+  TEST_ASSERT_EQUAL_STRING("H2F00FF&K=2700", v[API_CL]);
+  httpApiParse("SN=1ND&NNX=2", v);
+  TEST_ASSERT_NULL(v[API_ND]);                         // ND and NN only at the start of a key
+  TEST_ASSERT_NOT_NULL(v[API_NN]);
+  httpApiParse("SR&A=5", v);
+  TEST_ASSERT_EQUAL_STRING("A=5", v[API_SR]);          // atoi() reads 0
+  httpApiParse("SR=1", v);
+  TEST_ASSERT_EQUAL_STRING("1", v[API_SR]);
+  httpApiParse("FX&A=1&A=2&T=2&ST=5", v);
+  TEST_ASSERT_NULL(v[API_FX]);                         // no value
+  TEST_ASSERT_EQUAL_STRING("1&A=2&T=2&ST=5", v[API_A]); // first occurrence
+  TEST_ASSERT_EQUAL_STRING("2&ST=5", v[API_T]);
+  TEST_ASSERT_EQUAL_STRING("5", v[API_ST]);
+}
+
+// applied state and calls are the same as with the String based parser
+void test_legacy_equivalence(void) {
+  AsyncWebServerRequest server;
+  const unsigned n = 200000;
+  for (unsigned i = 0; i < n; i++) {
+    const std::string params = request();
+    const String win(("win&" + params).c_str());
+    const bool apply = rng() % 2;
+    AsyncWebServerRequest *req = rng() % 2 ? &server : nullptr;
+    const uint32_t seed = rng();
+    reset(seed); bool ret = handleSetLegacy(req, win, apply);
+    const std::string legacy = state(ret);
+    reset(seed); ret = handleSet(req, win, apply);
+    compare("handleSet()", params, legacy, state(ret));
+    reset(seed); ret = handleSetLegacy(nullptr, win, apply);
+    const std::string legacyNoReq = state(ret);
+    reset(seed); ret = handleHttpApi(params.c_str(), apply);
+    compare("handleHttpApi()", params, legacyNoReq, state(ret));
+  }
+  reset(1);
+  TEST_ASSERT_FALSE(handleSetLegacy(nullptr, String("/json&A=5"), true));
+  TEST_ASSERT_FALSE(handleSet(nullptr, String("/json&A=5"), true));
+  TEST_ASSERT_EQUAL_STRING("", trace.c_str());
+  char msg[64];
+  snprintf(msg, sizeof(msg), "%u requests equivalent", n);
+  TEST_MESSAGE(msg);
+}
+
+// whole request (parse and apply) as from the web server, IR and MQTT
+void test_throughput(void) {
+  const char *bench[] = {"win&A=128", "win&FX=5&SX=128&IX=64&FP=3", "win&R=255&G=10&B=0&W=0&R2=0&G2=0&B2=255&T=1&TT=500&SN=1&NN"};
+  for (auto q : bench) {
+    const String s(q);
+    double rate[2];
+    for (int impl = 0; impl < 2; impl++) {
+      const int n = 100000;
+      reset(1);
+      const clock_t start = clock();
+      for (int i = 0; i < n; i++) {
+        trace.clear();
+        if (impl) handleSet(nullptr, s);
+        else handleSetLegacy(nullptr, s, true);
+      }
+      rate[impl] = n / (double(clock() - start) / CLOCKS_PER_SEC);
+    }
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%-58s %8.0f req/s, was %8.0f req/s (x%.1f)", q, rate[1], rate[0], rate[1] / rate[0]);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(rate[1] > rate[0]);
+  }
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_key_lookup);
+  RUN_TEST(test_flags);
+  RUN_TEST(test_legacy_equivalence);
+  RUN_TEST(test_throughput);
+  return UNITY_END();
+}
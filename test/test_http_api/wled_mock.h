@@ -0,0 +1,183 @@
+// the parts of WLED the HTTP API apply code uses, state changes are recorded in trace (see test_main.cpp)
+#pragma once
+#define WLED_H // http_api.cpp includes "wled.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>
+#include <string>
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+#define PSTR(x) x
+#define F(x) x
+#define DEBUG_PRINTF_P(...)
+#define R(c) (byte((c) >> 16))
+#define G(c) (byte((c) >> 8))
+#define B(c) (byte(c))
+#define W(c) (byte((c) >> 24))
+#define RGBW32(r,g,b,w) (uint32_t((byte(w) << 24) | (byte(r) << 16) | (byte(g) << 8) | (byte(b))))
+#define SEG_OPTION_ON 2
+#define NL_MODE_SUN 3
+#define REALTIME_OVERRIDE_ALWAYS 2
+#define CALL_MODE_DIRECT_CHANGE 1
+#define CALL_MODE_NO_NOTIFY 5
+
+static std::string trace;
+static void logf(const char *fmt, ...) {
+  char b[128];
+  va_list a;
+  va_start(a, fmt);
+  vsnprintf(b, sizeof(b), fmt, a);
+  va_end(a);
+  trace += b;
+}
+
+// Arduino String: allocates like the real one, the legacy parser copies the rest of the request for every value
+class String {
+  std::string s;
+ public:
+  String(const char *c = "") : s(c) {}
+  String(const std::string &c) : s(c) {}
+  const char *c_str() const { return s.c_str(); }
+  int indexOf(const char *n) const { size_t p = s.find(n); return p == std::string::npos ? -1 : (int)p; }
+  String substring(unsigned from) const { return from >= s.size() ? String("") : String(s.substr(from)); }
+  long toInt() const { return atol(s.c_str()); }
+  char charAt(unsigned i) const { return i < s.size() ? s[i] : 0; }
+  size_t length() const { return s.size(); }
+};
+
+struct AsyncResponseStream {};
+struct AsyncWebServerRequest {
+  AsyncResponseStream r;
+  AsyncResponseStream *beginResponseStream(const char *) { return &r; }
+  void send(AsyncResponseStream *) { logf("send;"); }
+};
+static void XML_response(AsyncResponseStream &) { logf("xml;"); }
+
+struct Segment {
+  uint32_t colors[3];
+  uint8_t mode, speed, intensity, palette, custom1, custom2, custom3;
+  bool check1, check2, check3, selected, reverse, mirror, on, freeze, active;
+  uint16_t start, stop, startY, stopY, spacing;
+  uint8_t grouping, map1D2D;
+  void setGeometry(uint16_t a, uint16_t b, uint8_t g, uint16_t s, uint16_t, uint16_t y0, uint16_t y1, uint8_t m) {
+    logf("geo%d,%d,%d,%d,%d,%d,%d;", a, b, g, s, y0, y1, m); start = a; stop = b; grouping = g; spacing = s;
+  }
+  void setOption(uint8_t n, bool v) { logf("opt%d=%d;", n, v); if (n == SEG_OPTION_ON) on = v; }
+  void setOpacity(uint8_t o) { logf("opa%d;", o); }
+  void setColor(uint8_t n, uint32_t c) { logf("col%d=%08x;", n, c); colors[n] = c; }
+  void setMode(uint8_t m, bool d) { logf("mode%d,%d;", m, d); mode = m; }
+  void setPalette(uint8_t p) { logf("pal%d;", p); palette = p; }
+  bool isActive() const { return active; }
+  bool isSelected() const { return selected; }
+};
+
+struct Strip {
+  Segment seg[4];
+  unsigned numSegs = 3, mainSeg = 0;
+  void setMainSegmentId(unsigned n) { logf("main%u;", n); if (n < numSegs) mainSeg = n; }
+  uint8_t getFirstSelectedSegId() { for (unsigned i = 0; i < numSegs; i++) if (seg[i].selected) return i; return mainSeg; }
+  unsigned getSegmentsNum() const { return numSegs; }
+  Segment &getSegment(unsigned i) { return seg[i < numSegs ? i : mainSeg]; }
+  Segment &getMainSegment() { return seg[mainSeg]; }
+  void suspend() { logf("suspend;"); }
+  void resume() { logf("resume;"); }
+  unsigned getModeCount() const { return 187; }
+  unsigned getPaletteCount() const { return 72; }
+  void setTransition(uint16_t t) { logf("tt%u;", t); }
+};
+static Strip strip;
+
+struct Toki { uint32_t second() { return 1700000000; } };
+static Toki toki;
+
+static byte realtimeMode, presetCycMin, presetCycMax, presetCycCurr, bri, briLast, nightlightDelayMins, nightlightDelayMinsDefault;
+static byte nightlightTargetBri, nightlightMode, realtimeOverride, receiveGroups, overlayCurrent;
+static bool doAdvancePlaylist, nightlightActive, nightlightActiveOld, countdownOverTriggered, useMainSegmentOnly, doReboot;
+static bool countdownMode, notifyDirect, receiveDirect, stateChanged;
+static uint16_t transitionDelay, userVar0, userVar1;
+static unsigned long nightlightStartTime, countdownTime;
+
+static uint32_t rnd;
+static unsigned long millis() { return 12345; }
+static uint8_t hw_random8(uint8_t a, uint8_t b) { rnd = rnd * 1103515245 + 12345; return a + (rnd >> 16) % (b > a ? b - a : 1); }
+static void savePreset(byte i) { logf("save%d;", i); }
+static void applyPreset(byte i) { logf("apply%d;", i); }
+static void colorHStoRGB(uint16_t h, byte s, byte *rgb) { rgb[0] = h; rgb[1] = h >> 8; rgb[2] = s; }
+static void colorKtoRGB(uint16_t k, byte *rgb) { rgb[0] = k; rgb[1] = k >> 8; rgb[2] = 7; }
+static void setRandomColor(byte *rgb) { rgb[0] = hw_random8(0, 255); rgb[1] = 1; rgb[2] = 2; }
+static void unloadPlaylist() { logf("unload;"); }
+static void toggleOnOff() { logf("toggle;"); bri = bri ? 0 : briLast; }
+static void setTimeFromAPI(uint32_t t) { logf("time%u;", t); }
+static void stateUpdated(byte m) { logf("upd%d;", m); }
+
+// from colors.cpp and util.cpp, shared by both parsers
+static void colorFromDecOrHexString(byte* rgb, const char* in)
+{
+  if (in[0] == 0) return;
+  char first = in[0];
+  uint32_t c = 0;
+  if (first == '#' || first == 'h' || first == 'H') c = strtoul(in +1, NULL, 16);
+  else c = strtoul(in, NULL, 10);
+  rgb[0] = R(c); rgb[1] = G(c); rgb[2] = B(c); rgb[3] = W(c);
+}
+
+static int getNumVal(const String* req, uint16_t pos)
+{
+  return req->substring(pos+3).toInt();
+}
+
+static void parseNumber(const char* str, byte* val, byte minv=0, byte maxv=255)
+{
+  if (str == nullptr || str[0] == '\0') return;
+  if (str[0] == 'r') {*val = hw_random8(minv,maxv?maxv:255); return;} // maxv for random cannot be 0
+  bool wrap = false;
+  if (str[0] == 'w' && strlen(str) > 1) {str++; wrap = true;}
+  if (str[0] == '~') {
+    int out = atoi(str +1);
+    if (out == 0) {
+      if (str[1] == '0') return;
+      if (str[1] == '-') {
+        *val = (int)(*val -1) < (int)minv ? maxv : min((int)maxv,(*val -1)); //-1, wrap around
+      } else {
+        *val = (int)(*val +1) > (int)maxv ? minv : max((int)minv,(*val +1)); //+1, wrap around
+      }
+    } else {
+      if (wrap && *val == maxv && out > 0) out = minv;
+      else if (wrap && *val == minv && out < 0) out = maxv;
+      else {
+        out += *val;
+        if (out > maxv) out = maxv;
+        if (out < minv) out = minv;
+      }
+      *val = out;
+    }
+    return;
+  } else if (minv == maxv && minv == 0) { // limits "unset" i.e. both 0
+    byte p1 = atoi(str);
+    const char* str2 = strchr(str,'~'); // min/max range (for preset cycle, e.g. "1~5~")
+    if (str2) {
+      byte p2 = atoi(++str2);           // skip ~
+      if (p2 > 0) {
+        while (isdigit(*(++str2)));     // skip digits
+        parseNumber(str2, val, p1, p2);
+        return;
+      }
+    }
+  }
+  *val = atoi(str);
+}
+
+static bool updateVal(const char* req, const char* key, byte* val, byte minv=0, byte maxv=255)
+{
+  const char *v = strstr(req, key);
+  if (v) v += strlen(key);
+  else return false;
+  parseNumber(v, val, minv, maxv);
+  return true;
+}
@@ -0,0 +1,157 @@
+/*
+ * Perlin noise field generators (perlin8Line()/perlin16Line() in perlin.cpp) against the pointwise functions
+ *
+ * Every sample of a line must be bit-exact to perlin8()/perlin16() at the same coordinates, including lines that wrap
+ * around the 16 bit coordinates of perlin8() (the generators split them) and the 32 bit coordinates of perlin16().
+ * The benchmark fills PERLIN_CHUNK sample lines the way the noise effects in FX.cpp do.
+ *   pio test -e native -f test_perlin
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <random>
+#include "perlin.cpp"
+
+static std::mt19937 rng;
+
+void setUp(void) { rng.seed(1); }
+void tearDown(void) {}
+
+static const unsigned maxCount = 300;
+
+static void check8(unsigned count, uint16_t x, uint16_t y, uint16_t dx, uint16_t dy) {
+  uint8_t out[maxCount];
+  perlin8Line(out, count, x, y, dx, dy);
+  for (unsigned i = 0; i < count; i++) {
+    char msg[80];
+    snprintf(msg, sizeof(msg), "2D x=%u y=%u dx=%u dy=%u i=%u", x, y, dx, dy, i);
+    TEST_ASSERT_EQUAL_MESSAGE(perlin8(uint16_t(x + i * dx), uint16_t(y + i * dy)), out[i], msg);
+  }
+}
+
+static void check8(unsigned count, uint16_t x, uint16_t y, uint16_t z, uint16_t dx, uint16_t dy, uint16_t dz) {
+  uint8_t out[maxCount];
+  perlin8Line(out, count, x, y, z, dx, dy, dz);
+  for (unsigned i = 0; i < count; i++) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "3D x=%u y=%u z=%u dx=%u dy=%u dz=%u i=%u", x, y, z, dx, dy, dz, i);
+    TEST_ASSERT_EQUAL_MESSAGE(perlin8(uint16_t(x + i * dx), uint16_t(y + i * dy), uint16_t(z + i * dz)), out[i], msg);
+  }
+}
+
+static void check16(unsigned count, uint32_t x, uint32_t y, uint32_t dx, uint32_t dy) {
+  uint16_t out[maxCount];
+  perlin16Line(out, count, x, y, dx, dy);
+  for (unsigned i = 0; i < count; i++) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "2D x=%u y=%u dx=%u dy=%u i=%u", x, y, dx, dy, i);
+    TEST_ASSERT_EQUAL_MESSAGE(perlin16(x + i * dx, y + i * dy), out[i], msg);
+  }
+}
+
+static void check16(unsigned count, uint32_t x, uint32_t y, uint32_t z, uint32_t dx, uint32_t dy, uint32_t dz) {
+  uint16_t out[maxCount];
+  perlin16Line(out, count, x, y, z, dx, dy, dz);
+  for (unsigned i = 0; i < count; i++) {
+    char msg[128];
+    snprintf(msg, sizeof(msg), "3D x=%u y=%u z=%u dx=%u dy=%u dz=%u i=%u", x, y, z, dx, dy, dz, i);
+    TEST_ASSERT_EQUAL_MESSAGE(perlin16(x + i * dx, y + i * dy, z + i * dz), out[i], msg);
+  }
+}
+
+// step sizes as used by effects (small, a few cells per sample, zero) and random ones
+static uint32_t step(uint32_t range) {
+  switch (rng() % 4) {
+    case 0:  return 0;
+    case 1:  return rng() % (range >> 8);
+    case 2:  return rng() % range;
+    default: return rng();
+  }
+}
+
+void test_perlin8_line(void) {
+  for (unsigned n = 0; n < 2000; n++) {
+    const unsigned count = 1 + rng() % maxCount;
+    check8(count, rng(), rng(), step(0x10000), step(0x10000));
+    check8(count, rng(), rng(), rng(), step(0x10000), step(0x10000), step(0x10000));
+  }
+}
+
+// lines crossing 0xFFFF -> 0 (perlin8() takes uint16_t coordinates, lattice wraps at 0xFF)
+void test_perlin8_wrap(void) {
+  check8(maxCount, 0xFFFF - 100, 0, 1, 0);
+  check8(maxCount, 0, 0xFFF0, 0, 7);
+  check8(maxCount, 0xFF00, 0xFFFF, 0x100, 0xFFFF);        // dy = -1
+  check8(maxCount, 0x8000, 0x8000, 0x8000, 0x8001);       // wraps on every other sample
+  check8(maxCount, 0xFFFF, 0xFFFF, 0xFFFF, 1, 1, 1);
+  check8(maxCount, 0xFE00, 0x1234, 0xFFC0, 0x40, 0, 0x10);
+  for (unsigned n = 0; n < 2000; n++) {
+    const uint16_t near = 0xFFFF - rng() % 0x400;
+    check8(maxCount, near, rng(), 1 + rng() % 0x40, step(0x10000));
+    check8(maxCount, rng(), near, rng(), step(0x10000), 1 + rng() % 0x40, step(0x10000));
+  }
+}
+
+void test_perlin16_line(void) {
+  for (unsigned n = 0; n < 2000; n++) {
+    const unsigned count = 1 + rng() % maxCount;
+    check16(count, rng(), rng(), step(0x1000000), step(0x1000000));
+    check16(count, rng(), rng(), rng(), step(0x1000000), step(0x1000000), step(0x1000000));
+  }
+  check16(maxCount, 0xFFFFFFFF - 0x8000, 0, 0x1000, 0);   // uint32_t wrap
+  check16(maxCount, 0, 0, 0xFFFFFFFF - 0x8000, 0x1000, 0x1000, 0xFFFF0000);
+}
+
+// ns per sample for lines of PERLIN_CHUNK samples, pointwise and with the generator
+template<class T, class Point, class Line>
+static void benchmark(const char *name, Point point, Line line) {
+  const unsigned lines = 100000;
+  T out[PERLIN_CHUNK];
+  unsigned sum = 0;
+  clock_t start = clock();
+  for (unsigned l = 0; l < lines; l++) {
+    for (unsigned i = 0; i < PERLIN_CHUNK; i++) out[i] = point(l, i);
+    sum += out[l % PERLIN_CHUNK];
+  }
+  const double tPoint = 1e9 * double(clock() - start) / CLOCKS_PER_SEC / lines / PERLIN_CHUNK;
+  start = clock();
+  for (unsigned l = 0; l < lines; l++) {
+    line(out, l);
+    sum -= out[l % PERLIN_CHUNK];
+  }
+  const double tLine = 1e9 * double(clock() - start) / CLOCKS_PER_SEC / lines / PERLIN_CHUNK;
+  TEST_ASSERT_EQUAL(0, sum); // same samples, also keeps the loops from being optimized away
+  char msg[112];
+  snprintf(msg, sizeof(msg), "%-24s %.2f ns/sample pointwise, %.2f ns/sample line (x%.2f)", name, tPoint, tLine, tPoint / tLine);
+  TEST_MESSAGE(msg);
+}
+
+void test_benchmark(void) {
+  // mode_noise16_1 (2D row) and Perlin Move style lines
+  benchmark<uint16_t>("perlin16 3D x-row",
+    [](unsigned l, unsigned i) { return perlin16((l + i) * 3000, 0, 4223 + l); },
+    [](uint16_t *out, unsigned l) { perlin16Line(out, PERLIN_CHUNK, l * 3000, 0, 4223 + l, 3000, 0, 0); });
+  benchmark<uint16_t>("perlin16 3D diagonal",
+    [](unsigned l, unsigned i) { return perlin16((l + i) * 3000, (l + i) * 3000, l << 8); },
+    [](uint16_t *out, unsigned l) { perlin16Line(out, PERLIN_CHUNK, l * 3000, l * 3000, l << 8, 3000, 3000, 0); });
+  benchmark<uint16_t>("perlin16 2D x-row",
+    [](unsigned l, unsigned i) { return perlin16((l + i) << 12, l << 6); },
+    [](uint16_t *out, unsigned l) { perlin16Line(out, PERLIN_CHUNK, l << 12, l << 6, 1 << 12, 0); });
+  // mode_noisepal / 2D noise style lines
+  benchmark<uint8_t>("perlin8 2D diagonal",
+    [](unsigned l, unsigned i) { return perlin8(uint16_t((l + i) * 30), uint16_t(l * 4 + i * 30)); },
+    [](uint8_t *out, unsigned l) { perlin8Line(out, PERLIN_CHUNK, l * 30, l * 4, 30, 30); });
+  benchmark<uint8_t>("perlin8 3D x-row",
+    [](unsigned l, unsigned i) { return perlin8(uint16_t((l + i) * 40), uint16_t(l * 7), uint16_t(l)); },
+    [](uint8_t *out, unsigned l) { perlin8Line(out, PERLIN_CHUNK, l * 40, l * 7, l, 40, 0, 0); });
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_perlin8_line);
+  RUN_TEST(test_perlin8_wrap);
+  RUN_TEST(test_perlin16_line);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
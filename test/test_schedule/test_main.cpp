@@ -0,0 +1,143 @@
+/*
+ * Cue schedule (schedule.h): parser, ms exact firing, weekdays, sunrise/sunset and clock changes
+ *
+ * Runs on a simulated clock (local ms since epoch).
+ *   pio test -e native -f test_schedule
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <utility>
+#include "schedule.h"
+
+static const uint64_t MON = 1760918400000ULL;   // 2025-10-20 00:00, a Monday
+
+static void load(CueSchedule &s, const char *txt) {
+  s.beginParse();
+  for (const char *p = txt; *p; p++) s.parse(*p);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_parser(void) {
+  CueSchedule s;
+  load(s, "[[1000,1],[ 3600500 , 2 ],[-60000,3,255,1],[0,4,255,2],[5000,5,6],[7000,0],[1,2,254]]");
+  TEST_ASSERT_EQUAL(6, s.size());               // preset 0 rejected, disabled cues (weekdays bit 0 clear) are kept
+  TEST_ASSERT_EQUAL(3600500, s.get(1).time);
+  TEST_ASSERT_EQUAL(-60000, s.get(2).time);
+  TEST_ASSERT_EQUAL(CUE_REF_SUNRISE, s.get(2).ref);
+  TEST_ASSERT_EQUAL(255, s.get(3).weekdays);
+  TEST_ASSERT_EQUAL(CUE_REF_SUNSET, s.get(3).ref);
+  TEST_ASSERT_EQUAL(6, s.get(4).weekdays);
+
+  CueSchedule r;                                // out of range entries
+  load(r, "[[86400000,1],[-86400000,2],[0,3,255,3],[86399999,4]]");
+  TEST_ASSERT_EQUAL(1, r.size());
+  TEST_ASSERT_EQUAL(4, r.get(0).preset);
+}
+
+void test_fires_on_time(void) {
+  CueSchedule s;
+  load(s, "[[1000,1],[3600500,2],[-60000,3,255,1],[0,4,255,2],[5000,5,6]]");
+  s.setSunTimes(7*3600000, 19*3600000, MON);
+  s.rebuild(MON);
+  int n[6] = {0};
+  std::vector<std::pair<uint64_t,int>> fired;
+  for (uint64_t t = MON; t < MON + 3*CUE_DAY_MS; t += 250) {
+    int i;
+    while ((i = s.pop(t)) >= 0) { n[s.get(i).preset]++; fired.push_back({t, s.get(i).preset}); }
+  }
+  TEST_ASSERT_EQUAL(3, n[1]);
+  TEST_ASSERT_EQUAL(3, n[2]);
+  TEST_ASSERT_EQUAL(3, n[3]);
+  TEST_ASSERT_EQUAL(3, n[4]);
+  TEST_ASSERT_EQUAL(0, n[5]);                   // weekdays=6: bit 0 clear, disabled
+  TEST_ASSERT_EQUAL(MON + 1000, fired[0].first);
+  TEST_ASSERT_EQUAL(MON + 3600500, fired[1].first);
+  TEST_ASSERT_EQUAL(MON + 7*3600000 - 60000, fired[2].first);
+  TEST_ASSERT_EQUAL(MON + 19*3600000, fired[3].first);
+
+  CueSchedule p;                                // millisecond precision
+  load(p, "[[1234,9]]");
+  p.rebuild(MON);
+  TEST_ASSERT_TRUE(p.pop(MON + 1233) < 0);
+  TEST_ASSERT_EQUAL(0, p.pop(MON + 1234));
+  TEST_ASSERT_TRUE(p.pop(MON + 1235) < 0);
+  TEST_ASSERT_TRUE(p.nextDue() == MON + CUE_DAY_MS + 1234);
+}
+
+void test_weekdays(void) {
+  CueSchedule s;
+  load(s, "[[3600000,1,3],[3600000,2,129]]");   // Monday only, Sunday only
+  s.rebuild(MON);
+  std::vector<uint64_t> mon, sun;
+  for (uint64_t t = MON; t < MON + 14*CUE_DAY_MS; t += 60000) {
+    int i;
+    while ((i = s.pop(t)) >= 0) (s.get(i).preset == 1 ? mon : sun).push_back(t);
+  }
+  TEST_ASSERT_EQUAL(2, mon.size());
+  TEST_ASSERT_EQUAL(2, sun.size());
+  TEST_ASSERT_TRUE(mon[0] == MON + 3600000 && mon[1] == MON + 7*CUE_DAY_MS + 3600000);
+  TEST_ASSERT_TRUE(sun[0] == MON + 6*CUE_DAY_MS + 3600000);
+}
+
+// clock set forward: overdue cues are skipped instead of fired in a burst, clock set back: cues are rescheduled
+void test_clock_jumps(void) {
+  CueSchedule j;
+  load(j, "[[1000,1],[2000,2],[3000,3]]");
+  j.rebuild(MON);
+  TEST_ASSERT_TRUE(j.pop(MON + 10*3600000) < 0);
+  TEST_ASSERT_TRUE(j.nextDue() == MON + CUE_DAY_MS + 1000);
+  TEST_ASSERT_TRUE(j.pop(MON - 500) < 0);
+  TEST_ASSERT_TRUE(j.nextDue() == MON + 1000);
+
+  // late by less than CUE_MAX_LATE (slow loop): still fired, one per call
+  TEST_ASSERT_EQUAL(0, j.pop(MON + 3500));
+  TEST_ASSERT_EQUAL(1, j.pop(MON + 3500));
+  TEST_ASSERT_EQUAL(2, j.pop(MON + 3500));
+  TEST_ASSERT_TRUE(j.pop(MON + 3500) < 0);
+}
+
+void test_sun_times(void) {
+  CueSchedule r;
+  load(r, "[[0,1,255,1],[-1800000,2,255,2]]");
+  r.setSunTimes(6*3600000, -1, MON);
+  TEST_ASSERT_TRUE(r.nextDue() == MON + 6*3600000);
+  r.setSunTimes(6*3600000, 20*3600000, MON + 7*3600000);
+  TEST_ASSERT_TRUE(r.nextDue() == MON + 20*3600000 - 1800000);
+  r.setSunTimes(-1, -1, MON);                   // polar night
+  TEST_ASSERT_TRUE(r.nextDue() == CUE_NONE);
+}
+
+// many cues fire in order and each exactly once a day
+void test_many_cues(void) {
+  CueSchedule m;
+  std::string txt = "[";
+  for (int i = 0; i < 500; i++) txt += "[" + std::to_string((i*7919) % 86400000) + "," + std::to_string(i%250+1) + "],";
+  txt.back() = ']';
+  load(m, txt.c_str());
+  TEST_ASSERT_EQUAL(WLED_MAX_CUES < 500 ? WLED_MAX_CUES : 500, m.size());
+  m.rebuild(MON);
+  uint64_t last = 0;
+  unsigned cnt = 0;
+  bool ordered = true;
+  for (uint64_t t = MON; t < MON + CUE_DAY_MS; t += 1000) {
+    int i;
+    while ((i = m.pop(t)) >= 0) { ordered &= t >= last; last = t; cnt++; }
+  }
+  TEST_ASSERT_TRUE(ordered);
+  TEST_ASSERT_EQUAL(m.size() - 1, cnt);         // cue at 00:00:00.000 is not after rebuild time, fires next day
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_parser);
+  RUN_TEST(test_fires_on_time);
+  RUN_TEST(test_weekdays);
+  RUN_TEST(test_clock_jumps);
+  RUN_TEST(test_sun_times);
+  RUN_TEST(test_many_cues);
+  return UNITY_END();
+}
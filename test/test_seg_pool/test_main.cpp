@@ -0,0 +1,124 @@
+/*
+ * Segment pool (seg_pool.h): slab allocator fuzzing, single task and with the loop and async_tcp tasks allocating
+ *
+ * Segment::poolAlloc()/poolFree() need Arduino, so they are reproduced here with a mutex in place of SEGMEM_LOCK().
+ * Every block is filled with a tag and checked before it is freed: overlapping blocks (i.e. a page handed out twice
+ * by concurrent allocations) show up as corrupted tags.
+ *   pio test -e native -f test_seg_pool
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "seg_pool.h"
+
+alignas(8) static uint8_t mem[8192 + 100];
+static SlabPool pool;
+static std::mutex segMemMux;
+
+// same as Segment::poolAlloc()/poolFree(), heap fallback outside the lock
+static void *poolAlloc(size_t len) {
+  segMemMux.lock();
+  void *ptr = pool.alloc(len);
+  if (!ptr) pool.fallback();
+  segMemMux.unlock();
+  return ptr ? ptr : malloc(len);
+}
+
+static void poolFree(void *ptr) {
+  if (!ptr) return;
+  segMemMux.lock();
+  const bool pooled = pool.free(ptr);
+  segMemMux.unlock();
+  if (!pooled) free(ptr);
+}
+
+typedef struct { uint8_t *p; size_t len; uint8_t tag; } Block;
+
+// random allocations (mostly effect data and names, some larger than a page) and frees of random live blocks
+// returns number of corrupted blocks
+static unsigned churn(unsigned seed, unsigned iterations, unsigned maxLive) {
+  std::mt19937 rng(seed);
+  std::vector<Block> live;
+  unsigned corrupt = 0;
+  for (unsigned it = 0; it < iterations; it++) {
+    if (live.empty() || (rng() % 100) < (live.size() < maxLive ? 60U : 40U)) {
+      const size_t len = 1 + rng() % (rng() % 4 ? 200 : 700);
+      uint8_t *q = static_cast<uint8_t*>(poolAlloc(len));
+      if (!q) continue;
+      if (pool.owns(q) && ((uintptr_t(q) & 7) || pool.blockSize(q) < len)) corrupt++;
+      const uint8_t tag = rng();
+      memset(q, tag, len);
+      live.push_back({q, len, tag});
+    } else {
+      const size_t i = rng() % live.size();
+      const Block b = live[i];
+      for (size_t k = 0; k < b.len; k++) if (b.p[k] != b.tag) { corrupt++; break; }
+      poolFree(b.p);
+      live[i] = live.back();
+      live.pop_back();
+    }
+  }
+  for (const auto &b : live) {
+    for (size_t k = 0; k < b.len; k++) if (b.p[k] != b.tag) { corrupt++; break; }
+    poolFree(b.p);
+  }
+  return corrupt;
+}
+
+void setUp(void) { pool.begin(mem, sizeof(mem)); }
+void tearDown(void) {}
+
+void test_begin(void) {
+  TEST_ASSERT_EQUAL(8192, pool.capacity());     // remainder of last page unused
+  TEST_ASSERT_EQUAL(0, SlabPool::sizeClass(1));
+  TEST_ASSERT_EQUAL(0, SlabPool::sizeClass(16));
+  TEST_ASSERT_EQUAL(1, SlabPool::sizeClass(17));
+  TEST_ASSERT_EQUAL(SLAB_CLASSES - 1, SlabPool::sizeClass(SLAB_PAGE_SIZE));
+  TEST_ASSERT_EQUAL(SLAB_CLASSES, SlabPool::sizeClass(SLAB_PAGE_SIZE + 1));
+  TEST_ASSERT_NULL(pool.alloc(0));
+  TEST_ASSERT_NULL(pool.alloc(SLAB_PAGE_SIZE + 1));
+  int x;
+  TEST_ASSERT_FALSE(pool.free(&x));             // not from pool, caller frees it
+}
+
+void test_fuzz(void) {
+  TEST_ASSERT_EQUAL(0, churn(1, 500000, 40));
+  const slab_stats_t &s = pool.stats();
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%u pool allocs, %u fallbacks, peak pages %u", s.allocs, s.fallbacks, s.peakPages);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL(0, s.used);                 // everything given back
+  TEST_ASSERT_EQUAL(0, s.pages);
+  TEST_ASSERT_TRUE(s.allocs > 100000);
+  TEST_ASSERT_TRUE(s.fallbacks > 0);
+}
+
+// loop task (effect data, transitions) and async_tcp (names, effect changes from the API) at the same time
+void test_concurrent_tasks(void) {
+  unsigned corrupt[2] = {0, 0};
+  std::thread loop([&] { corrupt[0] = churn(2, 300000, 30); });
+  std::thread asyncTcp([&] { corrupt[1] = churn(3, 300000, 10); });
+  loop.join();
+  asyncTcp.join();
+  const slab_stats_t &s = pool.stats();
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%u pool allocs, %u fallbacks, peak pages %u", s.allocs, s.fallbacks, s.peakPages);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL(0, corrupt[0] + corrupt[1]);
+  TEST_ASSERT_EQUAL(0, s.used);
+  TEST_ASSERT_EQUAL(0, s.pages);
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_begin);
+  RUN_TEST(test_fuzz);
+  RUN_TEST(test_concurrent_tasks);
+  return UNITY_END();
+}
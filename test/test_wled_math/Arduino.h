@@ -0,0 +1,9 @@
+// the parts of Arduino.h wled_math.cpp uses (see test_main.cpp)
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+#define PROGMEM
+#define pgm_read_byte_near(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word_near(addr) (*(const uint16_t *)(addr))
+#define M_TWOPI (2.0 * M_PI)
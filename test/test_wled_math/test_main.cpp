@@ -0,0 +1,131 @@
+/*
+ * Table based integer math (sin16_lut(), cos16_lut(), atan2_16() and sqrt32_lut() in wled_math.cpp) against libm
+ *
+ * wled_math.cpp is built against an Arduino.h stand-in (in this folder), the compile time generated tables are the
+ * ones the firmware uses. Error bounds are the ones documented in wled_math.cpp and fcn_declare.h.
+ *   pio test -e native -f test_wled_math
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <random>
+#include "wled_math.cpp"
+
+static std::mt19937 rng;
+
+void setUp(void) { rng.seed(1); }
+void tearDown(void) {}
+
+// angle difference in 16 bit units, wrapping at 2*pi
+static double angleError(double a, double b) {
+  double d = fmod(a - b, 65536.0);
+  if (d >  32768.0) d -= 65536.0;
+  if (d < -32768.0) d += 65536.0;
+  return fabs(d);
+}
+
+// all 65536 angles, +/-2 LSB of 0x7FFF * sin(theta), sin16_t() for comparison
+void test_sin16_lut(void) {
+  double maxLut = 0, maxCos = 0, maxBhaskara = 0;
+  for (unsigned theta = 0; theta < 0x10000; theta++) {
+    const double a = theta * (2.0 * M_PI / 65536.0);
+    maxLut      = fmax(maxLut,      fabs(sin16_lut(theta) - 32767.0 * sin(a)));
+    maxCos      = fmax(maxCos,      fabs(cos16_lut(theta) - 32767.0 * cos(a)));
+    maxBhaskara = fmax(maxBhaskara, fabs(sin16_t(theta)   - 32767.0 * sin(a)));
+  }
+  char msg[112];
+  snprintf(msg, sizeof(msg), "max error sin16_lut %.2f, cos16_lut %.2f, sin16_t %.2f (LSB)", maxLut, maxCos, maxBhaskara);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(maxLut <= 2.0);
+  TEST_ASSERT_TRUE(maxCos <= 2.0);
+  TEST_ASSERT_EQUAL(0, sin16_lut(0));
+  TEST_ASSERT_EQUAL(32767, sin16_lut(0x4000));
+  TEST_ASSERT_EQUAL(-32767, sin16_lut(0xC000));
+}
+
+// +/-2 units (0.01 degree) of atan2() for small (pixel offsets) and large arguments in all quadrants
+void test_atan2_16(void) {
+  double maxErr = 0, maxErrT = 0;
+  auto check = [&](int32_t y, int32_t x) {
+    if (x == 0 && y == 0) return;
+    const double ref = atan2((double)y, (double)x) * (65536.0 / (2.0 * M_PI));
+    const double err = angleError(atan2_16(y, x), ref);
+    if (err > maxErr) maxErr = err;
+    char msg[64];
+    snprintf(msg, sizeof(msg), "atan2_16(%d, %d)", (int)y, (int)x);
+    TEST_ASSERT_TRUE_MESSAGE(err <= 2.0, msg);
+    maxErrT = fmax(maxErrT, angleError(atan2_t(y, x) * (65536.0 / (2.0 * M_PI)), ref));
+  };
+  for (int y = -256; y <= 256; y++) for (int x = -256; x <= 256; x++) check(y, x);
+  for (unsigned n = 0; n < 1000000; n++) {
+    const unsigned bits = 1 + rng() % 31;
+    check(int32_t(rng()) >> (32 - bits), int32_t(rng()) >> (32 - bits));
+  }
+  check(INT32_MAX, INT32_MAX);
+  check(INT32_MIN, INT32_MAX);
+  check(INT32_MIN, INT32_MIN);
+  check(1, INT32_MIN);
+  check(-1, INT32_MIN);
+  TEST_ASSERT_EQUAL(0, atan2_16(0, 5));
+  TEST_ASSERT_EQUAL(0x4000, atan2_16(5, 0));
+  TEST_ASSERT_EQUAL(0x8000, atan2_16(0, -5));
+  TEST_ASSERT_EQUAL(0xC000, atan2_16(-5, 0));
+  char msg[80];
+  snprintf(msg, sizeof(msg), "max error atan2_16 %.2f, atan2_t %.2f (1/65536 turn)", maxErr, maxErrT);
+  TEST_MESSAGE(msg);
+}
+
+// exact floor(sqrt(x)) around every square up to 2^16 and for random values, same as sqrt32_bw()
+void test_sqrt32_lut(void) {
+  for (uint32_t r = 0; r <= 0xFFFF; r++) {
+    const uint32_t sq = r * r;
+    TEST_ASSERT_EQUAL(r, sqrt32_lut(sq));
+    if (sq) TEST_ASSERT_EQUAL(r - 1, sqrt32_lut(sq - 1));
+    if (r < 0xFFFF) TEST_ASSERT_EQUAL(r, sqrt32_lut(sq + 2 * r)); // (r+1)^2 - 1
+  }
+  TEST_ASSERT_EQUAL(0xFFFF, sqrt32_lut(UINT32_MAX));
+  for (unsigned n = 0; n < 1000000; n++) {
+    const uint32_t x = rng() >> (rng() % 32);
+    const uint32_t ref = (uint32_t)floor(sqrt((double)x));
+    TEST_ASSERT_EQUAL(ref, sqrt32_lut(x));
+    TEST_ASSERT_EQUAL(ref, sqrt32_bw(x));
+  }
+}
+
+// ns per call, table based against the functions they replace
+template<class F>
+static double callTime(F f) {
+  const unsigned calls = 10000000;
+  volatile uint32_t sink = 0;
+  const clock_t start = clock();
+  for (unsigned i = 0; i < calls; i++) sink += f(i * 2654435761U);
+  (void)sink;
+  return 1e9 * double(clock() - start) / CLOCKS_PER_SEC / calls;
+}
+
+void test_benchmark(void) {
+  char msg[112];
+  double a = callTime([](uint32_t v) { return (uint32_t)sin16_t(v); });
+  double b = callTime([](uint32_t v) { return (uint32_t)sin16_lut(v); });
+  snprintf(msg, sizeof(msg), "sin16_t %.2f ns, sin16_lut %.2f ns", a, b);
+  TEST_MESSAGE(msg);
+  a = callTime([](uint32_t v) { return (uint32_t)(40.7436f * atan2_t(int8_t(v), int8_t(v >> 8))); });
+  b = callTime([](uint32_t v) { return (uint32_t)atan2_16(int8_t(v), int8_t(v >> 8)); });
+  snprintf(msg, sizeof(msg), "atan2_t %.2f ns, atan2_16 %.2f ns", a, b);
+  TEST_MESSAGE(msg);
+  a = callTime([](uint32_t v) { return sqrt32_bw(v); });
+  b = callTime([](uint32_t v) { return sqrt32_lut(v); });
+  snprintf(msg, sizeof(msg), "sqrt32_bw %.2f ns, sqrt32_lut %.2f ns", a, b);
+  TEST_MESSAGE(msg);
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sin16_lut);
+  RUN_TEST(test_atan2_16);
+  RUN_TEST(test_sqrt32_lut);
+  RUN_TEST(test_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,130 @@
+/*
+ * WebSocket client list and info schedule for incremental state updates (ws_clients.h)
+ *
+ * wsEvent() adds, removes and subscribes clients from the async_tcp task while loop() broadcasts from a snapshot;
+ * the concurrency test does the same from two threads.
+ *   pio test -e native -f test_ws_clients
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <thread>
+#include <atomic>
+#include <random>
+#include "ws_clients.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const WsClientState *findIn(const std::vector<WsClientState> &v, uint32_t id) {
+  for (const auto &c : v) if (c.id == id) return &c;
+  return nullptr;
+}
+
+void test_subscribe_and_sync(void) {
+  WsClientList list;
+  list.add(1);
+  list.add(2);
+  list.add(2);                                  // connect event repeated
+  TEST_ASSERT_EQUAL(2, list.snapshot().size());
+  TEST_ASSERT_EQUAL(0, list.subscribers());
+
+  list.subscribe(1, true);
+  list.subscribe(7, true);                      // unknown client is ignored
+  TEST_ASSERT_EQUAL(1, list.subscribers());
+  auto snap = list.snapshot();
+  TEST_ASSERT_TRUE(findIn(snap, 1)->sync);      // first broadcast after subscribing is full state
+
+  snap[0].sync = false;                         // broadcast sent full state
+  list.update(snap);
+  TEST_ASSERT_FALSE(findIn(list.snapshot(), 1)->sync);
+
+  list.subscribe(1, false);
+  TEST_ASSERT_EQUAL(0, list.subscribers());
+  TEST_ASSERT_FALSE(findIn(list.snapshot(), 1)->sync);
+}
+
+// clients changing while a broadcast is in progress must not be overwritten by its snapshot
+void test_update_after_concurrent_change(void) {
+  WsClientList list;
+  list.add(1);
+  list.add(2);
+  list.subscribe(1, true);
+  auto snap = list.snapshot();
+  for (auto &c : snap) c.sync = false;          // broadcast sends full state to 1
+
+  list.subscribe(1, true);                      // re-subscribed meanwhile: needs full state again
+  list.remove(2);                               // disconnected meanwhile
+  list.add(3);                                  // connected meanwhile
+  list.update(snap);
+
+  auto now = list.snapshot();
+  TEST_ASSERT_EQUAL(2, now.size());
+  TEST_ASSERT_NULL(findIn(now, 2));
+  TEST_ASSERT_TRUE(findIn(now, 1)->sync);
+  TEST_ASSERT_NOT_NULL(findIn(now, 3));
+}
+
+// connect/disconnect/subscribe (async_tcp) racing broadcasts (loop)
+void test_concurrent_access(void) {
+  WsClientList list;
+  std::atomic<bool> done(false);
+  std::thread async([&]() {
+    std::mt19937 rng(1);
+    for (unsigned i = 0; i < 200000; i++) {
+      const uint32_t id = 1 + rng() % 16;
+      switch (rng() % 4) {
+        case 0: list.add(id); break;
+        case 1: list.remove(id); break;
+        default: list.subscribe(id, rng() & 1); break;
+      }
+    }
+    done = true;
+  });
+  unsigned broadcasts = 0;
+  bool unique = true;
+  while (!done) {
+    auto snap = list.snapshot();
+    for (size_t i = 0; i < snap.size(); i++) {
+      for (size_t j = i + 1; j < snap.size(); j++) unique &= snap[i].id != snap[j].id;
+      if (snap[i].sub) snap[i].sync = !snap[i].sync;
+    }
+    list.subscribers();
+    list.update(snap);
+    broadcasts++;
+  }
+  async.join();
+  char msg[48];
+  snprintf(msg, sizeof(msg), "%u broadcasts during 200000 events", broadcasts);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(unique);
+  TEST_ASSERT_TRUE(list.snapshot().size() <= 16);
+}
+
+void test_info_schedule(void) {
+  WsInfoSchedule info;
+  TEST_ASSERT_TRUE(info.due(1000, 0));          // nothing sent yet
+  info.sent(1000, 0);
+  TEST_ASSERT_FALSE(info.due(1000, 0));
+  TEST_ASSERT_FALSE(info.due(1000 + WS_INFO_INTERVAL - 1, 0));
+  TEST_ASSERT_TRUE(info.due(1000 + WS_INFO_INTERVAL, 0));
+  TEST_ASSERT_TRUE(info.due(1001, 4u << 24));   // realtime mode started: live overlay must show immediately
+  info.sent(1001, 4u << 24);
+  TEST_ASSERT_FALSE(info.due(1002, 4u << 24));
+  TEST_ASSERT_TRUE(info.due(1002, 0));          // and ended
+
+  info.sent(0xFFFFFF00UL, 0);                   // millis() rollover
+  TEST_ASSERT_FALSE(info.due(0x10, 0));
+  TEST_ASSERT_TRUE(info.due(WS_INFO_INTERVAL, 0));
+
+  info.reset();                                 // last subscriber left
+  TEST_ASSERT_TRUE(info.due(0xFFFFFF01UL, 0));
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_subscribe_and_sync);
+  RUN_TEST(test_update_after_concurrent_change);
+  RUN_TEST(test_concurrent_access);
+  RUN_TEST(test_info_schedule);
+  return UNITY_END();
+}
@@ -0,0 +1,232 @@
+/*
+ * Incremental WebSocket state updates (ws_delta.h)
+ *
+ * A client merging every delta into its copy of the state must end up with the state the server has, for random
+ * changes of top level and segment keys and added and removed segments. Also measures bytes sent to a subscriber
+ * dragging a slider against full state+info as sent to other clients.
+ *   pio test -e native -f test_ws_delta
+ */
+#include <unity.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <random>
+#include <unordered_map>
+#define ARDUINOJSON_DECODE_UNICODE 0
+#include "src/dependencies/json/ArduinoJson-v6.h"
+#include "ws_delta.h"
+
+static DynamicJsonDocument server(65536);
+static DynamicJsonDocument client(65536);
+static std::mt19937 rng;
+
+class StringWriter {
+  public:
+    std::string s;
+    size_t write(uint8_t c) { s += (char)c; return 1; }
+    size_t write(const uint8_t *p, size_t n) { s.append((const char*)p, n); return n; }
+};
+
+// like serializeSegment()
+static void addSegment(JsonArray segs, unsigned id) {
+  JsonObject s = segs.createNestedObject();
+  s["id"] = id; s["start"] = id * 30; s["stop"] = id * 30 + 30; s["len"] = 30;
+  s["grp"] = 1; s["spc"] = 0; s["of"] = 0; s["on"] = true; s["frz"] = false; s["bri"] = 255; s["cct"] = 127; s["set"] = 0;
+  JsonArray col = s.createNestedArray("col");
+  for (int i = 0; i < 3; i++) { JsonArray c = col.createNestedArray(); c.add(255); c.add(160); c.add(0); }
+  s["fx"] = 0; s["sx"] = 128; s["ix"] = 128; s["pal"] = 0; s["c1"] = 128; s["c2"] = 128; s["c3"] = 16;
+  s["sel"] = id == 0; s["rev"] = false; s["mi"] = false; s["o1"] = false; s["o2"] = false; s["o3"] = false; s["si"] = 0; s["m12"] = 0;
+}
+
+// like serializeState()
+static void resetState(unsigned segments) {
+  server.clear();
+  JsonObject st = server.createNestedObject("state");
+  st["on"] = true; st["bri"] = 128; st["transition"] = 7; st["ps"] = -1; st["pl"] = -1; st["ledmap"] = 0;
+  JsonObject nl = st.createNestedObject("nl");
+  nl["on"] = false; nl["dur"] = 60; nl["mode"] = 1; nl["tbri"] = 0; nl["rem"] = -1;
+  JsonObject udpn = st.createNestedObject("udpn");
+  udpn["send"] = false; udpn["recv"] = true; udpn["sgrp"] = 1; udpn["rgrp"] = 1;
+  st["lor"] = 0; st["mainseg"] = 0;
+  JsonArray segs = st.createNestedArray("seg");
+  for (unsigned i = 0; i < segments; i++) addSegment(segs, i);
+  client.clear();
+  client.createNestedArray("seg");
+}
+
+// like serializeInfo(), sent to clients that are not subscribed with every update
+static void addInfo(JsonObject info) {
+  info["ver"] = "0.15.0"; info["vid"] = 2410270; info["cn"] = "Kōsen"; info["release"] = "ESP32";
+  JsonObject leds = info.createNestedObject("leds");
+  leds["count"] = 300; leds["pwr"] = 1250; leds["fps"] = 42; leds["maxpwr"] = 5000; leds["maxseg"] = 32;
+  JsonArray segLC = leds.createNestedArray("seglc");
+  for (int i = 0; i < 4; i++) segLC.add(1);
+  leds["lc"] = 1; leds["rgbw"] = false; leds["wv"] = 0; leds["cct"] = 0;
+  info["str"] = false; info["name"] = "WLED"; info["udpport"] = 21324; info["simplifiedui"] = false; info["live"] = false;
+  info["liveseg"] = -1; info["lm"] = ""; info["lip"] = ""; info["ws"] = 2; info["fxcount"] = 187; info["palcount"] = 71;
+  info["cpalcount"] = 0;
+  JsonArray maps = info.createNestedArray("maps");
+  maps.createNestedObject()["id"] = 0;
+  JsonObject wifi = info.createNestedObject("wifi");
+  wifi["bssid"] = "AA:BB:CC:DD:EE:FF"; wifi["rssi"] = -62; wifi["signal"] = 76; wifi["channel"] = 6; wifi["ap"] = false;
+  JsonObject fs = info.createNestedObject("fs");
+  fs["u"] = 24; fs["t"] = 983; fs["pmt"] = 1730000000;
+  info["ndc"] = 2; info["arch"] = "esp32"; info["core"] = "v4.4.7"; info["clock"] = 240; info["flash"] = 4;
+  info["lwip"] = 0; info["freeheap"] = 173000; info["uptime"] = 86400; info["time"] = "2024-10-27, 12:00:00";
+  info["opt"] = 79; info["brand"] = "WLED"; info["product"] = "FOSS"; info["mac"] = "aabbccddeeff"; info["ip"] = "192.168.1.50";
+}
+
+// apply {"d":{...}} like the UI does
+static void merge(const std::string &msg) {
+  DynamicJsonDocument d(16384);
+  TEST_ASSERT_EQUAL(DeserializationError::Ok, deserializeJson(d, msg).code());
+  for (JsonPair kv : d["d"].as<JsonObject>()) {
+    const std::string key = kv.key().c_str(); // copied into client document
+    if (key != "seg") { if (kv.value().isNull()) client.remove(key); else client[key] = kv.value(); continue; }
+    JsonArray segs = client["seg"];
+    for (JsonObject s : kv.value().as<JsonArray>()) {
+      const unsigned id = s["id"];
+      size_t i = 0;
+      for (; i < segs.size(); i++) if (segs[i]["id"] == id) break;
+      if (s.size() == 2 && s.containsKey("stop") && s["stop"] == 0) { segs.remove(i); continue; } // removed segment
+      JsonObject c = i < segs.size() ? segs[i].as<JsonObject>() : segs.createNestedObject();
+      for (JsonPair skv : s) {
+        if (skv.value().isNull()) c.remove(std::string(skv.key().c_str()));
+        else c[std::string(skv.key().c_str())] = skv.value();
+      }
+    }
+  }
+}
+
+static std::string text(JsonVariantConst v) {
+  std::string s;
+  serializeJson(v, s);
+  return s;
+}
+
+// client copy has every key of server state with the same value
+static void compareClient(unsigned step) {
+  char msg[64];
+  snprintf(msg, sizeof(msg), "step %u", step);
+  JsonObjectConst st = server["state"];
+  TEST_ASSERT_EQUAL_MESSAGE(st.size(), client.as<JsonObjectConst>().size(), msg);
+  for (JsonPairConst kv : st) {
+    if (strcmp(kv.key().c_str(), "seg") == 0) continue;
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(text(kv.value()).c_str(), text(client[kv.key().c_str()]).c_str(), msg);
+  }
+  JsonArrayConst segs = st["seg"], csegs = client["seg"];
+  TEST_ASSERT_EQUAL_MESSAGE(segs.size(), csegs.size(), msg);
+  for (JsonObjectConst s : segs) {
+    JsonObjectConst c;
+    for (JsonObjectConst x : csegs) if (x["id"] == s["id"]) c = x;
+    TEST_ASSERT_FALSE_MESSAGE(c.isNull(), msg);
+    TEST_ASSERT_EQUAL_MESSAGE(s.size(), c.size(), msg);
+    for (JsonPairConst kv : s) TEST_ASSERT_EQUAL_STRING_MESSAGE(text(kv.value()).c_str(), text(c[kv.key().c_str()]).c_str(), msg);
+  }
+}
+
+// broadcast to subscriber, returns bytes sent
+static size_t broadcast(WsStateDelta &delta) {
+  std::vector<WsStateChange> changes;
+  delta.changes(server["state"].as<JsonObjectConst>(), changes);
+  StringWriter w;
+  WsStateDelta::print(w, changes, JsonObjectConst());
+  merge(w.s);
+  return w.s.size();
+}
+
+void setUp(void) { rng.seed(1); }
+void tearDown(void) {}
+
+// subscriber gets only what changed, i.e. the slider it is dragging
+void test_slider(void) {
+  WsStateDelta delta;
+  resetState(4);
+  broadcast(delta); // initial sync
+  size_t deltaBytes = 0, fullBytes = 0;
+  const unsigned n = 1000;
+  for (unsigned i = 0; i < n; i++) {
+    JsonObject seg = server["state"]["seg"][0];
+    seg["sx"] = (i * 7) % 256;
+    if (i % 100 == 99) server["state"]["bri"] = 128 + i % 100; // someone else changes brightness now and then
+    deltaBytes += broadcast(delta);
+    DynamicJsonDocument full(16384);
+    full["state"] = server["state"];
+    addInfo(full.createNestedObject("info"));
+    fullBytes += measureJson(full);
+  }
+  compareClient(n);
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%u slider updates: %u bytes (%.0f per update), full state+info %u bytes (x%.0f), baseline %u bytes",
+    n, (unsigned)deltaBytes, deltaBytes / double(n), (unsigned)fullBytes, fullBytes / double(deltaBytes), (unsigned)delta.memoryUsage());
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(deltaBytes * 20 < fullBytes);
+  TEST_ASSERT_TRUE(deltaBytes < 40 * n);
+}
+
+// random changes, client state follows server state exactly
+void test_client_merge(void) {
+  WsStateDelta delta;
+  resetState(2);
+  static const char *topKeys[] = {"on", "bri", "transition", "ps", "pl", "lor", "mainseg"};
+  static const char *segKeys[] = {"start", "stop", "on", "frz", "bri", "cct", "fx", "sx", "ix", "pal", "c1", "c2", "c3", "sel", "rev", "mi", "o1"};
+  unsigned nextId = 2;
+  for (unsigned step = 0; step < 20000; step++) {
+    JsonObject st = server["state"];
+    JsonArray segs = st["seg"];
+    const unsigned changes = rng() % 4;
+    for (unsigned c = 0; c < changes; c++) {
+      switch (rng() % 10) {
+        case 0: st[topKeys[rng() % 7]] = rng() % 3 ? (int)(rng() % 256) - 1 : (int)(rng() % 2); break;
+        case 1: st["nl"]["dur"] = rng() % 256; break;
+        case 2: st["udpn"]["sgrp"] = rng() % 256; break;
+        case 3: if (segs.size() < 16 && nextId < 32) addSegment(segs, nextId++); break;
+        case 4: if (segs.size() > 1) segs.remove(rng() % segs.size()); break;
+        case 5: segs[rng() % segs.size()]["col"][rng() % 3][rng() % 3] = rng() % 256; break;
+        case 6: segs[rng() % segs.size()]["n"] = rng() % 2 ? "Kitchen" : "Kitchen 2"; break;
+        case 7: if (rng() % 2) segs[rng() % segs.size()].remove("n"); else st.remove("pl"); break;
+        default: segs[rng() % segs.size()][segKeys[rng() % 17]] = 1 + rng() % 255; break; // stop 0 would remove segment
+      }
+    }
+    if (nextId == 32 && segs.size() < 4) nextId = 0; // reuse ids of removed segments
+    while (nextId < 32) { bool used = false; for (JsonObject s : segs) used |= s["id"] == nextId; if (!used) break; nextId++; }
+    broadcast(delta);
+    compareClient(step);
+    server.garbageCollect();
+    client.garbageCollect();
+  }
+}
+
+// values a 32 bit hash of the serialized value can not tell apart are still sent
+void test_no_missed_change(void) {
+  uint32_t a = 0, b = 0;
+  std::unordered_map<uint32_t, uint32_t> seen;
+  for (uint32_t v = 0; !b; v++) { // FNV-1a as was used to detect changes
+    char s[12];
+    snprintf(s, sizeof(s), "%u", v);
+    uint32_t h = 2166136261UL;
+    for (const char *p = s; *p; p++) h = (h ^ (uint8_t)*p) * 16777619UL;
+    auto it = seen.find(h);
+    if (it != seen.end()) { a = it->second; b = v; }
+    else seen[h] = v;
+  }
+  char msg[64];
+  snprintf(msg, sizeof(msg), "FNV-1a of %u and %u collide", a, b);
+  TEST_MESSAGE(msg);
+  WsStateDelta delta;
+  resetState(1);
+  server["state"]["seg"][0]["sx"] = a;
+  broadcast(delta);
+  server["state"]["seg"][0]["sx"] = b;
+  TEST_ASSERT_TRUE(broadcast(delta) > 10);
+  compareClient(0);
+  TEST_ASSERT_EQUAL(b, client["seg"][0]["sx"].as<uint32_t>());
+}
+
+int main(int, char **) {
+  UNITY_BEGIN();
+  RUN_TEST(test_slider);
+  RUN_TEST(test_client_merge);
+  RUN_TEST(test_no_missed_change);
+  return UNITY_END();
+}
@@ -0,0 +1,57 @@
+'use strict';
+
+// Checks that the per-type pixel writers of PolyBus::getPixelWriter() (bus_wrapper.h) write pixels exactly like the
+// generic PolyBus::setPixelColor() does: same NeoPixelBus type and same color type for every bus type.
+
+const assert = require('node:assert');
+const { describe, it } = require('node:test');
+const fs = require('fs');
+const path = require('path');
+
+const source = fs.readFileSync(path.join(__dirname, '..', 'wled00', 'bus_wrapper.h'), 'utf8');
+
+// body of a PolyBus function (up to the closing brace at function indentation)
+function functionBody(signature) {
+  const start = source.indexOf(signature);
+  assert.notStrictEqual(start, -1, `${signature} not found`);
+  const end = source.indexOf('\n  }\n', start);
+  return source.substring(start, end);
+}
+
+// map bus type -> list of [NeoPixelBus type, color type] (two entries for I2S types with parallel I2S variant)
+function parseCases(body, pattern, colorType) {
+  const cases = new Map();
+  for (const line of body.split('\n')) {
+    const m = line.match(/^\s*case\s+(I_\w+):(.*)$/);
+    if (!m) continue;
+    const targets = [...m[2].matchAll(pattern)].map(t => [t[1], colorType(t[2])]);
+    cases.set(m[1], targets);
+  }
+  return cases;
+}
+
+const writers = parseCases(functionBody('static PixelWriter getPixelWriter('),
+  /writePixel<(\w+),\s*(\w+)>/g, c => c);
+const setters = parseCases(functionBody('static void setPixelColor(void* busPtr'),
+  /static_cast<(\w+)\*>\(busPtr\)\)->SetPixelColor\(pix,\s*(.+?)\);/g,
+  expr => expr === 'col' ? 'RgbwColor' : expr === 'RgbColor(col)' ? 'RgbColor' : expr);
+
+describe('PolyBus pixel writers', () => {
+  it('exist for some bus types', () => {
+    assert.ok(writers.size > 20, `only ${writers.size} writers found`);
+  });
+
+  it('write the same NeoPixelBus type and color type as setPixelColor()', () => {
+    for (const [type, targets] of writers) {
+      assert.ok(setters.has(type), `${type} has a writer but no setPixelColor() case`);
+      assert.deepStrictEqual(targets, setters.get(type), `${type}`);
+    }
+  });
+
+  it('cover every plain RGB/RGBW bus type', () => {
+    for (const [type, targets] of setters) {
+      const plain = targets.length > 0 && targets.every(([, color]) => color === 'RgbColor' || color === 'RgbwColor');
+      if (plain) assert.ok(writers.has(type), `${type} has no pixel writer`);
+    }
+  });
+});
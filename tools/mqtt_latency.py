@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+# MQTT round trip latency test
+#
+# Sends brightness commands to a WLED device over MQTT and measures the time until the device publishes
+# the new brightness on <topic>/g. Includes a minimal MQTT 3.1.1 broker (QoS 0, retained messages, wildcards,
+# last will) so no mosquitto is needed: point WLED's MQTT broker setting to this machine and run
+#
+#   python3 mqtt_latency.py wled/abcdef                  # built-in broker on port 1883
+#   python3 mqtt_latency.py wled/abcdef --broker 10.0.0.2 # external broker
+#   python3 mqtt_latency.py --selftest                    # built-in broker and simulated device
+#
+# --mode api sends "A=n" to <topic>/api (HTTP API fast path), bri sends "n" to <topic>, json sends {"bri":n} to <topic>/api
+
+import argparse
+import socket
+import socketserver
+import statistics
+import struct
+import threading
+import time
+
+
+def encode_len(n):
+    out = bytearray()
+    while True:
+        b = n % 128
+        n //= 128
+        out.append(b | (0x80 if n else 0))
+        if not n:
+            return bytes(out)
+
+
+def encode_str(s):
+    b = s.encode() if isinstance(s, str) else s
+    return struct.pack('!H', len(b)) + b
+
+
+def read_packet(sock):
+    hdr = sock.recv(1)
+    if not hdr:
+        return None, None
+    mult, length = 1, 0
+    while True:
+        b = sock.recv(1)
+        if not b:
+            return None, None
+        length += (b[0] & 0x7F) * mult
+        mult *= 128
+        if not b[0] & 0x80:
+            break
+    data = b''
+    while len(data) < length:
+        chunk = sock.recv(length - len(data))
+        if not chunk:
+            return None, None
+        data += chunk
+    return hdr[0], data
+
+
+def topic_matches(pattern, topic):
+    p, t = pattern.split('/'), topic.split('/')
+    for i, part in enumerate(p):
+        if part == '#':
+            return True
+        if i >= len(t) or (part != '+' and part != t[i]):
+            return False
+    return len(p) == len(t)
+
+
+class MiniBroker(socketserver.ThreadingTCPServer):
+    allow_reuse_address = True
+    daemon_threads = True
+
+    def __init__(self, addr):
+        super().__init__(addr, BrokerHandler)
+        self.lock = threading.Lock()
+        self.clients = []   # handlers
+        self.retained = {}  # topic -> payload
+
+    def route(self, topic, payload, retain):
+        with self.lock:
+            if retain:
+                if payload:
+                    self.retained[topic] = payload
+                else:
+                    self.retained.pop(topic, None)
+            clients = list(self.clients)
+        for c in clients:
+            if any(topic_matches(s, topic) for s in c.subs):
+                c.send_publish(topic, payload, False)
+
+
+class BrokerHandler(socketserver.BaseRequestHandler):
+    def setup(self):
+        self.subs = []
+        self.will = None
+        self.wlock = threading.Lock()
+        self.request.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+    def send(self, data):
+        with self.wlock:
+            self.request.sendall(data)
+
+    def send_publish(self, topic, payload, retain):
+        body = encode_str(topic) + payload
+        self.send(bytes([0x30 | (1 if retain else 0)]) + encode_len(len(body)) + body)
+
+    def handle(self):
+        broker = self.server
+        clean = False
+        try:
+            while True:
+                hdr, data = read_packet(self.request)
+                if hdr is None:
+                    break
+                kind = hdr >> 4
+                if kind == 1:  # CONNECT
+                    pos = 2 + struct.unpack('!H', data[:2])[0] + 1
+                    flags = data[pos]
+                    pos += 3
+                    pos += 2 + struct.unpack('!H', data[pos:pos + 2])[0]  # client id
+                    if flags & 0x04:
+                        tl = struct.unpack('!H', data[pos:pos + 2])[0]
+                        wt = data[pos + 2:pos + 2 + tl].decode()
+                        pos += 2 + tl
+                        ml = struct.unpack('!H', data[pos:pos + 2])[0]
+                        self.will = (wt, data[pos + 2:pos + 2 + ml], bool(flags & 0x20))
+                    self.send(b'\x20\x02\x00\x00')
+                    with broker.lock:
+                        broker.clients.append(self)
+                elif kind == 3:  # PUBLISH (QoS 0 only)
+                    tl = struct.unpack('!H', data[:2])[0]
+                    topic = data[2:2 + tl].decode()
+                    broker.route(topic, data[2 + tl:], bool(hdr & 0x01))
+                elif kind == 8:  # SUBSCRIBE
+                    pid, pos, granted, new = data[:2], 2, b'', []
+                    while pos < len(data):
+                        tl = struct.unpack('!H', data[pos:pos + 2])[0]
+                        new.append(data[pos + 2:pos + 2 + tl].decode())
+                        pos += 3 + tl
+                        granted += b'\x00'
+                    self.subs += new
+                    self.send(bytes([0x90]) + encode_len(2 + len(granted)) + pid + granted)
+                    with broker.lock:
+                        retained = list(broker.retained.items())
+                    for t, p in retained:
+                        if any(topic_matches(s, t) for s in new):
+                            self.send_publish(t, p, True)
+                elif kind == 10:  # UNSUBSCRIBE
+                    self.send(b'\xb0\x02' + data[:2])
+                elif kind == 12:  # PINGREQ
+                    self.send(b'\xd0\x00')
+                elif kind == 14:  # DISCONNECT
+                    clean = True
+                    break
+        except OSError:
+            pass
+        finally:
+            with broker.lock:
+                if self in broker.clients:
+                    broker.clients.remove(self)
+            if self.will and not clean:
+                broker.route(*self.will)
+
+
+class Client:
+    def __init__(self, host, port, client_id):
+        self.sock = socket.create_connection((host, port))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        body = encode_str('MQTT') + b'\x04\x02' + struct.pack('!H', 60) + encode_str(client_id)
+        self.sock.sendall(b'\x10' + encode_len(len(body)) + body)
+        read_packet(self.sock)  # CONNACK
+
+    def subscribe(self, topic):
+        body = struct.pack('!H', 1) + encode_str(topic) + b'\x00'
+        self.sock.sendall(b'\x82' + encode_len(len(body)) + body)
+
+    def publish(self, topic, payload):
+        body = encode_str(topic) + payload.encode()
+        self.sock.sendall(b'\x30' + encode_len(len(body)) + body)
+
+    def messages(self):
+        while True:
+            hdr, data = read_packet(self.sock)
+            if hdr is None:
+                return
+            if hdr >> 4 == 3:
+                tl = struct.unpack('!H', data[:2])[0]
+                yield data[2:2 + tl].decode(), data[2 + tl:].decode(errors='replace')
+
+
+def simulated_device(host, port, topic):
+    # answers like WLED: brightness from <topic> or <topic>/api, state published on <topic>/g
+    dev = Client(host, port, 'sim-device')
+    dev.subscribe(topic)
+    dev.subscribe(topic + '/api')
+    for t, p in dev.messages():
+        if t == topic + '/api':
+            p = p.split('A=')[1].split('&')[0] if 'A=' in p else p.split(':')[1].strip(' }')
+        dev.publish(topic + '/g', str(int(p)))
+
+
+def measure(host, port, topic, mode, count, timeout):
+    cli = Client(host, port, 'latency-test')
+    cli.subscribe(topic + '/g')
+    received = {}
+    cond = threading.Condition()
+
+    def reader():
+        for t, p in cli.messages():
+            with cond:
+                received[p] = time.perf_counter()
+                cond.notify_all()
+    threading.Thread(target=reader, daemon=True).start()
+    time.sleep(0.5)  # retained state
+
+    rtts, lost = [], 0
+    for i in range(count):
+        value = str(1 + i % 254) if i % 254 else '255'
+        with cond:
+            received.pop(value, None)
+        start = time.perf_counter()
+        if mode == 'api':
+            cli.publish(topic + '/api', 'A=' + value)
+        elif mode == 'json':
+            cli.publish(topic + '/api', '{"bri":%s}' % value)
+        else:
+            cli.publish(topic, value)
+        with cond:
+            if cond.wait_for(lambda: value in received, timeout):
+                rtts.append((received[value] - start) * 1000)
+            else:
+                lost += 1
+    if not rtts:
+        print('no responses (is the device connected to the broker and the topic right?)')
+        return 1
+    rtts.sort()
+    print('%d commands, %d lost: min %.1f ms, median %.1f ms, p95 %.1f ms, max %.1f ms' % (
+        count, lost, rtts[0], statistics.median(rtts), rtts[int(len(rtts) * 0.95) - 1 if len(rtts) > 1 else 0], rtts[-1]))
+    return 0
+
+
+if __name__ == '__main__':
+    ap = argparse.ArgumentParser(description='WLED MQTT round trip latency')
+    ap.add_argument('topic', nargs='?', default='wled/test', help='device topic')
+    ap.add_argument('--broker', help='external broker host (default: built-in broker)')
+    ap.add_argument('--port', type=int, default=1883)
+    ap.add_argument('--mode', choices=['api', 'json', 'bri'], default='api')
+    ap.add_argument('--count', type=int, default=100)
+    ap.add_argument('--timeout', type=float, default=2.0, help='seconds to wait for each response')
+    ap.add_argument('--selftest', action='store_true', help='use simulated device')
+    args = ap.parse_args()
+
+    host = args.broker
+    if not host:
+        broker = MiniBroker(('0.0.0.0', args.port))
+        threading.Thread(target=broker.serve_forever, daemon=True).start()
+        host = '127.0.0.1'
+        if not args.selftest:
+            print('broker listening on port %d, waiting for device...' % args.port)
+            time.sleep(5)
+    if args.selftest:
+        threading.Thread(target=simulated_device, args=(host, args.port, args.topic), daemon=True).start()
+        time.sleep(0.2)
+    raise SystemExit(measure(host, args.port, args.topic, args.mode, args.count, args.timeout))
@@ -8,11 +8,16 @@
 # - first argument - mandatory - IP or hostname of target server
 # - second argument - target type (optional)
 # - third argument - xfer count (for replicated targets) (optional)
+#
+# STATE and BATCH target types POST segment updates and print state updates per second:
+# STATE sends one patch per request to json/state, BATCH sends BATCH_SIZE patches per request to json/batch
 HOST=$1
-declare -n TARGET_STR="${2:-JSON_LARGER}_TARGETS"
+TARGET_TYPE=${2:-JSON_LARGER}
+declare -n TARGET_STR="${TARGET_TYPE}_TARGETS"
 REPLICATE_COUNT=$(("${3:-10}"))
 
 PARALLEL_MAX=${PARALLEL_MAX:-50}
+BATCH_SIZE=$((${BATCH_SIZE:-10}))
 
 CURL_ARGS="--compressed --parallel --parallel-immediate --parallel-max ${PARALLEL_MAX}"
 CURL_PRINT_RESPONSE_ARGS="-w %{http_code}\n"
@@ -28,6 +33,25 @@ read -a JSON_SMALL_TARGETS <<< $(replicate "json/info")
 read -a JSON_LARGE_TARGETS <<< $(replicate "json/si")
 read -a JSON_LARGER_TARGETS <<< $(replicate "json/fxdata")
 read -a INDEX_TARGETS <<< $(replicate "")
+read -a STATE_TARGETS <<< $(replicate "json/state")
+read -a BATCH_TARGETS <<< $(replicate "json/batch")
+
+# State patches to POST
+PATCH='{"seg":[{"id":0,"bri":128,"sx":100}]}'
+UPDATES=0
+case "${TARGET_TYPE}" in
+  STATE)
+    POST_DATA=${PATCH}
+    UPDATES=${REPLICATE_COUNT}
+    ;;
+  BATCH)
+    POST_DATA="[$(printf "${PATCH},%.0s" $(seq 2 ${BATCH_SIZE}))${PATCH}]"
+    UPDATES=$((REPLICATE_COUNT * BATCH_SIZE))
+    ;;
+esac
+if [ -n "${POST_DATA}" ]; then
+  CURL_ARGS="${CURL_ARGS} -H Content-Type:application/json -d ${POST_DATA}"
+fi
 
 # Expand target URLS to full arguments for curl
 TARGETS=(${TARGET_STR[@]})
@@ -35,4 +59,11 @@ TARGETS=(${TARGET_STR[@]})
 FULL_TGT_OPTIONS=$(printf "http://${HOST}/%s -o /dev/null " "${TARGETS[@]}")
 #echo ${FULL_TGT_OPTIONS}
 
+START=$(date +%s.%N)
 time curl ${CURL_ARGS} ${FULL_TGT_OPTIONS}
+END=$(date +%s.%N)
+
+if [ ${UPDATES} -gt 0 ]; then
+  awk -v n=${UPDATES} -v r=${REPLICATE_COUNT} -v s=${START} -v e=${END} \
+    'BEGIN { t = e - s; printf "%d requests, %d state updates in %.2fs: %.1f requests/s, %.1f updates/s\n", r, n, t, r / t, n / t }'
+fi
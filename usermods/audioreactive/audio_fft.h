@@ -0,0 +1,393 @@
+#pragma once
+/*
+ * FFT post-processing and fixed-point FFT of the audioreactive usermod
+ *
+ * Shared by FFTcode() and the host test (test/test_audioreactive_fft), so GEQ channels can be checked on the host
+ * against WAV files. The includer declares the settings used here before including this file:
+ *   NUM_GEQ_CHANNELS, SR_FFT_BACKEND, sampleAvg, useBandPassFilter, FFTScalingMode, soundAgc, multAgc, sampleGain,
+ *   inputLevel, decayTime, limiterOn, maxVol, binNum, timeOfPeak, millis(), mapf() and constrain()
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+// FFT Constants
+constexpr uint16_t samplesFFT = 512;            // Samples in an FFT batch - This value MUST ALWAYS be a power of 2
+constexpr uint16_t samplesFFT_2 = 256;          // meaningfull part of FFT results - only the "lower half" contains useful information.
+// the following are observed values, supported by a bit of "educated guessing"
+//#define FFT_DOWNSCALE 0.65f                             // 20kHz - downscaling factor for FFT results - "Flat-Top" window @20Khz, old freq channels
+#define FFT_DOWNSCALE 0.46f                             // downscaling factor for FFT results - for "Flat-Top" window @22Khz, new freq channels
+#define LOG_256  5.54517744f                            // log(256)
+
+// These are the input and output vectors.  Input vectors receive computed results from FFT.
+static float* vReal = nullptr;                  // FFT sample inputs / freq output -  these are our raw result bins
+static float* vImag = nullptr;                  // imaginary parts
+
+// Table of multiplication factors so that we can even out the frequency response.
+static float fftResultPink[NUM_GEQ_CHANNELS] = { 1.70f, 1.71f, 1.73f, 1.78f, 1.68f, 1.56f, 1.55f, 1.63f, 1.79f, 1.62f, 1.80f, 2.06f, 2.47f, 3.35f, 6.83f, 9.55f };
+
+// FFT Task variables (filtering and post-processing)
+static float   fftCalc[NUM_GEQ_CHANNELS] = {0.0f};                    // Try and normalize fftBin values to a max of 4096, so that 4096/16 = 256.
+static float   fftAvg[NUM_GEQ_CHANNELS] = {0.0f};                     // Calculated frequency channel results, with smoothing (used if dynamics limiter is ON)
+
+#if SR_FFT_BACKEND > 0
+// flat-top window weight of sample i (i < samplesFFT/2, window is symmetric) - same coefficients as ArduinoFFT FFTWindow::Flat_top
+static float fftFlatTop(int i) {
+  float ratio = float(i) / float(samplesFFT - 1);
+  return 0.2810639f - 0.5208972f * cosf(2.0f * float(M_PI) * ratio) + 0.1980399f * cosf(4.0f * float(M_PI) * ratio);
+}
+#endif
+
+#if SR_FFT_BACKEND == 1
+// Fixed-point FFT: int16 samples, window and twiddles (Q15) with block floating point scaling, 32bit products.
+// Converting samples from and magnitudes to float is done on the IEEE 754 bit patterns, so no floating point
+// operations (soft-float calls on -S2 and -C3) are left per sample or bin. Tables are computed once with float.
+static int16_t* fftWindowQ15 = nullptr;         // flat-top window, first half (window is symmetric), Q15
+static int16_t* fftCosQ15 = nullptr;            // cos(2*pi*k/samplesFFT), Q15 - sin() is taken from the same table
+static uint8_t* fftDigitRev = nullptr;          // base-4 digit reversal of 0 ... samplesFFT/2-1
+static int16_t* fftWork = nullptr;              // work buffer for fftFixedCompute(), interleaved complex int16
+
+constexpr uint16_t fftPoints = samplesFFT / 2;  // real-valued input is packed into a complex FFT of half size
+static_assert(fftPoints == 256, "fixed-point FFT needs samplesFFT = 512 (complex FFT size must be a power of 4)");
+constexpr int32_t fftStageMax = 5791;           // a radix-4 butterfly grows values by up to 4*sqrt(2): 5791 * 5.66 < 32768
+
+// precompute window, twiddle and reordering tables; returns false if out of memory
+static bool fftFixedInit(void) {
+  if (fftWindowQ15 == nullptr) fftWindowQ15 = (int16_t*) malloc(sizeof(int16_t) * samplesFFT_2);
+  if (fftCosQ15 == nullptr)    fftCosQ15    = (int16_t*) malloc(sizeof(int16_t) * samplesFFT);
+  if (fftDigitRev == nullptr)  fftDigitRev  = (uint8_t*) malloc(sizeof(uint8_t) * fftPoints);
+  if (fftWork == nullptr)      fftWork      = (int16_t*) malloc(sizeof(int16_t) * samplesFFT);
+  if ((fftWindowQ15 == nullptr) || (fftCosQ15 == nullptr) || (fftDigitRev == nullptr) || (fftWork == nullptr)) return false;
+
+  for (int i = 0; i < samplesFFT_2; i++) fftWindowQ15[i] = constrain(lrintf(fftFlatTop(i) * 32768.0f), -32767L, 32767L);
+  for (int i = 0; i < samplesFFT; i++) {
+    fftCosQ15[i] = constrain(lrintf(cosf(2.0f * float(M_PI) * float(i) / float(samplesFFT)) * 32768.0f), -32767L, 32767L);
+  }
+  for (int i = 0; i < fftPoints; i++) {
+    unsigned rev = 0;
+    for (int n = i, d = 1; d < fftPoints; d *= 4, n /= 4) rev = (rev * 4) + (n % 4);
+    fftDigitRev[i] = rev;
+  }
+  return true;
+}
+
+// twiddle factor W^k = cos(2*pi*k/samplesFFT) - j*sin(2*pi*k/samplesFFT), 0 <= k < samplesFFT
+#define FFT_COS(k) (fftCosQ15[(k)])
+#define FFT_SIN(k) (fftCosQ15[((k) + 3*samplesFFT/4) % samplesFFT])
+
+static inline int32_t fftShiftRound(int32_t v, unsigned shift) { return shift ? (v + (1L << (shift-1))) >> shift : v; }
+
+// radix-4 decimation-in-frequency FFT, in place on interleaved int16 data (re, im). Output is in digit-reversed order.
+// Returns the number of bits the data was scaled down by (block floating point exponent).
+static unsigned fftFixedRadix4(int16_t *data) {
+  unsigned exponent = 0;
+  for (unsigned span = fftPoints; span >= 4; span /= 4) {
+    int32_t maxAbs = 0;
+    for (unsigned i = 0; i < 2*fftPoints; i++) {
+      const int32_t v = abs(data[i]);
+      if (v > maxAbs) maxAbs = v;
+    }
+    unsigned shift = 0;
+    while ((maxAbs >> shift) > fftStageMax) shift++;
+    if (shift) for (unsigned i = 0; i < 2*fftPoints; i++) data[i] = fftShiftRound(data[i], shift);
+    exponent += shift;
+
+    const unsigned quarter = span / 4;
+    const unsigned twStep = 2 * (fftPoints / span);  // W(span)^j = W(samplesFFT)^(j * samplesFFT/span)
+    for (unsigned j = 0; j < quarter; j++) {
+      const unsigned k1 = j * twStep, k2 = 2 * k1, k3 = 3 * k1;
+      const int32_t c1 = FFT_COS(k1), s1 = FFT_SIN(k1);
+      const int32_t c2 = FFT_COS(k2), s2 = FFT_SIN(k2);
+      const int32_t c3 = FFT_COS(k3), s3 = FFT_SIN(k3);
+      for (unsigned base = j; base < fftPoints; base += span) {
+        int16_t *a = data + 2*base;
+        int16_t *b = a + 2*quarter;
+        int16_t *c = b + 2*quarter;
+        int16_t *d = c + 2*quarter;
+        const int32_t t0r = a[0] + c[0], t0i = a[1] + c[1];
+        const int32_t t1r = a[0] - c[0], t1i = a[1] - c[1];
+        const int32_t t2r = b[0] + d[0], t2i = b[1] + d[1];
+        const int32_t t3r = b[0] - d[0], t3i = b[1] - d[1];
+        a[0] = t0r + t2r; a[1] = t0i + t2i;
+        int32_t yr = t1r + t3i, yi = t1i - t3r;                 // X(4k+1) = t1 - j*t3
+        b[0] = (yr * c1 + yi * s1 + 16384) >> 15;
+        b[1] = (yi * c1 - yr * s1 + 16384) >> 15;
+        yr = t0r - t2r; yi = t0i - t2i;                          // X(4k+2) = t0 - t2
+        c[0] = (yr * c2 + yi * s2 + 16384) >> 15;
+        c[1] = (yi * c2 - yr * s2 + 16384) >> 15;
+        yr = t1r - t3i; yi = t1i + t3r;                          // X(4k+3) = t1 + j*t3
+        d[0] = (yr * c3 + yi * s3 + 16384) >> 15;
+        d[1] = (yi * c3 - yr * s3 + 16384) >> 15;
+      }
+    }
+  }
+  return exponent;
+}
+
+// m * 2^e as float, assembled from integer fields
+static inline float fftMakeFloat(uint32_t m, int e) {
+  if (m == 0) return 0.0f;
+  const int n = 31 - __builtin_clz(m);                        // m is in [2^n, 2^(n+1))
+  const int biased = n + e + 127;
+  if (biased <= 0) return 0.0f;
+  const uint32_t mant = (n > 23) ? (m >> (n - 23)) : (m << (23 - n));
+  const uint32_t bits = biased >= 255 ? 0x7F7FFFFFUL : (uint32_t(biased) << 23) | (mant & 0x7FFFFFUL);
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+// integer square root of a value in [2^30, 2^32), 16 bit result
+static inline uint32_t fftSqrt32(uint32_t v) {
+  uint32_t root = 0;
+  for (uint32_t bit = 1UL << 30; bit; bit >>= 2) {
+    if (v >= root + bit) { v -= root + bit; root = (root >> 1) + bit; }
+    else root >>= 1;
+  }
+  return root;
+}
+
+// IEEE 754 bit pattern of sample i (copied, samples[] is only accessed as float)
+static inline uint32_t fftSampleBits(const float *samples, int i) {
+  static_assert(sizeof(float) == sizeof(uint32_t), "samples are read as IEEE 754 bit patterns");
+  uint32_t bits;
+  memcpy(&bits, samples + i, sizeof(bits));
+  return bits;
+}
+
+// sample bits to fixed point with the common exponent of the block (largest sample gets 21 bits)
+static inline int32_t fftSampleFixed(uint32_t b, unsigned maxExp) {
+  const unsigned e = min(unsigned((b >> 23) & 0xFF), maxExp);
+  const unsigned shift = 3 + maxExp - e;
+  const int32_t v = (e == 0 || shift > 24) ? 0 : int32_t((((b & 0x7FFFFFUL) | 0x800000UL) >> shift));
+  return (b & 0x80000000UL) ? -v : v;
+}
+
+// fixed-point replacement for ArduinoFFT dcRemoval() + windowing(Flat_top) + compute() + complexToMagnitude()
+// magnitudes are returned in samples[]. work must provide space for samplesFFT int16 values (i.e. fftWork).
+static void fftFixedCompute(float *samples, int16_t *work) {
+  // common exponent of the block, so DC sum and removal stay within 32 bits
+  unsigned maxExp = 0;
+  for (int i = 0; i < samplesFFT; i++) maxExp = max(maxExp, unsigned((fftSampleBits(samples, i) >> 23) & 0xFF));
+  if (maxExp == 0) { memset(samples, 0, samplesFFT * sizeof(float)); return; } // silence (or denormals)
+  if (maxExp > 254) maxExp = 254;                             // inf/NaN are clamped
+  int exponent = int(maxExp) - 147;                           // value = fixed * 2^exponent
+  // samples are converted again in each pass instead of keeping 32 bit copies (a few integer operations each)
+  int32_t sum = 0;
+  for (int i = 0; i < samplesFFT; i++) sum += fftSampleFixed(fftSampleBits(samples, i), maxExp);
+  const int32_t mean = sum / samplesFFT;                      // DC removal
+  int32_t maxAbs = 0;
+  for (int i = 0; i < samplesFFT; i++) {
+    int32_t v = fftSampleFixed(fftSampleBits(samples, i), maxExp) - mean;
+    if (v < 0) v = -v;
+    if (v > maxAbs) maxAbs = v;
+  }
+  unsigned shift = 0;                                         // reduce to int16
+  while ((maxAbs >> shift) > 32767) shift++;
+  exponent += shift;
+  for (int i = 0; i < samplesFFT_2; i++) {
+    const int32_t w = fftWindowQ15[i];
+    const int j = samplesFFT - 1 - i;
+    work[i] = (fftShiftRound(fftSampleFixed(fftSampleBits(samples, i), maxExp) - mean, shift) * w + 16384) >> 15;
+    work[j] = (fftShiftRound(fftSampleFixed(fftSampleBits(samples, j), maxExp) - mean, shift) * w + 16384) >> 15;
+  }
+
+  // real input x[] is interpreted as complex z[n] = x[2n] + j*x[2n+1], n < samplesFFT/2
+  exponent += fftFixedRadix4(work);
+
+  // split Z[] into the spectrum of x[]: X[k] = (Z[k] + Z*[N/2-k])/2 - j/2 * W^k * (Z[k] - Z*[N/2-k])
+  for (int k = 0; k <= samplesFFT_2; k++) {
+    const int16_t *za = work + 2 * fftDigitRev[k % fftPoints];
+    const int16_t *zb = work + 2 * fftDigitRev[(fftPoints - k) % fftPoints];
+    const int32_t er = (za[0] + zb[0]) / 2, ei = (za[1] - zb[1]) / 2;   // even part
+    const int32_t odr = (za[0] - zb[0]) / 2, odi = (za[1] + zb[1]) / 2;  // odd part
+    const int32_t c = FFT_COS(k), s = FFT_SIN(k);
+    int32_t xr = er + ((odi * c - odr * s + 16384) >> 15);
+    int32_t xi = ei - ((odr * c + odi * s + 16384) >> 15);
+    int magExp = exponent;
+    if (xr > 46340 || xr < -46340 || xi > 46340 || xi < -46340) { xr /= 2; xi /= 2; magExp++; } // xr^2 + xi^2 must fit into 32 bits
+    uint32_t mag2 = uint32_t(xr * xr) + uint32_t(xi * xi);
+    if (mag2) while (mag2 < (1UL << 30)) { mag2 <<= 2; magExp--; }      // normalize for a 16 bit root
+    samples[k] = fftMakeFloat(fftSqrt32(mag2), magExp);
+  }
+  for (int k = samplesFFT_2 + 1; k < samplesFFT; k++) samples[k] = samples[samplesFFT - k];  // mirror, like ArduinoFFT
+}
+#endif
+
+// compute average of several FFT result bins
+static float fftAddAvg(int from, int to) {
+  float result = 0.0f;
+  for (int i = from; i <= to; i++) {
+    result += vReal[i];
+  }
+  return result / float(to - from + 1);
+}
+
+// mapping of FFT result bins (magnitudes in vReal[]) to frequency channels (fftCalc[])
+static void fftResultsToChannels(void) {
+    for (int i = 0; i < samplesFFT; i++) {
+      float t = fabsf(vReal[i]);                      // just to be sure - values in fft bins should be positive any way
+      vReal[i] = t / 16.0f;                           // Reduce magnitude. Want end result to be scaled linear and ~4096 max.
+    } // for()
+
+    // mapping of FFT result bins to frequency channels
+    if (fabsf(sampleAvg) > 0.5f) { // noise gate open
+#if 0
+    /* This FFT post processing is a DIY endeavour. What we really need is someone with sound engineering expertise to do a great job here AND most importantly, that the animations look GREAT as a result.
+    *
+    * Andrew's updated mapping of 256 bins down to the 16 result bins with Sample Freq = 10240, samplesFFT = 512 and some overlap.
+    * Based on testing, the lowest/Start frequency is 60 Hz (with bin 3) and a highest/End frequency of 5120 Hz in bin 255.
+    * Now, Take the 60Hz and multiply by 1.320367784 to get the next frequency and so on until the end. Then determine the bins.
+    * End frequency = Start frequency * multiplier ^ 16
+    * Multiplier = (End frequency/ Start frequency) ^ 1/16
+    * Multiplier = 1.320367784
+    */                                    //  Range
+      fftCalc[ 0] = fftAddAvg(2,4);       // 60 - 100
+      fftCalc[ 1] = fftAddAvg(4,5);       // 80 - 120
+      fftCalc[ 2] = fftAddAvg(5,7);       // 100 - 160
+      fftCalc[ 3] = fftAddAvg(7,9);       // 140 - 200
+      fftCalc[ 4] = fftAddAvg(9,12);      // 180 - 260
+      fftCalc[ 5] = fftAddAvg(12,16);     // 240 - 340
+      fftCalc[ 6] = fftAddAvg(16,21);     // 320 - 440
+      fftCalc[ 7] = fftAddAvg(21,29);     // 420 - 600
+      fftCalc[ 8] = fftAddAvg(29,37);     // 580 - 760
+      fftCalc[ 9] = fftAddAvg(37,48);     // 740 - 980
+      fftCalc[10] = fftAddAvg(48,64);     // 960 - 1300
+      fftCalc[11] = fftAddAvg(64,84);     // 1280 - 1700
+      fftCalc[12] = fftAddAvg(84,111);    // 1680 - 2240
+      fftCalc[13] = fftAddAvg(111,147);   // 2220 - 2960
+      fftCalc[14] = fftAddAvg(147,194);   // 2940 - 3900
+      fftCalc[15] = fftAddAvg(194,250);   // 3880 - 5000 // avoid the last 5 bins, which are usually inaccurate
+#else
+      /* new mapping, optimized for 22050 Hz by softhack007 */
+                                                    // bins frequency  range
+      if (useBandPassFilter) {
+        // skip frequencies below 100hz
+        fftCalc[ 0] = 0.8f * fftAddAvg(3,4);
+        fftCalc[ 1] = 0.9f * fftAddAvg(4,5);
+        fftCalc[ 2] = fftAddAvg(5,6);
+        fftCalc[ 3] = fftAddAvg(6,7);
+        // don't use the last bins from 206 to 255.
+        fftCalc[15] = fftAddAvg(165,205) * 0.75f;   // 40 7106 - 8828 high             -- with some damping
+      } else {
+        fftCalc[ 0] = fftAddAvg(1,2);               // 1    43 - 86   sub-bass
+        fftCalc[ 1] = fftAddAvg(2,3);               // 1    86 - 129  bass
+        fftCalc[ 2] = fftAddAvg(3,5);               // 2   129 - 216  bass
+        fftCalc[ 3] = fftAddAvg(5,7);               // 2   216 - 301  bass + midrange
+        // don't use the last bins from 216 to 255. They are usually contaminated by aliasing (aka noise)
+        fftCalc[15] = fftAddAvg(165,215) * 0.70f;   // 50 7106 - 9259 high             -- with some damping
+      }
+      fftCalc[ 4] = fftAddAvg(7,10);                // 3   301 - 430  midrange
+      fftCalc[ 5] = fftAddAvg(10,13);               // 3   430 - 560  midrange
+      fftCalc[ 6] = fftAddAvg(13,19);               // 5   560 - 818  midrange
+      fftCalc[ 7] = fftAddAvg(19,26);               // 7   818 - 1120 midrange -- 1Khz should always be the center !
+      fftCalc[ 8] = fftAddAvg(26,33);               // 7  1120 - 1421 midrange
+      fftCalc[ 9] = fftAddAvg(33,44);               // 9  1421 - 1895 midrange
+      fftCalc[10] = fftAddAvg(44,56);               // 12 1895 - 2412 midrange + high mid
+      fftCalc[11] = fftAddAvg(56,70);               // 14 2412 - 3015 high mid
+      fftCalc[12] = fftAddAvg(70,86);               // 16 3015 - 3704 high mid
+      fftCalc[13] = fftAddAvg(86,104);              // 18 3704 - 4479 high mid
+      fftCalc[14] = fftAddAvg(104,165) * 0.88f;     // 61 4479 - 7106 high mid + high  -- with slight damping
+#endif
+    } else {  // noise gate closed - just decay old values
+      for (int i=0; i < NUM_GEQ_CHANNELS; i++) {
+        fftCalc[i] *= 0.85f;  // decay to zero
+        if (fftCalc[i] < 4.0f) fftCalc[i] = 0.0f;
+      }
+    }
+}
+
+static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels, uint8_t *geqResult) // post-processing and post-amp of GEQ channels
+{
+    for (int i=0; i < numberOfChannels; i++) {
+
+      if (noiseGateOpen) { // noise gate open
+        // Adjustment for frequency curves.
+        fftCalc[i] *= fftResultPink[i];
+        if (FFTScalingMode > 0) fftCalc[i] *= FFT_DOWNSCALE;  // adjustment related to FFT windowing function
+        // Manual linear adjustment of gain using sampleGain adjustment for different input types.
+        fftCalc[i] *= soundAgc ? multAgc : ((float)sampleGain/40.0f * (float)inputLevel/128.0f + 1.0f/16.0f); //apply gain, with inputLevel adjustment
+        if(fftCalc[i] < 0) fftCalc[i] = 0;
+      }
+
+      // smooth results - rise fast, fall slower
+      if(fftCalc[i] > fftAvg[i])   // rise fast
+        fftAvg[i] = fftCalc[i] *0.75f + 0.25f*fftAvg[i];  // will need approx 2 cycles (50ms) for converging against fftCalc[i]
+      else {                       // fall slow
+        if (decayTime < 1000) fftAvg[i] = fftCalc[i]*0.22f + 0.78f*fftAvg[i];       // approx  5 cycles (225ms) for falling to zero
+        else if (decayTime < 2000) fftAvg[i] = fftCalc[i]*0.17f + 0.83f*fftAvg[i];  // default - approx  9 cycles (225ms) for falling to zero
+        else if (decayTime < 3000) fftAvg[i] = fftCalc[i]*0.14f + 0.86f*fftAvg[i];  // approx 14 cycles (350ms) for falling to zero
+        else fftAvg[i] = fftCalc[i]*0.1f  + 0.9f*fftAvg[i];                         // approx 20 cycles (500ms) for falling to zero
+      }
+      // constrain internal vars - just to be sure
+      fftCalc[i] = constrain(fftCalc[i], 0.0f, 1023.0f);
+      fftAvg[i] = constrain(fftAvg[i], 0.0f, 1023.0f);
+
+      float currentResult;
+      if(limiterOn == true)
+        currentResult = fftAvg[i];
+      else
+        currentResult = fftCalc[i];
+
+      switch (FFTScalingMode) {
+        case 1:
+            // Logarithmic scaling
+            currentResult *= 0.42f;                      // 42 is the answer ;-)
+            currentResult -= 8.0f;                       // this skips the lowest row, giving some room for peaks
+            if (currentResult > 1.0f) currentResult = logf(currentResult); // log to base "e", which is the fastest log() function
+            else currentResult = 0.0f;                   // special handling, because log(1) = 0; log(0) = undefined
+            currentResult *= 0.85f + (float(i)/18.0f);  // extra up-scaling for high frequencies
+            currentResult = mapf(currentResult, 0, LOG_256, 0, 255); // map [log(1) ... log(255)] to [0 ... 255]
+        break;
+        case 2:
+            // Linear scaling
+            currentResult *= 0.30f;                     // needs a bit more damping, get stay below 255
+            currentResult -= 4.0f;                       // giving a bit more room for peaks
+            if (currentResult < 1.0f) currentResult = 0.0f;
+            currentResult *= 0.85f + (float(i)/1.8f);   // extra up-scaling for high frequencies
+        break;
+        case 3:
+            // square root scaling
+            currentResult *= 0.38f;
+            currentResult -= 6.0f;
+            if (currentResult > 1.0f) currentResult = sqrtf(currentResult);
+            else currentResult = 0.0f;                   // special handling, because sqrt(0) = undefined
+            currentResult *= 0.85f + (float(i)/4.5f);   // extra up-scaling for high frequencies
+            currentResult = mapf(currentResult, 0.0, 16.0, 0.0, 255.0); // map [sqrt(1) ... sqrt(256)] to [0 ... 255]
+        break;
+
+        case 0:
+        default:
+            // no scaling - leave freq bins as-is
+            currentResult -= 4; // just a bit more room for peaks
+        break;
+      }
+
+      // Now, let's dump it all into geqResult. Need to do this, otherwise other routines might grab values prematurely.
+      if (soundAgc > 0) {  // apply extra "GEQ Gain" if set by user
+        float post_gain = (float)inputLevel/128.0f;
+        if (post_gain < 1.0f) post_gain = ((post_gain -1.0f) * 0.8f) +1.0f;
+        currentResult *= post_gain;
+      }
+      geqResult[i] = constrain((int)currentResult, 0, 255);
+    }
+}
+////////////////////
+// Peak detection //
+////////////////////
+
+// peak detection is called from FFT task when vReal[] contains valid FFT results
+// result is delivered with the next audio frame - samplePeak is set by the reader (AudioReactive::loop())
+static bool detectSamplePeak(void) {
+  bool havePeak = false;
+  // softhack007: this code continuously triggers while amplitude in the selected bin is above a certain threshold. So it does not detect peaks - it detects high activity in a frequency bin.
+  // Poor man's beat detection by seeing if sample > Average + some value.
+  // This goes through ALL of the 255 bins - but ignores stupid settings
+  // Then we got a peak, else we don't. The peak has to time out on its own in order to support UDP sound sync.
+  if ((sampleAvg > 1) && (maxVol > 0) && (binNum > 4) && (vReal[binNum] > maxVol) && ((millis() - timeOfPeak) > 100)) {
+    havePeak = true;
+  }
+
+  return havePeak;
+}
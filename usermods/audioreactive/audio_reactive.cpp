@@ -93,7 +93,7 @@ static uint16_t decayTime = 1400;             // int: decay time in milliseconds
 
 // peak detection
 #ifdef ARDUINO_ARCH_ESP32
-static void detectSamplePeak(void);  // peak detection function (needs scaled FFT results in vReal[]) - no used for 8266 receive-only mode
+static bool detectSamplePeak(void);  // peak detection function (needs scaled FFT results in vReal[]) - no used for 8266 receive-only mode
 #endif
 static void autoResetPeak(void);     // peak auto-reset function
 static uint8_t maxVol = 31;          // (was 10) Reasonable value for constant volume for 'peak detector', as it won't always trigger  (deprecated)
@@ -151,12 +151,36 @@ static bool useBandPassFilter = false;                    // if true, enables a
 static float fftAddAvg(int from, int to);   // average of several FFT result bins
 void FFTcode(void * parameter);      // audio processing task: read samples, run FFT, fill GEQ channels from FFT results
 static void runMicFilter(uint16_t numSamples, float *sampleBuffer);          // pre-filtering of raw samples (band-pass)
-static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels); // post-processing and post-amp of GEQ channels
+static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels, uint8_t *geqResult); // post-processing and post-amp of GEQ channels
 
 static TaskHandle_t FFT_Task = nullptr;
 
-// Table of multiplication factors so that we can even out the frequency response.
-static float fftResultPink[NUM_GEQ_CHANNELS] = { 1.70f, 1.71f, 1.73f, 1.78f, 1.68f, 1.56f, 1.55f, 1.63f, 1.79f, 1.62f, 1.80f, 2.06f, 2.47f, 3.35f, 6.83f, 9.55f };
+// Audio feature frames
+// FFTcode() is the only producer: it fills the next slot of a small ring buffer, and then publishes it by advancing audioFrameSeq.
+// Readers never see half-written results: they copy a frame and verify afterwards that the producer did not wrap around
+// to the same slot meanwhile (seqlock without locks or critical sections). AudioReactive::loop() copies the latest frame into
+// the variables exported via um_data, so all effects of one strip update see the same snapshot.
+#define AUDIO_FRAMES 4                                                // number of frames in ring buffer - must be a power of 2
+typedef struct AudioFrame {
+  unsigned long time;                                                 // millis() when frame was published
+  float   majorPeak;                                                  // strongest (peak) frequency
+  float   magnitude;                                                  // volume (magnitude) of peak frequency - not scaled by multAgc
+  uint8_t geq[NUM_GEQ_CHANNELS];                                      // frequency channels
+  bool    beat;                                                       // peak detected in this frame
+} audioFrame_t;
+static audioFrame_t audioFrames[AUDIO_FRAMES];
+static volatile uint32_t audioFrameSeq = 0;                           // sequence number of last published frame (0 = none yet)
+
+static void publishAudioFrame(float majorPeak, float magnitude, const uint8_t *geq, bool beat);  // called by FFTcode() only
+static bool readAudioFrame(uint32_t seq, audioFrame_t &frame);                                   // false if frame was overwritten
+
+// Overlapping FFT windows: with SR_FFT_OVERLAP, each FFT run reads only half a window of new samples and re-uses the previous half.
+// This doubles the FFT rate (lower latency) at the cost of twice the CPU time - not recommended on -S2 and -C3.
+#ifdef SR_FFT_OVERLAP
+#define FFT_HOP_DIVIDER 2
+#else
+#define FFT_HOP_DIVIDER 1
+#endif
 
 // globals and FFT Output variables shared with animations
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
@@ -165,8 +189,6 @@ static uint64_t sampleTime = 0;
 #endif
 
 // FFT Task variables (filtering and post-processing)
-static float   fftCalc[NUM_GEQ_CHANNELS] = {0.0f};                    // Try and normalize fftBin values to a max of 4096, so that 4096/16 = 256.
-static float   fftAvg[NUM_GEQ_CHANNELS] = {0.0f};                     // Calculated frequency channel results, with smoothing (used if dynamics limiter is ON)
 #ifdef SR_DEBUG
 static float   fftResultMax[NUM_GEQ_CHANNELS] = {0.0f};               // A table used for testing to determine how our post-processing is working.
 #endif
@@ -181,18 +203,6 @@ constexpr SRate_t SAMPLE_RATE = 22050;        // Base sample rate in Hz - 22Khz
 //#define FFT_MIN_CYCLE 23                      // minimum time before FFT task is repeated. Use with 20Khz sampling
 //#define FFT_MIN_CYCLE 46                      // minimum time before FFT task is repeated. Use with 10Khz sampling
 
-// FFT Constants
-constexpr uint16_t samplesFFT = 512;            // Samples in an FFT batch - This value MUST ALWAYS be a power of 2
-constexpr uint16_t samplesFFT_2 = 256;          // meaningfull part of FFT results - only the "lower half" contains useful information.
-// the following are observed values, supported by a bit of "educated guessing"
-//#define FFT_DOWNSCALE 0.65f                             // 20kHz - downscaling factor for FFT results - "Flat-Top" window @20Khz, old freq channels 
-#define FFT_DOWNSCALE 0.46f                             // downscaling factor for FFT results - for "Flat-Top" window @22Khz, new freq channels
-#define LOG_256  5.54517744f                            // log(256)
-
-// These are the input and output vectors.  Input vectors receive computed results from FFT.
-static float* vReal = nullptr;                  // FFT sample inputs / freq output -  these are our raw result bins
-static float* vImag = nullptr;                  // imaginary parts
-
 // Create FFT object
 // lib_deps += https://github.com/kosme/arduinoFFT#develop @ 1.9.2
 // these options actually cause slow-downs on all esp32 processors, don't use them.
@@ -202,16 +212,84 @@ static float* vImag = nullptr;                  // imaginary parts
 // #define sqrt_internal sqrtf          // see https://github.com/kosme/arduinoFFT/pull/83 - since v2.0.0 this must be done in build_flags
 
 #include <arduinoFFT.h>             // FFT object is created in FFTcode
+
+// FFT backend: 0 = ArduinoFFT (float)
+//              1 = fixed-point radix-4 FFT (int16 samples and tables, 32bit butterflies) - for MCUs without FPU (-S2, -C3)
+//              2 = ESP-DSP (float, assembly optimized) - needs arduino-esp32 v2.x
+// ArduinoFFT is always needed, as majorPeak() is used with all backends.
+#ifndef SR_FFT_BACKEND
+  #if defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
+    #define SR_FFT_BACKEND 1
+  #else
+    #define SR_FFT_BACKEND 0
+  #endif
+#endif
+#if (SR_FFT_BACKEND == 2) && !(defined(ESP_ARDUINO_VERSION_MAJOR) && (ESP_ARDUINO_VERSION_MAJOR >= 2))
+  #warning ESP-DSP is not available in this framework - using fixed-point FFT instead.
+  #undef SR_FFT_BACKEND
+  #define SR_FFT_BACKEND 1
+#endif
+#if SR_FFT_BACKEND == 2
+  #include <esp_dsp.h>
+#endif
+#include "audio_fft.h"              // FFT constants, fixed-point FFT and post-processing of FFT results
+
+constexpr uint16_t samplesHop = samplesFFT / FFT_HOP_DIVIDER;   // new samples per FFT run
+#if FFT_HOP_DIVIDER > 1
+static float* sampleWindow = nullptr;           // sliding sample window, keeps the samples that are re-used by the next FFT run
+#endif
+
 // Helper functions
 
-// compute average of several FFT result bins
-static float fftAddAvg(int from, int to) {
-  float result = 0.0f;
-  for (int i = from; i <= to; i++) {
-    result += vReal[i];
+static void publishAudioFrame(float majorPeak, float magnitude, const uint8_t *geq, bool beat) {
+  uint32_t seq = audioFrameSeq + 1;
+  audioFrame_t &frame = audioFrames[seq & (AUDIO_FRAMES-1)];   // slot is not visible to readers until we publish
+  frame.time      = millis();
+  frame.majorPeak = majorPeak;
+  frame.magnitude = magnitude;
+  memcpy(frame.geq, geq, sizeof(frame.geq));
+  frame.beat      = beat;
+  __sync_synchronize();                                        // frame content must be visible on the other core before the new sequence number
+  audioFrameSeq = seq;
+}
+
+static bool readAudioFrame(uint32_t seq, audioFrame_t &frame) {
+  // the producer writes slot seq+AUDIO_FRAMES-1 (same slot) only after it has published seq+AUDIO_FRAMES-2
+  if ((seq == 0) || (audioFrameSeq - seq >= AUDIO_FRAMES-1)) return false;
+  frame = audioFrames[seq & (AUDIO_FRAMES-1)];
+  __sync_synchronize();
+  return (audioFrameSeq - seq < AUDIO_FRAMES-1);               // still valid after copying?
+}
+
+#if SR_FFT_BACKEND == 2
+static float* fftWindow = nullptr;              // flat-top window, first half
+static float* fftComplex = nullptr;             // interleaved complex FFT data (re, im)
+
+static bool fftDspInit(void) {
+  if (fftWindow == nullptr)  fftWindow  = (float*) malloc(sizeof(float) * samplesFFT_2);
+  if (fftComplex == nullptr) fftComplex = (float*) malloc(sizeof(float) * samplesFFT * 2);
+  if ((fftWindow == nullptr) || (fftComplex == nullptr)) return false;
+  for (int i = 0; i < samplesFFT_2; i++) fftWindow[i] = fftFlatTop(i);
+  esp_err_t err = dsps_fft2r_init_fc32(NULL, samplesFFT);
+  return (err == ESP_OK) || (err == ESP_ERR_DSP_REINITIALIZED);
+}
+
+// ESP-DSP replacement for ArduinoFFT dcRemoval() + windowing(Flat_top) + compute() + complexToMagnitude()
+static void fftDspCompute(float *vReal) {
+  float mean = 0.0f;
+  for (int i = 0; i < samplesFFT; i++) mean += vReal[i];
+  mean /= float(samplesFFT);
+  for (int i = 0; i < samplesFFT_2; i++) {
+    const int j = samplesFFT - 1 - i;
+    fftComplex[2*i] = (vReal[i] - mean) * fftWindow[i]; fftComplex[2*i+1] = 0.0f;
+    fftComplex[2*j] = (vReal[j] - mean) * fftWindow[i]; fftComplex[2*j+1] = 0.0f;
   }
-  return result / float(to - from + 1);
+  dsps_fft2r_fc32(fftComplex, samplesFFT);
+  dsps_bit_rev_fc32(fftComplex, samplesFFT);
+  for (int k = 0; k <= samplesFFT_2; k++) vReal[k] = sqrtf(fftComplex[2*k] * fftComplex[2*k] + fftComplex[2*k+1] * fftComplex[2*k+1]);
+  for (int k = samplesFFT_2 + 1; k < samplesFFT; k++) vReal[k] = vReal[samplesFFT - k];  // mirror, like ArduinoFFT
 }
+#endif
 
 //
 // FFT main task
@@ -223,17 +301,33 @@ void FFTcode(void * parameter)
   // allocate FFT buffers on first call
   if (vReal == nullptr) vReal = (float*) calloc(sizeof(float), samplesFFT);
   if (vImag == nullptr) vImag = (float*) calloc(sizeof(float), samplesFFT);
+#if FFT_HOP_DIVIDER > 1
+  if (sampleWindow == nullptr) sampleWindow = (float*) calloc(sizeof(float), samplesFFT);
+  if ((vReal == nullptr) || (vImag == nullptr) || (sampleWindow == nullptr)) {
+    if (sampleWindow) free(sampleWindow); sampleWindow = nullptr;
+#else
   if ((vReal == nullptr) || (vImag == nullptr)) {
+#endif
     // something went wrong
     if (vReal) free(vReal); vReal = nullptr;
     if (vImag) free(vImag); vImag = nullptr;
     return;
   }
+#if SR_FFT_BACKEND == 1
+  if (!fftFixedInit()) return;                  // tables and work buffer
+#elif SR_FFT_BACKEND == 2
+  if (!fftDspInit()) return;
+#endif
   // Create FFT object with weighing factor storage
   ArduinoFFT<float> FFT = ArduinoFFT<float>( vReal, vImag, samplesFFT, SAMPLE_RATE, true);
 
+  // FFT results are private to this task until they get published as audio frame
+  float majorPeak = 1.0f;
+  float magnitude = 0.0f;
+  uint8_t geqResult[NUM_GEQ_CHANNELS] = {0};
+
   // see https://www.freertos.org/vtaskdelayuntil.html
-  const TickType_t xFrequency = FFT_MIN_CYCLE * portTICK_PERIOD_MS;  
+  const TickType_t xFrequency = (FFT_MIN_CYCLE / FFT_HOP_DIVIDER) * portTICK_PERIOD_MS;
 
   TickType_t xLastWakeTime = xTaskGetTickCount();
   for(;;) {
@@ -252,8 +346,16 @@ void FFTcode(void * parameter)
 #endif
 
     // get a fresh batch of samples from I2S
-    if (audioSource) audioSource->getSamples(vReal, samplesFFT);
+#if FFT_HOP_DIVIDER > 1
+    memmove(sampleWindow, sampleWindow + samplesHop, (samplesFFT - samplesHop) * sizeof(float)); // slide window
+    float *newSamples = sampleWindow + (samplesFFT - samplesHop);
+#else
+    float *newSamples = vReal;
+#endif
+    if (audioSource) audioSource->getSamples(newSamples, samplesHop);
+#if SR_FFT_BACKEND == 0
     memset(vImag, 0, samplesFFT * sizeof(float));   // set imaginary parts to 0
+#endif
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
     if (start < esp_timer_get_time()) { // filter out overflows
@@ -267,15 +369,18 @@ void FFTcode(void * parameter)
 
     // band pass filter - can reduce noise floor by a factor of 50
     // downside: frequencies below 100Hz will be ignored
-    if (useBandPassFilter) runMicFilter(samplesFFT, vReal);
+    if (useBandPassFilter) runMicFilter(samplesHop, newSamples);
 
     // find highest sample in the batch
     float maxSample = 0.0f;                         // max sample from FFT batch
-    for (int i=0; i < samplesFFT; i++) {
-	    // pick our  our current mic sample - we take the max value from all samples that go into FFT
-	    if ((vReal[i] <= (INT16_MAX - 1024)) && (vReal[i] >= (INT16_MIN + 1024)))  //skip extreme values - normally these are artefacts
-        if (fabsf((float)vReal[i]) > maxSample) maxSample = fabsf((float)vReal[i]);
+    for (int i=0; i < samplesHop; i++) {
+	    // pick our  our current mic sample - we take the max value from all new samples that go into FFT
+	    if ((newSamples[i] <= (INT16_MAX - 1024)) && (newSamples[i] >= (INT16_MIN + 1024)))  //skip extreme values - normally these are artefacts
+        if (fabsf((float)newSamples[i]) > maxSample) maxSample = fabsf((float)newSamples[i]);
     }
+#if FFT_HOP_DIVIDER > 1
+    memcpy(vReal, sampleWindow, samplesFFT * sizeof(float)); // FFT works in-place, so keep sampleWindow intact
+#endif
     // release highest sample to volume reactive effects early - not strictly necessary here - could also be done at the end of the function
     // early release allows the filters (getSample() and agcAvg()) to work with fresh values - we will have matching gain and noise gate values when we want to process the FFT results.
     micDataReal = maxSample;
@@ -287,15 +392,21 @@ void FFTcode(void * parameter)
 #endif
 
       // run FFT (takes 3-5ms on ESP32, ~12ms on ESP32-S2)
+#if SR_FFT_BACKEND == 1
+      fftFixedCompute(vReal, fftWork);                            // DC removal, "Flat Top" window, FFT and magnitudes in fixed point
+#elif SR_FFT_BACKEND == 2
+      fftDspCompute(vReal);                                       // DC removal, "Flat Top" window, FFT and magnitudes with ESP-DSP
+#else
       FFT.dcRemoval();                                            // remove DC offset
       FFT.windowing( FFTWindow::Flat_top, FFTDirection::Forward); // Weigh data using "Flat Top" function - better amplitude accuracy
       //FFT.windowing(FFTWindow::Blackman_Harris, FFTDirection::Forward);  // Weigh data using "Blackman- Harris" window - sharp peaks due to excellent sideband rejection
       FFT.compute( FFTDirection::Forward );                       // Compute FFT
       FFT.complexToMagnitude();                                   // Compute magnitudes
+#endif
       vReal[0] = 0;   // The remaining DC offset on the signal produces a strong spike on position 0 that should be eliminated to avoid issues.
 
-      FFT.majorPeak(&FFT_MajorPeak, &FFT_Magnitude);                // let the effects know which freq was most dominant
-      FFT_MajorPeak = constrain(FFT_MajorPeak, 1.0f, 11025.0f);   // restrict value to range expected by effects
+      FFT.majorPeak(&majorPeak, &magnitude);                      // let the effects know which freq was most dominant
+      majorPeak = constrain(majorPeak, 1.0f, 11025.0f);           // restrict value to range expected by effects
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
       haveDoneFFT = true;
@@ -303,83 +414,15 @@ void FFTcode(void * parameter)
 
     } else { // noise gate closed - only clear results as FFT was skipped. MIC samples are still valid when we do this.
       memset(vReal, 0, samplesFFT * sizeof(float));
-      FFT_MajorPeak = 1;
-      FFT_Magnitude = 0.001;
+      majorPeak = 1;
+      magnitude = 0.001;
     }
 
-    for (int i = 0; i < samplesFFT; i++) {
-      float t = fabsf(vReal[i]);                      // just to be sure - values in fft bins should be positive any way
-      vReal[i] = t / 16.0f;                           // Reduce magnitude. Want end result to be scaled linear and ~4096 max.
-    } // for()
-
     // mapping of FFT result bins to frequency channels
-    if (fabsf(sampleAvg) > 0.5f) { // noise gate open
-#if 0
-    /* This FFT post processing is a DIY endeavour. What we really need is someone with sound engineering expertise to do a great job here AND most importantly, that the animations look GREAT as a result.
-    *
-    * Andrew's updated mapping of 256 bins down to the 16 result bins with Sample Freq = 10240, samplesFFT = 512 and some overlap.
-    * Based on testing, the lowest/Start frequency is 60 Hz (with bin 3) and a highest/End frequency of 5120 Hz in bin 255.
-    * Now, Take the 60Hz and multiply by 1.320367784 to get the next frequency and so on until the end. Then determine the bins.
-    * End frequency = Start frequency * multiplier ^ 16
-    * Multiplier = (End frequency/ Start frequency) ^ 1/16
-    * Multiplier = 1.320367784
-    */                                    //  Range
-      fftCalc[ 0] = fftAddAvg(2,4);       // 60 - 100
-      fftCalc[ 1] = fftAddAvg(4,5);       // 80 - 120
-      fftCalc[ 2] = fftAddAvg(5,7);       // 100 - 160
-      fftCalc[ 3] = fftAddAvg(7,9);       // 140 - 200
-      fftCalc[ 4] = fftAddAvg(9,12);      // 180 - 260
-      fftCalc[ 5] = fftAddAvg(12,16);     // 240 - 340
-      fftCalc[ 6] = fftAddAvg(16,21);     // 320 - 440
-      fftCalc[ 7] = fftAddAvg(21,29);     // 420 - 600
-      fftCalc[ 8] = fftAddAvg(29,37);     // 580 - 760
-      fftCalc[ 9] = fftAddAvg(37,48);     // 740 - 980
-      fftCalc[10] = fftAddAvg(48,64);     // 960 - 1300
-      fftCalc[11] = fftAddAvg(64,84);     // 1280 - 1700
-      fftCalc[12] = fftAddAvg(84,111);    // 1680 - 2240
-      fftCalc[13] = fftAddAvg(111,147);   // 2220 - 2960
-      fftCalc[14] = fftAddAvg(147,194);   // 2940 - 3900
-      fftCalc[15] = fftAddAvg(194,250);   // 3880 - 5000 // avoid the last 5 bins, which are usually inaccurate
-#else
-      /* new mapping, optimized for 22050 Hz by softhack007 */
-                                                    // bins frequency  range
-      if (useBandPassFilter) {
-        // skip frequencies below 100hz
-        fftCalc[ 0] = 0.8f * fftAddAvg(3,4);
-        fftCalc[ 1] = 0.9f * fftAddAvg(4,5);
-        fftCalc[ 2] = fftAddAvg(5,6);
-        fftCalc[ 3] = fftAddAvg(6,7);
-        // don't use the last bins from 206 to 255. 
-        fftCalc[15] = fftAddAvg(165,205) * 0.75f;   // 40 7106 - 8828 high             -- with some damping
-      } else {
-        fftCalc[ 0] = fftAddAvg(1,2);               // 1    43 - 86   sub-bass
-        fftCalc[ 1] = fftAddAvg(2,3);               // 1    86 - 129  bass
-        fftCalc[ 2] = fftAddAvg(3,5);               // 2   129 - 216  bass
-        fftCalc[ 3] = fftAddAvg(5,7);               // 2   216 - 301  bass + midrange
-        // don't use the last bins from 216 to 255. They are usually contaminated by aliasing (aka noise) 
-        fftCalc[15] = fftAddAvg(165,215) * 0.70f;   // 50 7106 - 9259 high             -- with some damping
-      }
-      fftCalc[ 4] = fftAddAvg(7,10);                // 3   301 - 430  midrange
-      fftCalc[ 5] = fftAddAvg(10,13);               // 3   430 - 560  midrange
-      fftCalc[ 6] = fftAddAvg(13,19);               // 5   560 - 818  midrange
-      fftCalc[ 7] = fftAddAvg(19,26);               // 7   818 - 1120 midrange -- 1Khz should always be the center !
-      fftCalc[ 8] = fftAddAvg(26,33);               // 7  1120 - 1421 midrange
-      fftCalc[ 9] = fftAddAvg(33,44);               // 9  1421 - 1895 midrange
-      fftCalc[10] = fftAddAvg(44,56);               // 12 1895 - 2412 midrange + high mid
-      fftCalc[11] = fftAddAvg(56,70);               // 14 2412 - 3015 high mid
-      fftCalc[12] = fftAddAvg(70,86);               // 16 3015 - 3704 high mid
-      fftCalc[13] = fftAddAvg(86,104);              // 18 3704 - 4479 high mid
-      fftCalc[14] = fftAddAvg(104,165) * 0.88f;     // 61 4479 - 7106 high mid + high  -- with slight damping
-#endif
-    } else {  // noise gate closed - just decay old values
-      for (int i=0; i < NUM_GEQ_CHANNELS; i++) {
-        fftCalc[i] *= 0.85f;  // decay to zero
-        if (fftCalc[i] < 4.0f) fftCalc[i] = 0.0f;
-      }
-    }
+    fftResultsToChannels();
 
     // post-processing of frequency channels (pink noise adjustment, AGC, smoothing, scaling)
-    postProcessFFTResults((fabsf(sampleAvg) > 0.25f)? true : false , NUM_GEQ_CHANNELS);
+    postProcessFFTResults((fabsf(sampleAvg) > 0.25f)? true : false , NUM_GEQ_CHANNELS, geqResult);
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
     if (haveDoneFFT && (start < esp_timer_get_time())) { // filter out overflows
@@ -387,10 +430,9 @@ void FFTcode(void * parameter)
       fftTime  = (fftTimeInMillis*3 + fftTime*7)/10; // smooth
     }
 #endif
-    // run peak detection
-    autoResetPeak();
-    detectSamplePeak();
-    
+    // run peak detection, and hand over results to readers
+    publishAudioFrame(majorPeak, magnitude, geqResult, detectSamplePeak());
+
     #if !defined(I2S_GRAB_ADC1_COMPLETELY)    
     if ((audioSource == nullptr) || (audioSource->getType() != AudioSource::Type_I2SAdc))  // the "delay trick" does not help for analog ADC
     #endif
@@ -435,103 +477,6 @@ static void runMicFilter(uint16_t numSamples, float *sampleBuffer)          // p
   }
 }
 
-static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // post-processing and post-amp of GEQ channels
-{
-    for (int i=0; i < numberOfChannels; i++) {
-
-      if (noiseGateOpen) { // noise gate open
-        // Adjustment for frequency curves.
-        fftCalc[i] *= fftResultPink[i];
-        if (FFTScalingMode > 0) fftCalc[i] *= FFT_DOWNSCALE;  // adjustment related to FFT windowing function
-        // Manual linear adjustment of gain using sampleGain adjustment for different input types.
-        fftCalc[i] *= soundAgc ? multAgc : ((float)sampleGain/40.0f * (float)inputLevel/128.0f + 1.0f/16.0f); //apply gain, with inputLevel adjustment
-        if(fftCalc[i] < 0) fftCalc[i] = 0;
-      }
-
-      // smooth results - rise fast, fall slower
-      if(fftCalc[i] > fftAvg[i])   // rise fast 
-        fftAvg[i] = fftCalc[i] *0.75f + 0.25f*fftAvg[i];  // will need approx 2 cycles (50ms) for converging against fftCalc[i]
-      else {                       // fall slow
-        if (decayTime < 1000) fftAvg[i] = fftCalc[i]*0.22f + 0.78f*fftAvg[i];       // approx  5 cycles (225ms) for falling to zero
-        else if (decayTime < 2000) fftAvg[i] = fftCalc[i]*0.17f + 0.83f*fftAvg[i];  // default - approx  9 cycles (225ms) for falling to zero
-        else if (decayTime < 3000) fftAvg[i] = fftCalc[i]*0.14f + 0.86f*fftAvg[i];  // approx 14 cycles (350ms) for falling to zero
-        else fftAvg[i] = fftCalc[i]*0.1f  + 0.9f*fftAvg[i];                         // approx 20 cycles (500ms) for falling to zero
-      }
-      // constrain internal vars - just to be sure
-      fftCalc[i] = constrain(fftCalc[i], 0.0f, 1023.0f);
-      fftAvg[i] = constrain(fftAvg[i], 0.0f, 1023.0f);
-
-      float currentResult;
-      if(limiterOn == true)
-        currentResult = fftAvg[i];
-      else
-        currentResult = fftCalc[i];
-
-      switch (FFTScalingMode) {
-        case 1:
-            // Logarithmic scaling
-            currentResult *= 0.42f;                      // 42 is the answer ;-)
-            currentResult -= 8.0f;                       // this skips the lowest row, giving some room for peaks
-            if (currentResult > 1.0f) currentResult = logf(currentResult); // log to base "e", which is the fastest log() function
-            else currentResult = 0.0f;                   // special handling, because log(1) = 0; log(0) = undefined
-            currentResult *= 0.85f + (float(i)/18.0f);  // extra up-scaling for high frequencies
-            currentResult = mapf(currentResult, 0, LOG_256, 0, 255); // map [log(1) ... log(255)] to [0 ... 255]
-        break;
-        case 2:
-            // Linear scaling
-            currentResult *= 0.30f;                     // needs a bit more damping, get stay below 255
-            currentResult -= 4.0f;                       // giving a bit more room for peaks
-            if (currentResult < 1.0f) currentResult = 0.0f;
-            currentResult *= 0.85f + (float(i)/1.8f);   // extra up-scaling for high frequencies
-        break;
-        case 3:
-            // square root scaling
-            currentResult *= 0.38f;
-            currentResult -= 6.0f;
-            if (currentResult > 1.0f) currentResult = sqrtf(currentResult);
-            else currentResult = 0.0f;                   // special handling, because sqrt(0) = undefined
-            currentResult *= 0.85f + (float(i)/4.5f);   // extra up-scaling for high frequencies
-            currentResult = mapf(currentResult, 0.0, 16.0, 0.0, 255.0); // map [sqrt(1) ... sqrt(256)] to [0 ... 255]
-        break;
-
-        case 0:
-        default:
-            // no scaling - leave freq bins as-is
-            currentResult -= 4; // just a bit more room for peaks
-        break;
-      }
-
-      // Now, let's dump it all into fftResult. Need to do this, otherwise other routines might grab fftResult values prematurely.
-      if (soundAgc > 0) {  // apply extra "GEQ Gain" if set by user
-        float post_gain = (float)inputLevel/128.0f;
-        if (post_gain < 1.0f) post_gain = ((post_gain -1.0f) * 0.8f) +1.0f;
-        currentResult *= post_gain;
-      }
-      fftResult[i] = constrain((int)currentResult, 0, 255);
-    }
-}
-////////////////////
-// Peak detection //
-////////////////////
-
-// peak detection is called from FFT task when vReal[] contains valid FFT results
-static void detectSamplePeak(void) {
-  bool havePeak = false;
-  // softhack007: this code continuously triggers while amplitude in the selected bin is above a certain threshold. So it does not detect peaks - it detects high activity in a frequency bin.
-  // Poor man's beat detection by seeing if sample > Average + some value.
-  // This goes through ALL of the 255 bins - but ignores stupid settings
-  // Then we got a peak, else we don't. The peak has to time out on its own in order to support UDP sound sync.
-  if ((sampleAvg > 1) && (maxVol > 0) && (binNum > 4) && (vReal[binNum] > maxVol) && ((millis() - timeOfPeak) > 100)) {
-    havePeak = true;
-  }
-
-  if (havePeak) {
-    samplePeak    = true;
-    timeOfPeak    = millis();
-    udpSamplePeak = true;
-  }
-}
-
 #endif
 
 static void autoResetPeak(void) {
@@ -648,6 +593,13 @@ class AudioReactive : public Usermod {
     float    sampleReal = 0.0f;	  // "sampleRaw" as float, to provide bits that are lost otherwise (before amplification by sampleGain or inputLevel). Needed for AGC.
     int16_t  sampleRaw = 0;       // Current sample. Must only be updated ONCE!!! (amplified mic value by sampleGain and inputLevel)
     int16_t  rawSampleAgc = 0;    // not smoothed AGC sample
+
+    // audio frames received from FFTcode()
+    uint32_t     lastFrameSeq = 0;        // sequence number of last consumed frame
+    audioFrame_t prevFrame = {0};         // previous frame - start point for interpolation
+    audioFrame_t currFrame = {0};         // latest frame
+    bool         frameSettled = true;     // true when exported values match currFrame (no interpolation pending)
+    bool         interpolateFrames = false; // smooth GEQ channels between two FFT runs, adds one FFT cycle of latency (config value)
 #endif
 
     // variables used in effects
@@ -931,6 +883,55 @@ class AudioReactive : public Usermod {
       sampleAvg = fabsf(sampleAvg);                            // make sure we have a positive value
     } // getSample()
 
+    /* Consumes audio frames published by FFTcode(), and updates the variables exported to effects
+     * (fftResult, FFT_MajorPeak, FFT_Magnitude, samplePeak) from one consistent frame.
+     * Beats are collected from all frames received since the last call, so peaks are not lost when loop() is slow.
+     */
+    void readAudioFrames(void)
+    {
+      uint32_t newest = audioFrameSeq;
+      bool newFrame = false;
+      bool beat = false;
+      if (newest - lastFrameSeq >= AUDIO_FRAMES-1) lastFrameSeq = newest - 1; // fell behind - older frames are being overwritten
+      while (lastFrameSeq != newest) {
+        audioFrame_t frame;
+        if (!readAudioFrame(lastFrameSeq + 1, frame)) {  // overtaken by FFT task while copying - skip ahead
+          newest = audioFrameSeq;
+          lastFrameSeq = newest - 1;
+          continue;
+        }
+        lastFrameSeq++;
+        prevFrame = currFrame;
+        currFrame = frame;
+        beat |= frame.beat;
+        newFrame = true;
+      }
+
+      if (newFrame) {
+        if (beat) {
+          samplePeak    = true;
+          timeOfPeak    = currFrame.time;
+          udpSamplePeak = true;
+        }
+        FFT_MajorPeak = currFrame.majorPeak;
+        frameSettled = false;
+      }
+      if (frameSettled) return;
+
+      unsigned long frameTime = currFrame.time - prevFrame.time;
+      unsigned long elapsed   = millis() - currFrame.time;
+      if (!interpolateFrames || (elapsed >= frameTime) || (frameTime > 4*FFT_MIN_CYCLE)) {
+        memcpy(fftResult, currFrame.geq, sizeof(fftResult));
+        FFT_Magnitude = currFrame.magnitude;
+        frameSettled = true;
+      } else {
+        // linear interpolation from previous to current frame, finishes when the next frame is due
+        for (int i = 0; i < NUM_GEQ_CHANNELS; i++)
+          fftResult[i] = prevFrame.geq[i] + ((int(currFrame.geq[i]) - int(prevFrame.geq[i])) * int(elapsed)) / int(frameTime);
+        FFT_Magnitude = prevFrame.magnitude + (currFrame.magnitude - prevFrame.magnitude) * float(elapsed) / float(frameTime);
+      }
+    }
+
 #endif
 
     /* Limits the dynamics of volumeSmth (= sampleAvg or sampleAgc). 
@@ -1359,6 +1360,8 @@ class AudioReactive : public Usermod {
         } while (userloopDelay > 0);
         lastUMRun = t_now;                    // update time keeping
 
+        readAudioFrames();                    // pick up FFT results
+
         // update samples for effects (raw, smooth) 
         volumeSmth = (soundAgc) ? sampleAgc   : sampleAvg;
         volumeRaw  = (soundAgc) ? rawSampleAgc: sampleRaw;
@@ -1463,6 +1466,8 @@ class AudioReactive : public Usermod {
       memset(fftAvg, 0, sizeof(fftAvg)); 
       memset(fftResult, 0, sizeof(fftResult)); 
       for(int i=(init?0:1); i<NUM_GEQ_CHANNELS; i+=2) fftResult[i] = 16; // make a tiny pattern
+      lastFrameSeq = audioFrameSeq;                        // discard pending audio frames
+      frameSettled = true;
       inputLevel = 128;                                    // reset level slider to default
       autoResetPeak();
 
@@ -1674,9 +1679,9 @@ class AudioReactive : public Usermod {
 
         infoArr = user.createNestedArray(F("FFT time"));
         infoArr.add(float(fftTime)/100.0f);
-        if ((fftTime/100) >= FFT_MIN_CYCLE) // FFT time over budget -> I2S buffer will overflow 
+        if ((fftTime/100) >= FFT_MIN_CYCLE/FFT_HOP_DIVIDER) // FFT time over budget -> I2S buffer will overflow 
           infoArr.add("<b style=\"color:red;\">! ms</b>");
-        else if ((fftTime/80 + sampleTime/80) >= FFT_MIN_CYCLE) // FFT time >75% of budget -> risk of instability
+        else if ((fftTime/80 + sampleTime/80) >= FFT_MIN_CYCLE/FFT_HOP_DIVIDER) // FFT time >75% of budget -> risk of instability
           infoArr.add("<b style=\"color:orange;\"> ms!</b>");
         else
           infoArr.add(" ms");
@@ -1736,8 +1741,8 @@ class AudioReactive : public Usermod {
     }
 
     void onStateChange(uint8_t callMode) override {
-      if (initDone && enabled && addPalettes && palettes==0 && strip.customPalettes.size()<10) {
-        // if palettes were removed during JSON call re-add them
+      if (initDone && enabled && addPalettes && palettes==0 && strip.customPalettes.size() <= WLED_MAX_CUSTOM_PALETTES - MAX_PALETTES) {
+        // if palettes were removed during JSON call re-add them (if there is room for all of them)
         createAudioPalettes();
       }
     }
@@ -1810,6 +1815,9 @@ class AudioReactive : public Usermod {
       dynLim[F("limiter")] = limiterOn;
       dynLim[F("rise")] = attackTime;
       dynLim[F("fall")] = decayTime;
+#ifdef ARDUINO_ARCH_ESP32
+      dynLim[F("interpolate")] = interpolateFrames;
+#endif
 
       JsonObject sync = top.createNestedObject("sync");
       sync["port"] = audioSyncPort;
@@ -1871,6 +1879,7 @@ class AudioReactive : public Usermod {
       configComplete &= getJsonValue(top[FPSTR(_dynamics)][F("limiter")], limiterOn);
       configComplete &= getJsonValue(top[FPSTR(_dynamics)][F("rise")],  attackTime);
       configComplete &= getJsonValue(top[FPSTR(_dynamics)][F("fall")],  decayTime);
+      configComplete &= getJsonValue(top[FPSTR(_dynamics)][F("interpolate")], interpolateFrames);
 #endif
       configComplete &= getJsonValue(top["sync"]["port"], audioSyncPort);
       configComplete &= getJsonValue(top["sync"]["mode"], audioSyncEnabled);
@@ -1914,6 +1923,7 @@ class AudioReactive : public Usermod {
       uiScript.print(F("addInfo(ux+':dynamics:limiter',0,' On ');"));  // 0 is field type, 1 is actual field
       uiScript.print(F("addInfo(ux+':dynamics:rise',1,'ms <i>(&#x266A; effects only)</i>');"));
       uiScript.print(F("addInfo(ux+':dynamics:fall',1,'ms <i>(&#x266A; effects only)</i>');"));
+      uiScript.print(F("addInfo(ux+':dynamics:interpolate',1,'<i>(smooth GEQ)</i>');"));
 
       uiScript.print(F("dd=addDropdown(ux,'frequency:scale');"));
       uiScript.print(F("addOption(dd,'None',0);"));
@@ -1978,7 +1988,7 @@ void AudioReactive::createAudioPalettes(void) {
   if (palettes) return;
   DEBUG_PRINTLN(F("Adding audio palettes."));
   for (int i=0; i<MAX_PALETTES; i++)
-    if (strip.customPalettes.size() < 10) {
+    if (strip.customPalettes.size() < WLED_MAX_CUSTOM_PALETTES) {
       strip.customPalettes.push_back(CRGBPalette16(CRGB(BLACK)));
       palettes++;
       DEBUG_PRINTLN(palettes);
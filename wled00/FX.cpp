@@ -2181,9 +2181,11 @@ static const char _data_FX_MODE_BPM[] PROGMEM = "Bpm@!;!;!;;sx=64";
 
 uint16_t mode_fillnoise8() {
   if (SEGENV.call == 0) SEGENV.step = hw_random();
-  for (unsigned i = 0; i < SEGLEN; i++) {
-    unsigned index = perlin8(i * SEGLEN, SEGENV.step + i * SEGLEN);
-    SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0));
+  uint8_t noise[PERLIN_CHUNK];
+  for (unsigned i = 0; i < SEGLEN; i += PERLIN_CHUNK) {
+    unsigned n = min((unsigned)PERLIN_CHUNK, SEGLEN - i);
+    perlin8Line(noise, n, i * SEGLEN, SEGENV.step + i * SEGLEN, SEGLEN, SEGLEN);
+    for (unsigned j = 0; j < n; j++) SEGMENT.setPixelColor(i + j, SEGMENT.color_from_palette(noise[j], false, PALETTE_SOLID_WRAP, 0));
   }
   SEGENV.step += beatsin8_t(SEGMENT.speed, 1, 6); //10,1,4
 
@@ -2196,16 +2198,17 @@ uint16_t mode_noise16_1() {
   unsigned scale = 320;                                       // the "zoom factor" for the noise
   SEGENV.step += (1 + SEGMENT.speed/16);
 
-  for (unsigned i = 0; i < SEGLEN; i++) {
-    unsigned shift_x = beatsin8_t(11);                          // the x position of the noise field swings @ 17 bpm
-    unsigned shift_y = SEGENV.step/42;                        // the y position becomes slowly incremented
-    unsigned real_x = (i + shift_x) * scale;                  // the x position of the noise field swings @ 17 bpm
-    unsigned real_y = (i + shift_y) * scale;                  // the y position becomes slowly incremented
-    uint32_t real_z = SEGENV.step;                            // the z position becomes quickly incremented
-    unsigned noise = perlin16(real_x, real_y, real_z) >> 8;   // get the noise data and scale it down
-    unsigned index = sin8_t(noise * 3);                         // map LED color based on noise data
-
-    SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0));
+  unsigned shift_x = beatsin8_t(11);                            // the x position of the noise field swings @ 17 bpm
+  unsigned shift_y = SEGENV.step/42;                          // the y position becomes slowly incremented
+  uint32_t real_z = SEGENV.step;                              // the z position becomes quickly incremented
+  uint16_t noise[PERLIN_CHUNK];
+  for (unsigned i = 0; i < SEGLEN; i += PERLIN_CHUNK) {
+    unsigned n = min((unsigned)PERLIN_CHUNK, SEGLEN - i);
+    perlin16Line(noise, n, (i + shift_x) * scale, (i + shift_y) * scale, real_z, scale, scale, 0); // get a line of noise data
+    for (unsigned j = 0; j < n; j++) {
+      unsigned index = sin8_t((noise[j] >> 8) * 3);           // map LED color based on noise data
+      SEGMENT.setPixelColor(i + j, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0));
+    }
   }
 
   return FRAMETIME;
@@ -2217,13 +2220,16 @@ uint16_t mode_noise16_2() {
   unsigned scale = 1000;                                        // the "zoom factor" for the noise
   SEGENV.step += (1 + (SEGMENT.speed >> 1));
 
-  for (unsigned i = 0; i < SEGLEN; i++) {
-    unsigned shift_x = SEGENV.step >> 6;                        // x as a function of time
-    uint32_t real_x = (i + shift_x) * scale;                    // calculate the coordinates within the noise field
-    unsigned noise = perlin16(real_x, 0, 4223) >> 8;            // get the noise data and scale it down
-    unsigned index = sin8_t(noise * 3);                           // map led color based on noise data
-
-    SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0, noise));
+  unsigned shift_x = SEGENV.step >> 6;                          // x as a function of time
+  uint16_t noise[PERLIN_CHUNK];
+  for (unsigned i = 0; i < SEGLEN; i += PERLIN_CHUNK) {
+    unsigned n = min((unsigned)PERLIN_CHUNK, SEGLEN - i);
+    perlin16Line(noise, n, (i + shift_x) * scale, 0, 4223, scale, 0, 0); // get a row of noise data
+    for (unsigned j = 0; j < n; j++) {
+      unsigned bri = noise[j] >> 8;                             // scale noise data down
+      unsigned index = sin8_t(bri * 3);                         // map led color based on noise data
+      SEGMENT.setPixelColor(i + j, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0, bri));
+    }
   }
 
   return FRAMETIME;
@@ -2235,16 +2241,18 @@ uint16_t mode_noise16_3() {
   unsigned scale = 800;                                       // the "zoom factor" for the noise
   SEGENV.step += (1 + SEGMENT.speed);
 
-  for (unsigned i = 0; i < SEGLEN; i++) {
-    unsigned shift_x = 4223;                                  // no movement along x and y
-    unsigned shift_y = 1234;
-    uint32_t real_x = (i + shift_x) * scale;                  // calculate the coordinates within the noise field
-    uint32_t real_y = (i + shift_y) * scale;                  // based on the precalculated positions
-    uint32_t real_z = SEGENV.step*8;
-    unsigned noise = perlin16(real_x, real_y, real_z) >> 8;   // get the noise data and scale it down
-    unsigned index = sin8_t(noise * 3);                         // map led color based on noise data
-
-    SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0, noise));
+  const unsigned shift_x = 4223;                              // no movement along x and y
+  const unsigned shift_y = 1234;
+  uint32_t real_z = SEGENV.step*8;
+  uint16_t noise[PERLIN_CHUNK];
+  for (unsigned i = 0; i < SEGLEN; i += PERLIN_CHUNK) {
+    unsigned n = min((unsigned)PERLIN_CHUNK, SEGLEN - i);
+    perlin16Line(noise, n, (i + shift_x) * scale, (i + shift_y) * scale, real_z, scale, scale, 0); // get a line of noise data
+    for (unsigned j = 0; j < n; j++) {
+      unsigned bri = noise[j] >> 8;                             // scale noise data down
+      unsigned index = sin8_t(bri * 3);                         // map led color based on noise data
+      SEGMENT.setPixelColor(i + j, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0, bri));
+    }
   }
 
   return FRAMETIME;
@@ -2255,9 +2263,11 @@ static const char _data_FX_MODE_NOISE16_3[] PROGMEM = "Noise 3@!;!;!;;pal=35";
 //https://github.com/aykevl/ledstrip-spark/blob/master/ledstrip.ino
 uint16_t mode_noise16_4() {
   uint32_t stp = (strip.now * SEGMENT.speed) >> 7;
-  for (unsigned i = 0; i < SEGLEN; i++) {
-    int index = perlin16(uint32_t(i) << 12, stp);
-    SEGMENT.setPixelColor(i, SEGMENT.color_from_palette(index, false, PALETTE_SOLID_WRAP, 0));
+  uint16_t noise[PERLIN_CHUNK];
+  for (unsigned i = 0; i < SEGLEN; i += PERLIN_CHUNK) {
+    unsigned n = min((unsigned)PERLIN_CHUNK, SEGLEN - i);
+    perlin16Line(noise, n, uint32_t(i) << 12, stp, 1 << 12, 0);
+    for (unsigned j = 0; j < n; j++) SEGMENT.setPixelColor(i + j, SEGMENT.color_from_palette(noise[j], false, PALETTE_SOLID_WRAP, 0));
   }
   return FRAMETIME;
 }
@@ -5054,10 +5064,15 @@ uint16_t mode_2Dfirenoise(void) {               // firenoise2d. By Andrew Tuline
   unsigned indexx = 0;
 
   CRGBPalette16 pal = SEGMENT.check1 ? SEGPALETTE : SEGMENT.loadPalette(pal, 35);  
+  uint8_t noise[PERLIN_CHUNK];
   for (int j=0; j < cols; j++) {
-    for (int i=0; i < rows; i++) {
-      indexx = perlin8(j*yscale*rows/255, i*xscale+strip.now/4);                                               // We're moving along our Perlin map.
-      SEGMENT.setPixelColorXY(j, i, ColorFromPalette(pal, min(i*indexx/11, 225U), i*255/rows, LINEARBLEND));   // With that value, look up the 8 bit colour palette value and assign it to the current LED.    
+    for (int i=0; i < rows; i += PERLIN_CHUNK) {
+      int n = min(PERLIN_CHUNK, rows - i);
+      perlin8Line(noise, n, j*yscale*rows/255, i*xscale+strip.now/4, 0, xscale);                              // We're moving along our Perlin map.
+      for (int k = 0; k < n; k++) {
+        indexx = noise[k];
+        SEGMENT.setPixelColorXY(j, i+k, ColorFromPalette(pal, min((i+k)*indexx/11, 225U), (i+k)*255/rows, LINEARBLEND)); // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+      }
     } // for i
   } // for j
 
@@ -5507,10 +5522,13 @@ uint16_t mode_2Dnoise(void) {                  // By Andrew Tuline
 
   const unsigned scale  = SEGMENT.intensity+2;
 
+  const uint16_t z = strip.now / (16 - SEGMENT.speed/16);
+  uint8_t noise[PERLIN_CHUNK];
   for (int y = 0; y < rows; y++) {
-    for (int x = 0; x < cols; x++) {
-      uint8_t pixelHue8 = perlin8(x * scale, y * scale, strip.now / (16 - SEGMENT.speed/16));
-      SEGMENT.setPixelColorXY(x, y, ColorFromPalette(SEGPALETTE, pixelHue8));
+    for (int x = 0; x < cols; x += PERLIN_CHUNK) {
+      int n = min(PERLIN_CHUNK, cols - x);
+      perlin8Line(noise, n, x * scale, y * scale, z, scale, 0, 0);
+      for (int i = 0; i < n; i++) SEGMENT.setPixelColorXY(x + i, y, ColorFromPalette(SEGPALETTE, noise[i]));
     }
   }
 
@@ -7606,7 +7624,7 @@ uint16_t mode_2Doctopus() {
       for (int y = 0; y < rows; y++) {
         int dx = (x - C_X);
         int dy = (y - C_Y);
-        rMap[XY(x, y)].angle  = int(40.7436f * atan2_t(dy, dx));  // avoid 128*atan2()/PI
+        rMap[XY(x, y)].angle  = atan2_16(dy, dx) >> 8; // 0-255 = 0 to 2*pi
         rMap[XY(x, y)].radius = sqrtf(dx * dx + dy * dy) * mapp; //thanks Sutaburosu
       }
     }
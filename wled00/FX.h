@@ -21,6 +21,7 @@
 
 #include "const.h"
 #include "bus_manager.h"
+#include "seg_pool.h"
 
 #define FASTLED_INTERNAL //remove annoying pragma messages
 #define USE_GET_MILLISECOND_TIMER
@@ -63,6 +64,15 @@ extern byte realtimeMode;           // used in getMappedPixelIndex()
 #endif
 #define FPS_UNLIMITED    0
 
+// maximum time (ms) WLED::loop() may sleep while waiting for next frame deadline (0 = never sleep)
+#ifndef WLED_MAX_IDLE_SLEEP
+  #ifdef ESP8266
+    #define WLED_MAX_IDLE_SLEEP 0                                         // loop already yields to WiFi, keep polling latency low
+  #else
+    #define WLED_MAX_IDLE_SLEEP 4
+  #endif
+#endif
+
 // FPS calculation (can be defined as compile flag for debugging)
 #ifndef FPS_CALC_AVG
 #define FPS_CALC_AVG 7 // average FPS calculation over this many frames (moving average)
@@ -86,6 +96,50 @@ extern byte realtimeMode;           // used in getMappedPixelIndex()
   #define MAX_SEGMENT_DATA  (MAX_NUM_SEGMENTS*1280) // 40k by default
 #endif
 
+/* Max. total size of precomputed 1D->2D expansion maps (all segments), maps not fitting are calculated on the fly */
+#ifndef MAX_1D2D_MAP_SIZE
+  #ifdef ESP8266
+    #define MAX_1D2D_MAP_SIZE 0       // not enough RAM, always calculate on the fly
+  #elif defined(CONFIG_IDF_TARGET_ESP32S2)
+    #define MAX_1D2D_MAP_SIZE 16384
+  #else
+    #define MAX_1D2D_MAP_SIZE 32768
+  #endif
+#endif
+/* Transition arena: Transition structures and effect data snapshots are taken from a block preallocated
+  in finalizeInit() (MAX_TRANSITIONS concurrent transitions), heap is only used if the arena is exhausted.
+  A preset change usually starts transitions in a few segments only (see getTransitionsPeak()) */
+#ifndef MAX_TRANSITIONS
+  #ifdef ESP8266
+    #define MAX_TRANSITIONS 4
+  #else
+    #define MAX_TRANSITIONS 8
+  #endif
+#endif
+#ifndef MAX_TRANSITION_DATA
+  #ifdef WLED_DISABLE_MODE_BLEND
+    #define MAX_TRANSITION_DATA 0
+  #elif defined(ESP8266)
+    #define MAX_TRANSITION_DATA 1024
+  #elif defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32C3)
+    #define MAX_TRANSITION_DATA 2048
+  #else
+    #define MAX_TRANSITION_DATA 4096
+  #endif
+#endif
+
+/* Size-class pool for effect data, names and transition snapshots up to 512 bytes (see seg_pool.h), preallocated
+  in finalizeInit() next to the transition arena; larger or excess allocations use heap (PSRAM for names and transitions)
+  disabled unless SEGMENT_POOL_SIZE is defined as it permanently reserves that much RAM, i.e. -D SEGMENT_POOL_SIZE=8192
+  (ESP8266: 1024, ESP32-S2: 4096) for setups where playlists cycling effects fragment the heap */
+
+/* Built-in gradient palettes are expanded into RAM once (~2.8kB) instead of on every palette load */
+#if !defined(ESP8266) && !defined(WLED_DISABLE_PALETTE_CACHE)
+  #define WLED_PALETTE_CACHE
+#endif
+
+#define M12_MAP_GROUPS 4 // coordinate groups per virtual pixel: always drawn, first ray edge, second ray edge, both edges (pinwheel)
+
 /* How much data bytes each segment should max allocate to leave enough space for other segments,
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
@@ -493,6 +547,9 @@ typedef struct Segment {
     // clipping
     static uint16_t _clipStart, _clipStop;
     static uint8_t  _clipStartY, _clipStopY;
+    // transition compositor: if set effect renders into this buffer (virtual pixels) instead of LEDs
+    static uint32_t *_renderBuf;
+    static unsigned  _renderLen;
     #endif
 
     // transition data, valid only if transitional==true, holds values during transition (72 bytes)
@@ -500,6 +557,9 @@ typedef struct Segment {
       #ifndef WLED_DISABLE_MODE_BLEND
       tmpsegd_t     _segT;        // previous segment environment
       uint8_t       _modeT;       // previous mode/effect
+      uint32_t     *_buf;         // compositor buffers: new mode followed by old mode (_bufLen virtual pixels each)
+      unsigned      _bufLen;
+      bool          _dataShared;  // old mode still shares effect data with new mode (see separateTransitionData())
       #else
       uint32_t      _colorT[NUM_COLORS];
       #endif
@@ -516,10 +576,61 @@ typedef struct Segment {
         , _prevPaletteBlends(0)
         , _start(millis())
         , _dur(dur)
-      {}
+      {
+        #ifndef WLED_DISABLE_MODE_BLEND
+        _buf = nullptr;
+        _bufLen = 0;
+        _dataShared = false;
+        #endif
+      }
     } *_t;
 
+    // transition arena (see initTransitionArena())
+    static Transition *_tSlots;               // MAX_TRANSITIONS preallocated Transition slots
+    static uint32_t    _tSlotsUsed[(MAX_TRANSITIONS+31)/32];
+    static unsigned    _tSlotsPeak;           // max. number of slots used at the same time
+    static uint8_t    *_tData;                // MAX_TRANSITION_DATA bytes for effect data snapshots (bump allocated)
+    static unsigned    _tDataUsed;            // bytes used in snapshot area (area is reclaimed when last snapshot is released)
+    static unsigned    _tDataLive;            // number of snapshots in use
+    static unsigned    _tHeapFallbacks;       // number of Transition structures/snapshots that had to be allocated on heap
+    static unsigned    _tHandovers;           // number of effect data blocks handed over to old mode (no copy)
+    Transition *allocTransition(uint16_t dur);
+    void        freeTransition();
+    static uint8_t *allocTransitionData(size_t len);
+    static bool     freeTransitionData(uint8_t *ptr); // returns false if ptr is not in arena
+    // segment pool (see initSegmentPool())
+    #ifdef SEGMENT_POOL_SIZE
+    static SlabPool _pool;
+    #endif
+    static void    *poolAlloc(size_t len, bool psram = false); // falls back to heap (PSRAM if preferred and available)
+    static void     poolFree(void *ptr);
+    #ifndef WLED_DISABLE_MODE_BLEND
+    void        separateTransitionData();     // gives old mode its own copy of effect data or hands data over if new mode is reset
+    #endif
+
+    #ifndef WLED_DISABLE_2D
+    // precomputed 1D->2D expansion (M12_pArc, M12_pCorner, M12_sPinwheel), (re)built in beginDraw() when geometry changes
+    // each virtual pixel has M12_MAP_GROUPS groups of packed coordinates (x | y<<8), allocated as one block
+    struct Map1D2D {
+      uint16_t  _vW, _vH;         // virtual dimensions the map was built for
+      uint8_t   _type;            // M12_* mapping type
+      int       _prevRays[2];     // pinwheel: last two drawn rays (shared ray edges are only drawn once)
+      unsigned  _len;             // number of virtual (1D) pixels
+      uint32_t *_grp;             // _len*M12_MAP_GROUPS+1 start indices into _xy
+      uint16_t *_xy;              // packed coordinates
+      size_t    _size;            // allocated bytes (accounted in _m12Used)
+    } *_m12;
+    uint32_t _m12Miss;            // type/dimensions for which no map could be built (not retried every frame)
+    static size_t _m12Used;       // bytes used by all maps (limited to MAX_1D2D_MAP_SIZE)
+    void updateMap1D2D();         // validates/builds _m12 for current virtual dimensions
+    void freeMap1D2D();
+    #endif
+
     [[gnu::hot]] void _setPixelColorXY_raw(const int& x, const int& y, uint32_t& col) const; // set pixel without mapping (internal use only)
+    [[gnu::hot]] void _setPixelColor_mapped(int i, uint32_t col) const;             // set virtual pixel without clipping or brightness (internal use only)
+    #ifndef WLED_DISABLE_2D
+    [[gnu::hot]] void _setPixelColorXY_mapped(int x, int y, uint32_t col) const;    // set virtual pixel without clipping or brightness (internal use only)
+    #endif
 
   public:
 
@@ -556,6 +667,10 @@ typedef struct Segment {
       _default_palette(0),
       _dataLen(0),
       _t(nullptr)
+      #ifndef WLED_DISABLE_2D
+      , _m12(nullptr)
+      , _m12Miss(0)
+      #endif
     {
       #ifdef WLED_DEBUG
       //Serial.printf("-- Creating segment: %p\n", this);
@@ -577,9 +692,12 @@ typedef struct Segment {
       //if (data) Serial.printf(" %d->(%p)", (int)_dataLen, data);
       //Serial.println();
       #endif
-      if (name) { free(name); name = nullptr; }
+      clearName();
       stopTransition();
       deallocateData();
+      #ifndef WLED_DISABLE_2D
+      freeMap1D2D();
+      #endif
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
@@ -602,11 +720,21 @@ typedef struct Segment {
     inline uint16_t groupLength()        const { return grouping + spacing; }
     inline uint8_t  getLightCapabilities() const { return _capabilities; }
     inline void     deactivate()               { setGeometry(0,0); }
-    inline Segment &clearName()                { if (name) free(name); name = nullptr; return *this; }
+    inline Segment &clearName()                { if (name) poolFree(name); name = nullptr; return *this; }
     inline Segment &setName(const String &name) { return setName(name.c_str()); }
 
     inline static unsigned getUsedSegmentData()            { return Segment::_usedSegmentData; }
     inline static void     addUsedSegmentData(int len)     { Segment::_usedSegmentData += len; }
+    static void            initTransitionArena();          // preallocates transition arena (called from finalizeInit())
+    static unsigned        getTransitionsActive();         // number of arena slots in use
+    inline static unsigned getTransitionsPeak()            { return Segment::_tSlotsPeak; }
+    inline static unsigned getTransitionDataUsed()         { return Segment::_tDataUsed; }
+    inline static unsigned getTransitionHeapFallbacks()    { return Segment::_tHeapFallbacks; }
+    inline static unsigned getTransitionHandovers()        { return Segment::_tHandovers; }
+    #ifdef SEGMENT_POOL_SIZE
+    static void            initSegmentPool();              // preallocates segment pool (called from finalizeInit())
+    inline static const SlabPool &getSegmentPool()         { return Segment::_pool; }
+    #endif
     #ifndef WLED_DISABLE_MODE_BLEND
     inline static void     modeBlend(bool blend)           { _modeBlend = blend; }
     inline static bool     getmodeBlend(void)              { return _modeBlend; }
@@ -651,6 +779,9 @@ typedef struct Segment {
     #ifndef WLED_DISABLE_MODE_BLEND
     void     swapSegenv(tmpsegd_t &tmpSegD);    // copies segment data into specifed buffer, if buffer is not a transition buffer, segment data is overwritten from transition buffer
     void     restoreSegenv(const tmpsegd_t &tmpSegD); // restores segment data from buffer, if buffer is not transition buffer, changed values are copied to transition buffer
+    bool     allocTransitionBuffers();          // (re)allocates compositor buffers for current virtual size (call after beginDraw()), returns false if compositing is not possible
+    inline void renderToTransitionBuffer(bool oldMode) const { _renderBuf = _t->_buf + (oldMode ? _t->_bufLen : 0); _renderLen = _t->_bufLen; }
+    void     compositeTransition() const;       // blends/clips old and new mode buffers into LEDs according to blending style
     #endif
     [[gnu::hot]] void updateTransitionProgress();            // set current progression of transition
     inline uint16_t progress() const { return Segment::_transitionprogress; }  // transition progression between 0-65535
@@ -828,6 +959,7 @@ class WS2812FX {  // 96 bytes
       _cumulativeFps(50 << FPS_CALC_SHIFT),
       _isServicing(false),
       _isOffRefreshRequired(false),
+      _isDithering(false),
       _hasWhiteChannel(false),
       _triggered(false),
       _modeCount(MODE_COUNT),
@@ -836,6 +968,11 @@ class WS2812FX {  // 96 bytes
       customMappingSize(0),
       _lastShow(0),
       _lastServiceShow(0),
+      _nextDeadline(0),
+      _framesMissed(0),
+      _stepsSkipped(0),
+      _lateAvg(0),
+      _lateMax(0),
       _segment_index(0),
       _mainSegment(0)
     {
@@ -855,6 +992,9 @@ class WS2812FX {  // 96 bytes
       panel.clear();
 #endif
       customPalettes.clear();
+      #ifdef WLED_PALETTE_CACHE
+      gradientPalettes.clear();
+      #endif
     }
 
     static WS2812FX* getInstance() { return instance; }
@@ -868,9 +1008,9 @@ class WS2812FX {  // 96 bytes
       setCCT(uint16_t k),                         // sets global CCT (either in relative 0-255 value or in K)
       setBrightness(uint8_t b, bool direct = false),    // sets strip brightness
       setRange(uint16_t i, uint16_t i2, uint32_t col),  // used for clock overlay
-      purgeSegments(),                            // removes inactive segments from RAM (may incure penalty and memory fragmentation but reduces vector footprint)
+      purgeSegments(bool shrink = false),         // removes inactive segments from RAM (shrink: also release unused vector capacity)
       setMainSegmentId(unsigned n = 0),
-      resetSegments(),                            // marks all segments for reset
+      resetSegments(bool shrink = false),         // marks all segments for reset
       makeAutoSegments(bool forceReset = false),  // will create segments based on configured outputs
       fixInvalidSegments(),                       // fixes incorrect segment configuration
       setPixelColor(unsigned i, uint32_t c) const,      // paints absolute strip pixel with index n and color c
@@ -887,7 +1027,11 @@ class WS2812FX {  // 96 bytes
     inline void trigger()                                     { _triggered = true; }  // Forces the next frame to be computed on all active segments.
     inline void setShowCallback(show_callback cb)             { _callback = cb; }
     inline void setTransition(uint16_t t)                     { _transitionDur = t; } // sets transition time (in ms)
-    inline void appendSegment(const Segment &seg = Segment()) { if (_segments.size() < getMaxSegments()) _segments.push_back(seg); }
+    inline void appendSegment(const Segment &seg = Segment()) {
+      if (_segments.size() >= getMaxSegments()) return;
+      if (_segments.size() == _segments.capacity()) _segments.reserve(min(_segments.size() + 4, (size_t)getMaxSegments())); // grow in small steps, not doubling
+      _segments.push_back(seg);
+    }
     inline void suspend()                                     { _suspend = true; }    // will suspend (and canacel) strip.service() execution
     inline void resume()                                      { _suspend = false; }   // will resume strip.service() execution
 
@@ -928,6 +1072,11 @@ class WS2812FX {  // 96 bytes
     inline uint16_t getFps() const          { return (millis() - _lastShow > 2000) ? 0 : (FPS_MULTIPLIER * _cumulativeFps) >> FPS_CALC_SHIFT; } // Returns the refresh rate of the LED strip (_cumulativeFps is stored in fixed point)
     inline uint16_t getFrameTime() const    { return _frametime; }        // returns amount of time a frame should take (in ms)
     inline uint16_t getMinShowDelay() const { return MIN_FRAME_DELAY; }   // returns minimum amount of time strip.service() can be delayed (constant)
+    inline uint32_t getFramesMissed() const { return _framesMissed; }     // returns number of frames started more than a frame period after their deadline
+    inline uint32_t getStepsSkipped() const { return _stepsSkipped; }     // returns number of effect steps dropped due to overload
+    inline float    getFrameJitter() const  { return _lateAvg / 16.0f; }  // returns average delay (ms) of frame start vs. its deadline
+    inline uint16_t getFrameJitterMax() const { return _lateMax; }        // returns maximum delay (ms) of frame start vs. its deadline
+    unsigned        getTimeToNextFrame() const;                           // returns time (ms) until next frame is due (0 if due or unknown)
     inline uint16_t getLength() const       { return _length; }           // returns actual amount of LEDs on a strip (2D matrix may have less LEDs than W*H)
     inline uint16_t getTransition() const   { return _transitionDur; }    // returns currently set transition time (in ms)
     inline uint16_t getMappedPixelIndex(uint16_t index) const {           // convert logical address to physical
@@ -993,8 +1142,11 @@ class WS2812FX {  // 96 bytes
 
   // end 2D support
 
-    void loadCustomPalettes(); // loads custom palettes from JSON
+    void loadCustomPalettes(bool rebuild = false); // loads custom palettes from binary cache or JSON (rebuilds cache)
     std::vector<CRGBPalette16> customPalettes; // TODO: move custom palettes out of WS2812FX class
+    #ifdef WLED_PALETTE_CACHE
+    std::vector<CRGBPalette16> gradientPalettes; // built-in gradient palettes (13 and up) expanded once in finalizeInit()
+    #endif
 
     struct {
       bool autoSegments : 1;
@@ -1020,6 +1172,7 @@ class WS2812FX {  // 96 bytes
     struct {
       bool _isServicing          : 1;
       bool _isOffRefreshRequired : 1; //periodic refresh is required for the strip to remain off.
+      bool _isDithering          : 1; //at least one bus uses temporal dithering, output needs to be refreshed every frame
       bool _hasWhiteChannel      : 1;
       bool _triggered            : 1;
     };
@@ -1035,6 +1188,12 @@ class WS2812FX {  // 96 bytes
 
     unsigned long _lastShow;
     unsigned long _lastServiceShow;
+    // frame pacing (see service())
+    unsigned long _nextDeadline;  // millis() when next frame is due (earliest active segment, but not before next frame slot)
+    uint32_t      _framesMissed;
+    uint32_t      _stepsSkipped;
+    uint16_t      _lateAvg;       // running average of frame start delay in ms (fixed point, 4 fractional bits)
+    uint16_t      _lateMax;
 
     uint8_t _segment_index;
     uint8_t _mainSegment;
@@ -185,7 +185,7 @@ bool IRAM_ATTR_YN Segment::isPixelXYClipped(int x, int y) const {
       if (len < 2) return false;
       const unsigned shuffled = hashInt(x + y * width) % len;
       const unsigned pos = (shuffled * 0xFFFFU) / len;
-      return progress() > pos;
+      return (progress() <= pos) ^ _modeBlend; // same as 1D (new effect is revealed as transition progresses)
     }
     bool xInside = (x >= startX && x < stopX); if (invertX) xInside = !xInside;
     bool yInside = (y >= startY && y < stopY); if (invertY) yInside = !yInside;
@@ -216,13 +216,27 @@ void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col) const
   }
 #endif
 
-  if (x >= vW || y >= vH || x < 0 || y < 0 || isPixelXYClipped(x,y)) return;  // if pixel would fall out of virtual segment just exit
+  if (x >= vW || y >= vH || x < 0 || y < 0) return;  // if pixel would fall out of virtual segment just exit
+#ifndef WLED_DISABLE_MODE_BLEND
+  // transition compositor: render into buffer, clipping/blending is done in compositeTransition()
+  if (_renderBuf) {
+    const unsigned i = x + y * vW;
+    if (i < _renderLen) _renderBuf[i] = _colorScaled ? col : color_fade(col, _segBri);
+    return;
+  }
+#endif
+  if (isPixelXYClipped(x,y)) return;
 
   // if color is unscaled
   if (!_colorScaled) col = color_fade(col, _segBri);
+  _setPixelColorXY_mapped(x, y, col);
+}
 
-  if (reverse  ) x = vW - x - 1;
-  if (reverse_y) y = vH - y - 1;
+// set virtual pixel (clipping and brightness have already been applied)
+void IRAM_ATTR_YN Segment::_setPixelColorXY_mapped(int x, int y, uint32_t col) const
+{
+  if (reverse  ) x = vWidth()  - x - 1;
+  if (reverse_y) y = vHeight() - y - 1;
   if (transpose) { std::swap(x,y); } // swap X & Y if segment transposed
   unsigned groupLen = groupLength();
 
@@ -305,7 +319,11 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColorXY(int x, int y) const {
   }
 #endif
 
-  if (x >= vW || y >= vH || x<0 || y<0 || isPixelXYClipped(x,y)) return 0;  // if pixel would fall out of virtual segment just exit
+  if (x >= vW || y >= vH || x<0 || y<0) return 0;  // if pixel would fall out of virtual segment just exit
+#ifndef WLED_DISABLE_MODE_BLEND
+  if (_renderBuf) { const unsigned i = x + y * vW; return i < _renderLen ? _renderBuf[i] : 0; }
+#endif
+  if (isPixelXYClipped(x,y)) return 0;
 
   if (reverse  ) x = vW - x - 1;
   if (reverse_y) y = vH - y - 1;
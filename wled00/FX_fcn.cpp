@@ -68,6 +68,9 @@ static constexpr bool validatePinsAndTypes(const unsigned* types, unsigned numTy
 // Segment class implementation
 ///////////////////////////////////////////////////////////////////////////////
 unsigned      Segment::_usedSegmentData   = 0U; // amount of RAM all segments use for their data[]
+#ifndef WLED_DISABLE_2D
+size_t        Segment::_m12Used           = 0U; // amount of RAM all 1D->2D maps use
+#endif
 uint16_t      Segment::maxWidth           = DEFAULT_LED_COUNT;
 uint16_t      Segment::maxHeight          = 1;
 unsigned      Segment::_vLength           = 0;
@@ -83,12 +86,37 @@ uint16_t      Segment::_lastPaletteChange = 0; // perhaps it should be per segme
 uint16_t      Segment::_lastPaletteBlend  = 0; //in millis (lowest 16 bits only)
 uint16_t      Segment::_transitionprogress  = 0xFFFF;
 
+// transitions are also started from async_tcp (e.g. seg.setMode() in HTTP API) while the loop task renders,
+// so arena and segment pool bookkeeping is done in a critical section (ESP8266 runs async callbacks on the loop task)
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE segMemMux = portMUX_INITIALIZER_UNLOCKED;
+#define SEGMEM_LOCK()   portENTER_CRITICAL(&segMemMux)
+#define SEGMEM_UNLOCK() portEXIT_CRITICAL(&segMemMux)
+#else
+#define SEGMEM_LOCK()
+#define SEGMEM_UNLOCK()
+#endif
+
+Segment::Transition *Segment::_tSlots  = nullptr;
+uint32_t      Segment::_tSlotsUsed[(MAX_TRANSITIONS+31)/32] = {0};
+unsigned      Segment::_tSlotsPeak     = 0;
+uint8_t      *Segment::_tData          = nullptr;
+unsigned      Segment::_tDataUsed      = 0;
+unsigned      Segment::_tDataLive      = 0;
+unsigned      Segment::_tHeapFallbacks = 0;
+unsigned      Segment::_tHandovers     = 0;
+#ifdef SEGMENT_POOL_SIZE
+SlabPool      Segment::_pool;
+#endif
+
 #ifndef WLED_DISABLE_MODE_BLEND
 bool Segment::_modeBlend = false;
 uint16_t Segment::_clipStart = 0;
 uint16_t Segment::_clipStop = 0;
 uint8_t  Segment::_clipStartY = 0;
 uint8_t  Segment::_clipStopY = 1;
+uint32_t *Segment::_renderBuf = nullptr;
+unsigned  Segment::_renderLen = 0;
 #endif
 
 // copy constructor
@@ -99,7 +127,10 @@ Segment::Segment(const Segment &orig) {
   name = nullptr;
   data = nullptr;
   _dataLen = 0;
-  if (orig.name) { name = static_cast<char*>(malloc(strlen(orig.name)+1)); if (name) strcpy(name, orig.name); }
+  #ifndef WLED_DISABLE_2D
+  _m12 = nullptr; // will be rebuilt when needed
+  #endif
+  if (orig.name) { name = static_cast<char*>(poolAlloc(strlen(orig.name)+1, true)); if (name) strcpy(name, orig.name); }
   if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
 }
 
@@ -111,6 +142,9 @@ Segment::Segment(Segment &&orig) noexcept {
   orig.name = nullptr;
   orig.data = nullptr;
   orig._dataLen = 0;
+  #ifndef WLED_DISABLE_2D
+  orig._m12 = nullptr;
+  #endif
 }
 
 // copy assignment
@@ -118,16 +152,22 @@ Segment& Segment::operator= (const Segment &orig) {
   //DEBUG_PRINTF_P(PSTR("-- Copying segment: %p -> %p\n"), &orig, this);
   if (this != &orig) {
     // clean destination
-    if (name) { free(name); name = nullptr; }
+    clearName();
     stopTransition();
     deallocateData();
+    #ifndef WLED_DISABLE_2D
+    freeMap1D2D();
+    #endif
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     // erase pointers to allocated data
     data = nullptr;
     _dataLen = 0;
+    #ifndef WLED_DISABLE_2D
+    _m12 = nullptr;
+    #endif
     // copy source data
-    if (orig.name) { name = static_cast<char*>(malloc(strlen(orig.name)+1)); if (name) strcpy(name, orig.name); }
+    if (orig.name) { name = static_cast<char*>(poolAlloc(strlen(orig.name)+1, true)); if (name) strcpy(name, orig.name); }
     if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
   }
   return *this;
@@ -137,14 +177,20 @@ Segment& Segment::operator= (const Segment &orig) {
 Segment& Segment::operator= (Segment &&orig) noexcept {
   //DEBUG_PRINTF_P(PSTR("-- Moving segment: %p -> %p\n"), &orig, this);
   if (this != &orig) {
-    if (name) { free(name); name = nullptr; } // free old name
+    clearName(); // free old name
     stopTransition();
     deallocateData(); // free old runtime data
+    #ifndef WLED_DISABLE_2D
+    freeMap1D2D();
+    #endif
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     orig.name = nullptr;
     orig.data = nullptr;
     orig._dataLen = 0;
     orig._t   = nullptr; // old segment cannot be in transition
+    #ifndef WLED_DISABLE_2D
+    orig._m12 = nullptr;
+    #endif
   }
   return *this;
 }
@@ -166,8 +212,9 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
     return false;
   }
   // do not use SPI RAM on ESP32 since it is slow
-  data = (byte*)calloc(len, sizeof(byte));
+  data = static_cast<byte*>(poolAlloc(len));
   if (!data) { DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); return false; } // allocation failed
+  memset(data, 0, len);
   Segment::addUsedSegmentData(len);
   //DEBUG_PRINTF_P(PSTR("---  Allocated data (%p): %d/%d -> %p\n"), this, len, Segment::getUsedSegmentData(), data);
   _dataLen = len;
@@ -176,9 +223,10 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
 
 void IRAM_ATTR_YN Segment::deallocateData() {
   if (!data) { _dataLen = 0; return; }
+  if (freeTransitionData(data)) { data = nullptr; _dataLen = 0; return; } // old mode snapshot (not accounted)
   //DEBUG_PRINTF_P(PSTR("---  Released data (%p): %d/%d -> %p\n"), this, _dataLen, Segment::getUsedSegmentData(), data);
   if ((Segment::getUsedSegmentData() > 0) && (_dataLen > 0)) { // check that we don't have a dangling / inconsistent data pointer
-    free(data);
+    poolFree(data);
   } else {
     DEBUG_PRINTF_P(PSTR("---- Released data (%p): inconsistent UsedSegmentData (%d/%d), cowardly refusing to free nothing.\n"), this, _dataLen, Segment::getUsedSegmentData());
   }
@@ -195,6 +243,9 @@ void IRAM_ATTR_YN Segment::deallocateData() {
   * may free that data buffer.
   */
 void Segment::resetIfRequired() {
+#ifndef WLED_DISABLE_MODE_BLEND
+  separateTransitionData(); // old mode must keep its data (before reset and before any mode runs)
+#endif
   if (!reset) return;
   //DEBUG_PRINTF_P(PSTR("-- Segment reset: %p\n"), this);
   if (data && _dataLen > 0) memset(data, 0, _dataLen);  // prevent heap fragmentation (just erase buffer instead of deallocateData())
@@ -206,8 +257,7 @@ void Segment::resetIfRequired() {
 }
 
 CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
-  if (pal < 245 && pal > GRADIENT_PALETTE_COUNT+13) pal = 0;
-  if (pal > 245 && (strip.customPalettes.size() == 0 || 255U-pal > strip.customPalettes.size()-1)) pal = 0; // TODO remove strip dependency by moving customPalettes out of strip
+  if (pal >= GRADIENT_PALETTE_COUNT+13 && 255U-pal >= strip.customPalettes.size()) pal = 0; // invalid built-in or custom palette TODO remove strip dependency by moving customPalettes out of strip
   //default palette. Differs depending on effect
   if (pal == 0) pal = _default_palette; //load default palette set in FX _data, party colors as default
   switch (pal) {
@@ -239,11 +289,17 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
       }
       break;}
     default: //progmem palettes
-      if (pal>245) {
+      if (pal >= GRADIENT_PALETTE_COUNT+13) {
         targetPalette = strip.customPalettes[255-pal]; // we checked bounds above
       } else if (pal < 13) { // palette 6 - 12, fastled palettes
         targetPalette = *fastledPalettes[pal-6];
-      } else {
+      }
+      #ifdef WLED_PALETTE_CACHE
+      else if (!strip.gradientPalettes.empty()) {
+        targetPalette = strip.gradientPalettes[pal-13];
+      }
+      #endif
+      else {
         byte tcp[72];
         memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[pal-13])), 72);
         targetPalette.loadDynamicGradientPalette(tcp);
@@ -253,6 +309,117 @@ CRGBPalette16 &Segment::loadPalette(CRGBPalette16 &targetPalette, uint8_t pal) {
   return targetPalette;
 }
 
+// preallocate Transition slots and effect data snapshot area as one block while heap is not yet fragmented
+// (only once, finalizeInit() is called again when LED outputs change)
+void Segment::initTransitionArena() {
+  if (_tSlots) return;
+  constexpr size_t slotsSize = (MAX_TRANSITIONS * sizeof(Transition) + 7) & ~7; // keep snapshots 8 byte aligned
+  _tSlots = static_cast<Transition*>(malloc(slotsSize + MAX_TRANSITION_DATA));
+  if (_tSlots) _tData = reinterpret_cast<uint8_t*>(_tSlots) + slotsSize;
+  DEBUG_PRINTF_P(PSTR("Transition arena: %u slots, %u bytes (%p)\n"), (unsigned)MAX_TRANSITIONS, (unsigned)(slotsSize + MAX_TRANSITION_DATA), _tSlots);
+}
+
+#ifdef SEGMENT_POOL_SIZE
+// preallocate segment pool (internal RAM, it holds effect data) while heap is not yet fragmented
+void Segment::initSegmentPool() {
+  if (_pool.capacity()) return;
+  _pool.begin(malloc(SEGMENT_POOL_SIZE), SEGMENT_POOL_SIZE);
+  DEBUG_PRINTF_P(PSTR("Segment pool: %u bytes\n"), (unsigned)_pool.capacity());
+}
+#endif
+
+// effect data, names and transitions are also (re)allocated from async_tcp (i.e. seg.setName(), seg.setMode() in
+// HTTP/JSON API) while the loop task renders, so pool bookkeeping is locked like the transition arena
+// heap fallback is outside the critical section (malloc() has its own lock and must not run with interrupts disabled)
+void *Segment::poolAlloc(size_t len, bool psram) {
+  #ifdef SEGMENT_POOL_SIZE
+  SEGMEM_LOCK();
+  void *ptr = _pool.alloc(len);
+  if (!ptr) _pool.fallback();
+  SEGMEM_UNLOCK();
+  if (ptr) return ptr;
+  #endif
+  #if defined(ARDUINO_ARCH_ESP32)
+  if (psram && psramSafe && psramFound()) {
+    void *pptr = ps_malloc(len);
+    if (pptr) return pptr;
+  }
+  #endif
+  return malloc(len);
+}
+
+void Segment::poolFree(void *ptr) {
+  if (!ptr) return;
+  #ifdef SEGMENT_POOL_SIZE
+  SEGMEM_LOCK();
+  const bool pooled = _pool.free(ptr);
+  SEGMEM_UNLOCK();
+  if (pooled) return;
+  #endif
+  free(ptr);
+}
+
+unsigned Segment::getTransitionsActive() {
+  unsigned n = 0;
+  for (const auto used : _tSlotsUsed) n += __builtin_popcount(used);
+  return n;
+}
+
+Segment::Transition *Segment::allocTransition(uint16_t dur) {
+  int slot = -1;
+  SEGMEM_LOCK();
+  if (_tSlots) for (unsigned i = 0; i < MAX_TRANSITIONS; i++) {
+    if (_tSlotsUsed[i/32] & (1UL << (i%32))) continue;
+    _tSlotsUsed[i/32] |= 1UL << (i%32);
+    _tSlotsPeak = max(_tSlotsPeak, getTransitionsActive());
+    slot = i;
+    break;
+  }
+  if (slot < 0) _tHeapFallbacks++; // arena exhausted (or not initialised)
+  SEGMEM_UNLOCK();
+  if (slot >= 0) return new(&_tSlots[slot]) Transition(dur);
+  void *mem = poolAlloc(sizeof(Transition), true);
+  return mem ? new(mem) Transition(dur) : nullptr;
+}
+
+void Segment::freeTransition() {
+  if (!_t) return;
+  _t->~Transition();
+  if (_tSlots && _t >= _tSlots && _t < _tSlots + MAX_TRANSITIONS) {
+    const unsigned i = _t - _tSlots;
+    SEGMEM_LOCK();
+    _tSlotsUsed[i/32] &= ~(1UL << (i%32));
+    SEGMEM_UNLOCK();
+  } else {
+    poolFree(_t);
+  }
+  _t = nullptr;
+}
+
+// bump allocation: transitions usually start and end together (preset change) so the area is reclaimed quickly
+uint8_t *Segment::allocTransitionData(size_t len) {
+  len = (len + 7) & ~7;
+  uint8_t *ptr = nullptr;
+  SEGMEM_LOCK();
+  if (_tData && _tDataUsed + len <= MAX_TRANSITION_DATA) {
+    ptr = _tData + _tDataUsed;
+    _tDataUsed += len;
+    _tDataLive++;
+  } else {
+    _tHeapFallbacks++;
+  }
+  SEGMEM_UNLOCK();
+  return ptr ? ptr : static_cast<uint8_t*>(poolAlloc(len, true));
+}
+
+bool Segment::freeTransitionData(uint8_t *ptr) {
+  if (!_tData || ptr < _tData || ptr >= _tData + MAX_TRANSITION_DATA) return false;
+  SEGMEM_LOCK();
+  if (_tDataLive > 0 && --_tDataLive == 0) _tDataUsed = 0; // last snapshot released, reclaim whole area
+  SEGMEM_UNLOCK();
+  return true;
+}
+
 void Segment::startTransition(uint16_t dur) {
   if (dur == 0) {
     if (isInTransition()) _t->_dur = dur; // this will stop transition in next handleTransition()
@@ -261,7 +428,7 @@ void Segment::startTransition(uint16_t dur) {
   if (isInTransition()) return; // already in transition no need to store anything
 
   // starting a transition has to occur before change so we get current values 1st
-  _t = new(std::nothrow) Transition(dur); // no previous transition running
+  _t = allocTransition(dur); // no previous transition running
   if (!_t) return; // failed to allocate data
 
   //DEBUG_PRINTF_P(PSTR("-- Started transition: %p (%p)\n"), this, _t);
@@ -272,15 +439,12 @@ void Segment::startTransition(uint16_t dur) {
 #ifndef WLED_DISABLE_MODE_BLEND
   swapSegenv(_t->_segT); // copy runtime data to temporary
   _t->_modeT          = mode;
-  _t->_segT._dataLenT = 0;
-  _t->_segT._dataT    = nullptr;
-  if (_dataLen > 0 && data) {
-    _t->_segT._dataT = (byte *)malloc(_dataLen);
-    if (_t->_segT._dataT) {
-      //DEBUG_PRINTF_P(PSTR("--  Allocated duplicate data (%d) for %p: %p\n"), _dataLen, this, _t->_segT._dataT);
-      memcpy(_t->_segT._dataT, data, _dataLen);
-      _t->_segT._dataLenT = _dataLen;
-    }
+  // effect data is shared with new mode until separateTransitionData() is called prior to running any mode
+  // (changes made after this call determine if data is handed over or copied)
+  _t->_dataShared     = _dataLen > 0 && data;
+  if (!_t->_dataShared) {
+    _t->_segT._dataLenT = 0;
+    _t->_segT._dataT    = nullptr;
   }
   DEBUG_PRINTF_P(PSTR("-- pal: %d, bri: %d, C:[%08X,%08X,%08X], m: %d\n"),
     (int)_t->_palTid,
@@ -298,15 +462,15 @@ void Segment::stopTransition() {
   if (isInTransition()) {
     //DEBUG_PRINTF_P(PSTR("-- Stopping transition: %p\n"), this);
     #ifndef WLED_DISABLE_MODE_BLEND
-    if (_t->_segT._dataT && _t->_segT._dataLenT > 0) {
+    if (_t->_segT._dataT && _t->_segT._dataLenT > 0 && !_t->_dataShared) {
       //DEBUG_PRINTF_P(PSTR("--  Released duplicate data (%d) for %p: %p\n"), _t->_segT._dataLenT, this, _t->_segT._dataT);
-      free(_t->_segT._dataT);
+      if (!freeTransitionData(_t->_segT._dataT)) poolFree(_t->_segT._dataT);
       _t->_segT._dataT = nullptr;
       _t->_segT._dataLenT = 0;
     }
+    if (_t->_buf) poolFree(_t->_buf);
     #endif
-    delete _t;
-    _t = nullptr;
+    freeTransition();
   }
   _transitionprogress = 0xFFFFU; // stop means stop - transition has ended
 }
@@ -321,6 +485,26 @@ inline void Segment::updateTransitionProgress() {
 }
 
 #ifndef WLED_DISABLE_MODE_BLEND
+// effect data is shared by old and new mode when transition starts, before any mode runs data is separated:
+// - if new mode is going to be reset (effect changed) the data block is handed over to old mode (ping-pong) and new
+//   mode allocates its own data (no copy, no extra allocation compared to a snapshot)
+// - otherwise (same effect) old mode gets a snapshot from the transition arena
+void Segment::separateTransitionData() {
+  if (!isInTransition() || !_t->_dataShared) return;
+  _t->_dataShared = false;
+  if (reset) {
+    addUsedSegmentData(-int(_dataLen)); // old mode data is not accounted for (same as snapshots)
+    data     = nullptr;
+    _dataLen = 0;
+    _tHandovers++;
+    return;
+  }
+  uint8_t *snapshot = allocTransitionData(_dataLen);
+  if (snapshot) memcpy(snapshot, data, _dataLen);
+  _t->_segT._dataT    = snapshot;
+  _t->_segT._dataLenT = snapshot ? _dataLen : 0;
+}
+
 void Segment::swapSegenv(tmpsegd_t &tmpSeg) {
   //DEBUG_PRINTF_P(PSTR("--  Saving temp seg: %p->(%p) [%d->%p]\n"), this, &tmpSeg, _dataLen, data);
   tmpSeg._optionsT   = options;
@@ -389,6 +573,72 @@ void Segment::restoreSegenv(const tmpsegd_t &tmpSeg) {
   data      = tmpSeg._dataT;
   _dataLen  = tmpSeg._dataLenT;
 }
+
+// transition compositor: old and new mode each render into their own buffer (in virtual pixels, as effects see them)
+// and compositeTransition() blends/clips both buffers into LEDs in a single pass. this makes transitions independent
+// of effects reading back their own pixels (which otherwise read the other effect's output from the LEDs)
+// buffers are only used if old and new mode share the same virtual geometry, otherwise legacy (clipping) blending is used
+bool Segment::allocTransitionBuffers() {
+  constexpr uint16_t geometryOptions = (1<<SEG_OPTION_REVERSED) | (1<<SEG_OPTION_MIRROR) | (1<<SEG_OPTION_REVERSED_Y)
+                                     | (1<<SEG_OPTION_MIRROR_Y) | (1<<SEG_OPTION_TRANSPOSED) | (0x07<<9); // map1D2D
+  if (!isInTransition() || ((options ^ _t->_segT._optionsT) & geometryOptions)) return false;
+  const unsigned len = is2D() ? vWidth() * vHeight() : vLength();
+  if (_t->_buf && _t->_bufLen == len) return true;
+  if (_t->_buf) poolFree(_t->_buf);
+  _t->_buf = nullptr;
+  _t->_bufLen = 0;
+  if (len == 0 || 2 * len * sizeof(uint32_t) + MIN_HEAP_SIZE > getHeapMaxBlock()) return false; // do not starve heap, use legacy blending
+  _t->_buf = static_cast<uint32_t*>(poolAlloc(2 * len * sizeof(uint32_t), true));
+  if (!_t->_buf) return false;
+  _t->_bufLen = len;
+  // seed both buffers with current segment content so effects that build upon previous frame continue seamlessly
+  const bool blend = _modeBlend;
+  _modeBlend = true; // no "push" shift while reading
+  if (is2D()) {
+    const unsigned vW = vWidth();
+    for (unsigned i = 0; i < len; i++) _t->_buf[i] = getPixelColorXY(i % vW, i / vW);
+  } else {
+    for (unsigned i = 0; i < len; i++) _t->_buf[i] = getPixelColor(i);
+  }
+  _modeBlend = blend;
+  memcpy(_t->_buf + len, _t->_buf, len * sizeof(uint32_t));
+  return true;
+}
+
+// write new mode where it is not clipped (or blend both for fade) and old mode elsewhere
+// clipping rectangle has to be set according to blending style (as for legacy blending)
+void Segment::compositeTransition() const {
+  _renderBuf = nullptr;
+  _renderLen = 0;
+  if (!isInTransition() || !_t->_buf) return;
+  const uint32_t *bufNew = _t->_buf;
+  const uint32_t *bufOld = _t->_buf + _t->_bufLen;
+  const unsigned  prog   = progress();
+  const bool      fade   = blendingStyle == BLEND_STYLE_FADE;
+#ifndef WLED_DISABLE_2D
+  if (is2D()) {
+    const int vW = vWidth();
+    const int vH = vHeight();
+    for (int y = 0; y < vH; y++) for (int x = 0; x < vW; x++) {
+      const unsigned i = x + y * vW;
+      _setPixelColorXY_mapped(x, y, fade ? color_blend16(bufOld[i], bufNew[i], prog) : isPixelXYClipped(x, y) ? bufOld[i] : bufNew[i]);
+    }
+    return;
+  }
+  if (Segment::maxHeight != 1 && (width() == 1 || height() == 1) && start < Segment::maxWidth*Segment::maxHeight) {
+    // vertical or horizontal 1D segment in a matrix (see setPixelColor())
+    for (unsigned i = 0; i < _t->_bufLen; i++) {
+      const int x = vWidth()  > 1 ? i : 0;
+      const int y = vHeight() > 1 ? i : 0;
+      _setPixelColorXY_mapped(x, y, fade ? color_blend16(bufOld[i], bufNew[i], prog) : isPixelClipped(i) ? bufOld[i] : bufNew[i]);
+    }
+    return;
+  }
+#endif
+  for (unsigned i = 0; i < _t->_bufLen; i++) {
+    _setPixelColor_mapped(i, fade ? color_blend16(bufOld[i], bufNew[i], prog) : isPixelClipped(i) ? bufOld[i] : bufNew[i]);
+  }
+}
 #endif
 
 uint8_t Segment::currentBri(bool useCct) const {
@@ -447,6 +697,9 @@ void Segment::beginDraw() {
   _vWidth  = virtualWidth();
   _vHeight = virtualHeight();
   _vLength = virtualLength();
+  #ifndef WLED_DISABLE_2D
+  if (is2D()) updateMap1D2D();
+  #endif
   _segBri  = currentBri();
   unsigned prog = isInTransition() ? progress() : 0xFFFFU;  // transition progress; 0xFFFFU = no transition active
   // adjust gamma for effects
@@ -645,8 +898,7 @@ Segment &Segment::setMode(uint8_t fx, bool loadDefaults) {
 }
 
 Segment &Segment::setPalette(uint8_t pal) {
-  if (pal < 245 && pal > GRADIENT_PALETTE_COUNT+13) pal = 0; // built in palettes
-  if (pal > 245 && (strip.customPalettes.size() == 0 || 255U-pal > strip.customPalettes.size()-1)) pal = 0; // custom palettes
+  if (pal >= GRADIENT_PALETTE_COUNT+13 && 255U-pal >= strip.customPalettes.size()) pal = 0; // invalid built-in or custom palette
   if (pal != palette) {
     //DEBUG_PRINTF_P(PSTR("- Starting palette transition: %d\n"), pal);
     startTransition(strip.getTransition());
@@ -660,10 +912,9 @@ Segment &Segment::setName(const char *newName) {
   if (newName) {
     const int newLen = min(strlen(newName), (size_t)WLED_MAX_SEGNAME_LEN);
     if (newLen) {
-      if (name) name = static_cast<char*>(realloc(name, newLen+1));
-      else      name = static_cast<char*>(malloc(newLen+1));
+      if (name && (size_t)newLen >= _pool.blockSize(name)) clearName(); // keep pool block if new name fits
+      if (!name) name = static_cast<char*>(poolAlloc(newLen+1, true));
       if (name) strlcpy(name, newName, newLen+1);
-      name[newLen] = 0;
       return *this;
     }
   }
@@ -707,6 +958,188 @@ static void setPinwheelParameters(int i, int vW, int vH, int& startx, int& start
   startx = (vW * Fixed_Scale) / 2; // + cosVal[0] / 4; // starting position = center + 1/4 pixel (in fixed point)
   starty = (vH * Fixed_Scale) / 2; // + sinVal[0] / 4; 
 }
+
+// Pinwheel helper: calculates coordinates (x,y pairs) of both edges of ray i using Bresenham's algorithm
+// the shorter edge is filled up with missing coordinates so the area between the edges can be block filled
+// returns index of the longer edge, closestEdgeIdx is set to the index of the closest edge pixel
+static int getPinwheelEdges(int i, int vW, int vH, uint16_t *line0, uint16_t *line1, int *lineLength, int &closestEdgeIdx) {
+  int startX, startY, cosVal[2], sinVal[2]; // in fixed point scale
+  setPinwheelParameters(i, vW, vH, startX, startY, cosVal, sinVal);
+  uint16_t *lineCoords[2] = {line0, line1};
+
+  for (int lineNr = 0; lineNr < 2; lineNr++) {
+    int x0 = startX; // x, y coordinates in fixed scale
+    int y0 = startY;
+    int x1 = (startX + (cosVal[lineNr] << 9)); // outside of grid
+    int y1 = (startY + (sinVal[lineNr] << 9)); // outside of grid
+    const int dx =  abs(x1-x0), sx = x0<x1 ? 1 : -1; // x distance & step
+    const int dy = -abs(y1-y0), sy = y0<y1 ? 1 : -1; // y distance & step
+    uint16_t* coordinates = lineCoords[lineNr]; // 1D access is faster
+    int* length = &lineLength[lineNr];          // faster access
+    x0 /= Fixed_Scale; // convert to pixel coordinates
+    y0 /= Fixed_Scale;
+
+    // Bresenham's algorithm
+    int idx = 0;
+    int err = dx + dy;
+    while (true) {
+      if (unsigned(x0) >= vW || unsigned(y0) >= vH) {
+        closestEdgeIdx = min(closestEdgeIdx, idx-2);
+        break; // stop if outside of grid (exploit unsigned int overflow)
+      }
+      coordinates[idx++] = x0;
+      coordinates[idx++] = y0;
+      (*length)++;
+      // note: since endpoint is out of grid, no need to check if endpoint is reached
+      int e2 = 2 * err;
+      if (e2 >= dy) { err += dy; x0 += sx; }
+      if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+  }
+
+  // fill up the shorter line with missing coordinates, so block filling works correctly and efficiently
+  int diff = lineLength[0] - lineLength[1];
+  int longLineIdx = (diff > 0) ? 0 : 1;
+  int shortLineIdx = longLineIdx ? 0 : 1;
+  if (diff != 0) {
+    int idx = (lineLength[shortLineIdx] - 1) * 2; // last valid coordinate index
+    int lastX = lineCoords[shortLineIdx][idx++];
+    int lastY = lineCoords[shortLineIdx][idx++];
+    bool keepX = lastX == 0 || lastX == vW - 1;
+    for (int d = 0; d < abs(diff); d++) {
+      lineCoords[shortLineIdx][idx] = keepX ? lastX :lineCoords[longLineIdx][idx];
+      idx++;
+      lineCoords[shortLineIdx][idx] =  keepX ? lineCoords[longLineIdx][idx] : lastY;
+      idx++;
+    }
+  }
+  return longLineIdx;
+}
+
+void Segment::freeMap1D2D() {
+  if (!_m12) return;
+  _m12Used -= min(_m12->_size, _m12Used);
+  free(_m12);
+  _m12 = nullptr;
+}
+
+// (re)builds precomputed 1D->2D expansion map if mapping or virtual dimensions changed (called from beginDraw())
+// if the map does not fit into MAX_1D2D_MAP_SIZE (all maps) or heap setPixelColor() calculates the expansion on the fly,
+// the failure is remembered so the counting pass is not repeated every frame for the same geometry
+void Segment::updateMap1D2D() {
+  const int vW = _vWidth;
+  const int vH = _vHeight;
+  const uint8_t type = map1D2D;
+  if (type != M12_pArc && type != M12_pCorner && type != M12_sPinwheel) {
+    if (!isInTransition()) freeMap1D2D();
+    return;
+  }
+  if (_m12 && _m12->_type == type && _m12->_vW == vW && _m12->_vH == vH) return; // up to date
+  if (_m12 && isInTransition()) return; // old and new effect may use different mapping, do not rebuild each frame
+  freeMap1D2D();
+  if (MAX_1D2D_MAP_SIZE == 0 || vW > 256 || vH > 256 || vW == 0 || vH == 0) return; // coordinates are packed into 8 bits each
+  const uint32_t key = (uint32_t(type) << 16) | ((vW - 1) << 8) | (vH - 1);
+  if (_m12Miss == key + 1) return; // did not fit last time
+  _m12Miss = key + 1;               // cleared once the map is built
+
+  const int len = _vLength;
+  // collects coordinates: first pass only counts them, second pass stores them
+  struct Builder {
+    Map1D2D *m;
+    int vW, vH;
+    unsigned count, group;
+    uint16_t last[2];
+    void nextGroup() {
+      if (m) m->_grp[group] = count;
+      group++;
+      last[0] = last[1] = UINT16_MAX;
+    }
+    void add(int x, int y) {
+      if (unsigned(x) >= unsigned(vW) || unsigned(y) >= unsigned(vH)) return; // would be clipped anyway
+      uint16_t xy = x | (y << 8);
+      if (xy == last[0] || xy == last[1]) return; // skip repeated coordinates (arc symmetry produces pairs)
+      last[1] = last[0];
+      last[0] = xy;
+      if (m) m->_xy[count] = xy;
+      count++;
+    }
+  } b = {nullptr, vW, vH, 0, 0, {UINT16_MAX, UINT16_MAX}};
+
+  const unsigned maxLineLength = max(vW, vH) + 2;
+  uint16_t lineCoords[2][maxLineLength];
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < len; i++) {
+      b.nextGroup();
+      switch (type) {
+        case M12_pArc: // same as in setPixelColor()
+          if (i == 0) b.add(0, 0);
+          else {
+            unsigned step = (0x4000U << 8) / (724U * i + 1024U);
+            for (unsigned angle = 0; angle <= 0x2000U + step/2; angle += step) {
+              int x = (sin16_lut(angle) * i + 0x4000) >> 15;
+              int y = (cos16_lut(angle) * i + 0x4000) >> 15;
+              b.add(x, y);
+              b.add(y, x);
+            }
+          }
+          for (int g = 1; g < M12_MAP_GROUPS; g++) b.nextGroup();
+          break;
+        case M12_pCorner:
+          for (int x = 0; x <= i; x++) b.add(x, i);
+          for (int y = 0; y <  i; y++) b.add(i, y);
+          for (int g = 1; g < M12_MAP_GROUPS; g++) b.nextGroup();
+          break;
+        case M12_sPinwheel: {
+          // sort block-filled pixels into groups by the condition under which setPixelColor() draws them
+          // 0: always, 1: only on first edge (drawn if previous ray was not adjacent), 2: only on second edge, 3: on both edges
+          int lineLength[2] = {0};
+          int closestEdgeIdx = INT_MAX;
+          int longLineIdx = getPinwheelEdges(i, vW, vH, lineCoords[0], lineCoords[1], lineLength, closestEdgeIdx);
+          closestEdgeIdx += 2;
+          for (int g = 0; g < M12_MAP_GROUPS; g++) {
+            if (g) b.nextGroup();
+            for (int idx = 0; idx < lineLength[longLineIdx] * 2;) {
+              int x1 = lineCoords[0][idx];
+              int x2 = lineCoords[1][idx++];
+              int y1 = lineCoords[0][idx];
+              int y2 = lineCoords[1][idx++];
+              bool alwaysDraw = (idx > closestEdgeIdx) || (i == 0 && idx == 2); // edge pixels on uneven lines & center pixel
+              for (int x = min(x1, x2); x <= max(x1, x2); x++) {
+                for (int y = min(y1, y2); y <= max(y1, y2); y++) {
+                  bool onLine1 = x == x1 && y == y1;
+                  bool onLine2 = x == x2 && y == y2;
+                  int grp = (alwaysDraw || (!onLine1 && !onLine2)) ? 0 : (onLine1 && onLine2) ? 3 : onLine1 ? 1 : 2;
+                  if (grp == g) b.add(x, y);
+                }
+              }
+            }
+          }
+          break;
+        }
+      }
+    }
+    b.nextGroup(); // end of last group
+    if (pass == 0) {
+      size_t size = sizeof(Map1D2D) + (len * M12_MAP_GROUPS + 1) * sizeof(uint32_t) + b.count * sizeof(uint16_t);
+      if (_m12Used + size > MAX_1D2D_MAP_SIZE || size + MIN_HEAP_SIZE > getHeapMaxBlock()) return;
+      _m12 = static_cast<Map1D2D*>(malloc(size));
+      if (!_m12) return;
+      _m12Used += size;
+      _m12->_size = size;
+      _m12->_vW = vW;
+      _m12->_vH = vH;
+      _m12->_type = type;
+      _m12->_prevRays[0] = _m12->_prevRays[1] = INT_MAX;
+      _m12->_len = len;
+      _m12->_grp = reinterpret_cast<uint32_t*>(_m12 + 1);
+      _m12->_xy  = reinterpret_cast<uint16_t*>(_m12->_grp + len * M12_MAP_GROUPS + 1);
+      b.m = _m12;
+      b.count = b.group = 0;
+    }
+  }
+  _m12Miss = 0;
+  DEBUG_PRINTF_P(PSTR("-- 1D->2D map (%d): %d pixels, %u coordinates\n"), (int)type, len, b.count);
+}
 #endif
 
 // 1D strip
@@ -796,6 +1229,32 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col) const
     // pre-scale color for all pixels
     col = color_fade(col, _segBri);
     _colorScaled = true;
+    if (_m12 && _m12->_type == map1D2D && _m12->_vW == vW && _m12->_vH == vH) {
+      // use precomputed expansion (M12_pArc, M12_pCorner, M12_sPinwheel)
+      bool drawGroup[M12_MAP_GROUPS] = {true, true, true, true};
+      if (map1D2D == M12_sPinwheel) {
+        // shared ray edges are only drawn once if adjacent rays are drawn in sequence (see below)
+        int *prevRays = _m12->_prevRays;
+        int max_i = vL - 1;
+        bool drawFirst = !(prevRays[0] == i - 1 || (i == 0 && prevRays[0] == max_i));
+        bool drawLast  = !(prevRays[0] == i + 1 || (i == max_i && prevRays[0] == 0));
+        bool drawTwice = (i == prevRays[1]); // effect drawing twice in 1 frame
+        drawGroup[1] = drawFirst || drawTwice;
+        drawGroup[2] = drawLast  || drawTwice;
+        drawGroup[3] = (drawFirst && drawLast) || drawTwice;
+        prevRays[1] = prevRays[0];
+        prevRays[0] = i;
+      }
+      const uint32_t *grp = &_m12->_grp[i * M12_MAP_GROUPS];
+      for (unsigned g = 0; g < M12_MAP_GROUPS; g++) {
+        if (!drawGroup[g]) continue;
+        for (unsigned n = grp[g]; n < grp[g+1]; n++) {
+          unsigned xy = _m12->_xy[n];
+          setPixelColorXY(int(xy & 0xFF), int(xy >> 8), col);
+        }
+      }
+      return;
+    }
     switch (map1D2D) {
       case M12_Pixels:
         // use all available pixels as a long strip
@@ -811,11 +1270,11 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col) const
         if (i == 0)
           setPixelColorXY(0, 0, col);
         else {
-          float r = i;
-          float step = HALF_PI / (2.8284f * r + 4); // we only need (PI/4)/(r/sqrt(2)+1) steps
-          for (float rad = 0.0f; rad <= (HALF_PI/2)+step/2; rad += step) {
-            int x = roundf(sin_t(rad) * r);
-            int y = roundf(cos_t(rad) * r);
+          // integer only: angle in 16bit units (0x4000 = PI/2), sin16_lut/cos16_lut output is scaled by 0x7FFF
+          unsigned step = (0x4000U << 8) / (724U * i + 1024U); // we only need (PI/4)/(r/sqrt(2)+1) steps, 724 = 2.8284 * 256
+          for (unsigned angle = 0; angle <= 0x2000U + step/2; angle += step) {
+            int x = (sin16_lut(angle) * i + 0x4000) >> 15; // rounded
+            int y = (cos16_lut(angle) * i + 0x4000) >> 15;
             // exploit symmetry
             setPixelColorXY(x, y, col);
             setPixelColorXY(y, x, col);
@@ -842,63 +1301,14 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col) const
         break;
         case M12_sPinwheel: {
           // Uses Bresenham's algorithm to place coordinates of two lines in arrays then draws between them
-          int startX, startY, cosVal[2], sinVal[2]; // in fixed point scale
-          setPinwheelParameters(i, vW, vH, startX, startY, cosVal, sinVal);
-  
           unsigned maxLineLength = max(vW, vH) + 2; // pixels drawn is always smaller than dx or dy, +1 pair for rounding errors
           uint16_t lineCoords[2][maxLineLength];    // uint16_t to save ram
           int lineLength[2] = {0};
   
-          static int prevRays[2] = {INT_MAX, INT_MAX}; // previous two ray numbers
+          static int prevRays[2] = {INT_MAX, INT_MAX}; // previous two ray numbers (only used if no precomputed map is available)
           int closestEdgeIdx = INT_MAX; // index of the closest edge pixel
-  
-          for (int lineNr = 0; lineNr < 2; lineNr++) {
-            int x0 = startX; // x, y coordinates in fixed scale
-            int y0 = startY;
-            int x1 = (startX + (cosVal[lineNr] << 9)); // outside of grid
-            int y1 = (startY + (sinVal[lineNr] << 9)); // outside of grid
-            const int dx =  abs(x1-x0), sx = x0<x1 ? 1 : -1; // x distance & step
-            const int dy = -abs(y1-y0), sy = y0<y1 ? 1 : -1; // y distance & step
-            uint16_t* coordinates = lineCoords[lineNr]; // 1D access is faster
-            int* length = &lineLength[lineNr];          // faster access
-            x0 /= Fixed_Scale; // convert to pixel coordinates
-            y0 /= Fixed_Scale;
-  
-            // Bresenham's algorithm
-            int idx = 0;
-            int err = dx + dy;
-            while (true) {
-              if (unsigned(x0) >= vW || unsigned(y0) >= vH) {
-                closestEdgeIdx = min(closestEdgeIdx, idx-2);
-                break; // stop if outside of grid (exploit unsigned int overflow)
-              }
-              coordinates[idx++] = x0;
-              coordinates[idx++] = y0;
-              (*length)++;
-              // note: since endpoint is out of grid, no need to check if endpoint is reached
-              int e2 = 2 * err;
-              if (e2 >= dy) { err += dy; x0 += sx; }
-              if (e2 <= dx) { err += dx; y0 += sy; }
-            }
-          }
-  
-          // fill up the shorter line with missing coordinates, so block filling works correctly and efficiently
-          int diff = lineLength[0] - lineLength[1];
-          int longLineIdx = (diff > 0) ? 0 : 1;
-          int shortLineIdx = longLineIdx ? 0 : 1;
-          if (diff != 0) {
-            int idx = (lineLength[shortLineIdx] - 1) * 2; // last valid coordinate index
-            int lastX = lineCoords[shortLineIdx][idx++];
-            int lastY = lineCoords[shortLineIdx][idx++];
-            bool keepX = lastX == 0 || lastX == vW - 1;
-            for (int d = 0; d < abs(diff); d++) {
-              lineCoords[shortLineIdx][idx] = keepX ? lastX :lineCoords[longLineIdx][idx];
-              idx++;
-              lineCoords[shortLineIdx][idx] =  keepX ? lineCoords[longLineIdx][idx] : lastY;
-              idx++;
-            }
-          }
-  
+          int longLineIdx = getPinwheelEdges(i, vW, vH, lineCoords[0], lineCoords[1], lineLength, closestEdgeIdx);
+
           // draw and block-fill the line coordinates. Note: block filling only efficient if angle between lines is small
           closestEdgeIdx += 2;
           int max_i = getPinwheelLength(vW, vH) - 1;
@@ -959,11 +1369,25 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col) const
   }
 #endif
 
-  if (i >= vL || i < 0 || isPixelClipped(i)) return; // handle clipping on 1D
+  if (i >= vL || i < 0) return;
+#ifndef WLED_DISABLE_MODE_BLEND
+  // transition compositor: render into buffer, clipping/blending is done in compositeTransition()
+  if (_renderBuf) {
+    if (unsigned(i) < _renderLen) _renderBuf[i] = _colorScaled ? col : color_fade(col, _segBri);
+    return;
+  }
+#endif
+  if (isPixelClipped(i)) return; // handle clipping on 1D
 
-  unsigned len = length();
   // if color is unscaled
   if (!_colorScaled) col = color_fade(col, _segBri);
+  _setPixelColor_mapped(i, col);
+}
+
+// set virtual pixel (clipping and brightness have already been applied)
+void IRAM_ATTR_YN Segment::_setPixelColor_mapped(int i, uint32_t col) const
+{
+  unsigned len = length();
 
   // expand pixel (taking into account start, grouping, spacing [and offset])
   i = i * groupLength();
@@ -1059,7 +1483,7 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColor(int i) const
         break; }
       case M12_pArc:
         if (i >= vW && i >= vH) {
-          unsigned vI = sqrt32_bw(i*i/2);
+          unsigned vI = sqrt32_lut(i*i/2);
           return getPixelColorXY(vI,vI); // use diagonal
         }
       case M12_pCorner:
@@ -1095,7 +1519,11 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColor(int i) const
   }
 #endif
 
-  if (i >= vL || i < 0 || isPixelClipped(i)) return 0; // handle clipping on 1D
+  if (i >= vL || i < 0) return 0;
+#ifndef WLED_DISABLE_MODE_BLEND
+  if (_renderBuf) return unsigned(i) < _renderLen ? _renderBuf[i] : 0;
+#endif
+  if (isPixelClipped(i)) return 0; // handle clipping on 1D
 
   if (reverse) i = vL - i - 1;
   i *= groupLength();
@@ -1372,13 +1800,18 @@ void WS2812FX::finalizeInit() {
   //reset segment runtimes
   restartRuntime();
 
+  Segment::initTransitionArena(); // only allocated once, before buses (re)allocate memory
+  #ifdef SEGMENT_POOL_SIZE
+  Segment::initSegmentPool();
+  #endif
+
   // for the lack of better place enumerate ledmaps here
   // if we do it in json.cpp (serializeInfo()) we are getting flashes on LEDs
   // unfortunately this means we do not get updates after uploads
   // the other option is saving UI settings which will cause enumeration
   enumerateLedmaps();
 
-  _hasWhiteChannel = _isOffRefreshRequired = false;
+  _hasWhiteChannel = _isOffRefreshRequired = _isDithering = false;
 
   unsigned digitalCount = 0;
   #if defined(ARDUINO_ARCH_ESP32) && !defined(CONFIG_IDF_TARGET_ESP32C3)
@@ -1502,6 +1935,7 @@ void WS2812FX::finalizeInit() {
     _hasWhiteChannel |= bus->hasWhite();
     //refresh is required to remain off if at least one of the strips requires the refresh.
     _isOffRefreshRequired |= bus->isOffRefreshRequired() && !bus->isPWM(); // use refresh bit for phase shift with analog
+    _isDithering |= bus->isDithering();
     unsigned busEnd = bus->getStart() + bus->getLength();
     if (busEnd > _length) _length = busEnd;
 
@@ -1515,6 +1949,18 @@ void WS2812FX::finalizeInit() {
   Segment::maxHeight = 1;
 
   //segments are created in makeAutoSegments();
+  #ifdef WLED_PALETTE_CACHE
+  if (gradientPalettes.empty()) {
+    // expand built-in gradient palettes once
+    byte tcp[72];
+    CRGBPalette16 targetPalette;
+    gradientPalettes.reserve(GRADIENT_PALETTE_COUNT);
+    for (unsigned i = 0; i < GRADIENT_PALETTE_COUNT; i++) {
+      memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[i])), 72);
+      gradientPalettes.push_back(targetPalette.loadDynamicGradientPalette(tcp));
+    }
+  }
+  #endif
   DEBUG_PRINTLN(F("Loading custom palettes"));
   loadCustomPalettes(); // (re)load all custom palettes
   DEBUG_PRINTLN(F("Loading custom ledmaps"));
@@ -1531,8 +1977,11 @@ void WS2812FX::service() {
   if ( !_triggered && (_targetFps != FPS_UNLIMITED)) {                           // unlimited mode = no frametime
     if (elapsed < _frametime) return;                                            // too early for service
   }
+  if (!_triggered && !BusManager::canAllShow()) return;                          // buses still busy with last frame, do not block in show()
 
   bool doShow = false;
+  const bool triggered = _triggered;
+  unsigned long maxLate = 0;                                                     // how late (ms) the most delayed segment started
 
   _isServicing = true;
   _segment_index = 0;
@@ -1552,6 +2001,10 @@ void WS2812FX::service() {
     {
       doShow = true;
       unsigned frameDelay = FRAMETIME;
+      // delay vs. deadline (0 if rendered early), ignore fresh effects and long pauses (i.e. strip was off)
+      unsigned long late = (!triggered && nowUp >= seg.next_time && seg.call) ? nowUp - seg.next_time : 0;
+      if (late >= 1000) late = 0;
+      if (late > maxLate) maxLate = late;
 
       if (!seg.freeze) { //only run effect function if not frozen
         int oldCCT = BusManager::getSegmentCCT(); // store original CCT value (actually it is not Segment based)
@@ -1563,8 +2016,8 @@ void WS2812FX::service() {
         // When two effects are being blended, each may have different segment data, this
         // data needs to be saved first and then restored before running previous mode.
         // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
-        // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
-        // would need to be allocated for each effect and then blended together for each pixel.
+        // overwritten by later effect. To enable seamless blending for every effect, each effect can render
+        // into its own buffer which are then blended together for each pixel (useTransitionBuffers).
         seg.beginDraw();                      // set up parameters for get/setPixelColor()
 #ifndef WLED_DISABLE_MODE_BLEND
         Segment::setClippingRect(0, 0); // disable clipping (just in case)
@@ -1574,6 +2027,8 @@ void WS2812FX::service() {
           Segment::modeBlend(true);           // set semaphore
           bool     sameEffect = (m == seg.currentMode());
           Segment::modeBlend(false);          // clear semaphore
+          // render each mode into its own buffer if possible (see allocTransitionBuffers())
+          bool     useComposite = useTransitionBuffers && seg.allocTransitionBuffers();
           // set clipping rectangle
           // new mode is run inside clipping area and old mode outside clipping area
           unsigned p = seg.progress();
@@ -1641,16 +2096,19 @@ void WS2812FX::service() {
               Segment::setClippingRect(0, dw, h - dh, h);
               break;
           }
+          if (useComposite) seg.renderToTransitionBuffer(false);
           frameDelay = (*_mode[m])();         // run new/current mode
           // now run old/previous mode
           Segment::tmpsegd_t _tmpSegData;
           Segment::modeBlend(true);           // set semaphore
           seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
           seg.beginDraw();                    // set up parameters for get/setPixelColor()
+          if (useComposite) seg.renderToTransitionBuffer(true);
           frameDelay = min(frameDelay, (unsigned)(*_mode[seg.currentMode()])());  // run old mode
           seg.call++;                         // increment old mode run counter
           seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
           Segment::modeBlend(false);          // unset semaphore
+          if (useComposite) seg.compositeTransition(); // blend both buffers into LEDs
           blendingStyle = orgBS;              // restore blending style if it was modified for single pixel segment
         } else
 #endif
@@ -1660,7 +2118,11 @@ void WS2812FX::service() {
         BusManager::setSegmentCCT(oldCCT); // restore old CCT for ABL adjustments
       }
 
-      seg.next_time = nowUp + frameDelay;
+      // keep steady cadence by scheduling from the deadline instead of actual start time
+      // if more than a step late (overload) drop missed steps rather than rendering them back-to-back
+      if (late == 0)                               seg.next_time = nowUp + frameDelay;
+      else if (late < frameDelay || !frameDelay)   seg.next_time += frameDelay;
+      else { _stepsSkipped += late / frameDelay;   seg.next_time = nowUp + frameDelay; }
     }
     _segment_index++;
   }
@@ -1671,12 +2133,25 @@ void WS2812FX::service() {
   #ifdef WLED_DEBUG
   if ((_targetFps != FPS_UNLIMITED) && (millis() - nowUp > _frametime)) DEBUG_PRINTF_P(PSTR("Slow effects %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
   #endif
-  if (doShow) {
+  // dithered buses produce a different output each frame (use unlimited FPS for best results)
+  if (doShow || (_isDithering && _brightness)) {
     yield();
     Segment::handleRandomPalette(); // slowly transition random palette; move it into for loop when each segment has individual random palette
-    _lastServiceShow = nowUp; // update timestamp, for precise FPS control
+    // advance frame slot by one period for steady cadence (unless triggered, after a pause or overloaded)
+    if (!triggered && _targetFps != FPS_UNLIMITED && millis() - _lastServiceShow < 2U*_frametime) _lastServiceShow += _frametime;
+    else _lastServiceShow = nowUp;
+    // frame pacing statistics, a frame is missed if it started a frame period (or more) after its deadline
+    _lateAvg = (_lateAvg * 15U + (maxLate << 4)) >> 4;
+    if (maxLate > _lateMax) _lateMax = maxLate;
+    if (_targetFps != FPS_UNLIMITED && maxLate >= _frametime) _framesMissed++;
     if (!_suspend) show();
   }
+
+  // next deadline is the earliest active segment due, but not before next frame slot
+  unsigned long deadline = nowUp + 1000;
+  for (const segment &seg : _segments) if (seg.isActive() && (long)(seg.next_time - deadline) < 0) deadline = seg.next_time;
+  if ((long)(_lastServiceShow + _frametime - deadline) > 0) deadline = _lastServiceShow + _frametime;
+  _nextDeadline = deadline;
   #ifdef WLED_DEBUG
   if ((_targetFps != FPS_UNLIMITED) && (millis() - nowUp > _frametime)) DEBUG_PRINTF_P(PSTR("Slow strip %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
   #endif
@@ -1714,6 +2189,14 @@ void WS2812FX::show() {
   }
 }
 
+// used by WLED::loop() to sleep instead of polling service() until next frame is due
+unsigned WS2812FX::getTimeToNextFrame() const {
+  if (_triggered || _isDithering || _suspend) return 0;
+  long wait = (long)(_nextDeadline - millis());
+  if (wait <= 0 && !BusManager::canAllShow()) wait = 1; // due, but service() waits for buses to finish sending last frame
+  return wait > 0 ? wait : 0;
+}
+
 void WS2812FX::setTargetFps(unsigned fps) {
   if (fps <= 250) _targetFps = fps;
   if (_targetFps > 0) _frametime = 1000 / _targetFps;
@@ -1827,7 +2310,9 @@ bool WS2812FX::hasCCTBus() const {
   return false;
 }
 
-void WS2812FX::purgeSegments() {
+// vector capacity is kept unless shrink is requested (low heap): reallocating it on every preset/playlist change
+// would leave holes of sizeof(Segment)*n bytes in the heap
+void WS2812FX::purgeSegments(bool shrink) {
   // remove all inactive segments (from the back)
   int deleted = 0;
   if (_segments.size() <= 1) return;
@@ -1837,7 +2322,7 @@ void WS2812FX::purgeSegments() {
       _segments.erase(_segments.begin() + i);
     }
   if (deleted) {
-    _segments.shrink_to_fit();
+    if (shrink) _segments.shrink_to_fit();
     setMainSegmentId(0);
   }
 }
@@ -1846,7 +2331,7 @@ Segment& WS2812FX::getSegment(unsigned id) {
   return _segments[id >= _segments.size() ? getMainSegmentId() : id]; // vectors
 }
 
-void WS2812FX::resetSegments() {
+void WS2812FX::resetSegments(bool shrink) {
   _segments.clear(); // destructs all Segment as part of clearing
   #ifndef WLED_DISABLE_2D
   segment seg = isMatrix ? Segment(0, Segment::maxWidth, 0, Segment::maxHeight) : Segment(0, _length);
@@ -1854,7 +2339,7 @@ void WS2812FX::resetSegments() {
   segment seg = Segment(0, _length);
   #endif
   _segments.push_back(seg);
-  _segments.shrink_to_fit(); // just in case ...
+  if (shrink) _segments.shrink_to_fit();
   _mainSegment = 0;
 }
 
@@ -1996,11 +2481,69 @@ void WS2812FX::printSize() {
 }
 #endif
 
-void WS2812FX::loadCustomPalettes() {
+// binary cache of custom palettes (expanded CRGBPalette16 form) so JSON files need not be parsed on every boot
+// cache holds one record per /paletteN.json file (N = 0,1,2,... without gaps), it is valid if all files still
+// exist with recorded sizes and there is no additional file; it is rebuilt when a palette file is uploaded/removed
+#define PALETTE_CACHE_MAGIC   0x4C415057 // "WPAL"
+#define PALETTE_CACHE_VERSION 1
+static const char s_palette_cache[] PROGMEM = "/palettes.bin";
+
+typedef struct PaletteCacheRecord {
+  uint32_t fileSize;    // size of JSON file the palette was parsed from
+  uint8_t  valid;       // JSON file contained a usable palette
+  CRGB     entries[16];
+} palcache_t;
+
+typedef struct PaletteCacheHeader {
+  uint32_t magic;
+  uint8_t  version;
+  uint8_t  recSize;     // sizeof(palcache_t) (guards against layout changes)
+  uint16_t count;       // number of records (palette files)
+} palcachehdr_t;
+
+static size_t paletteFileSize(unsigned index) {
+  char fileName[32];
+  sprintf_P(fileName, PSTR("/palette%d.json"), index);
+  if (!WLED_FS.exists(fileName)) return 0;
+  File f = WLED_FS.open(fileName, "r");
+  if (!f) return 0;
+  size_t size = f.size();
+  f.close();
+  return size;
+}
+
+// returns false if cache does not exist or is stale (customPalettes is left empty then)
+static bool readPaletteCache(std::vector<CRGBPalette16> &palettes) {
+  File f = WLED_FS.open(FPSTR(s_palette_cache), "r");
+  if (!f) return false;
+  palcachehdr_t hdr;
+  bool valid = f.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) && hdr.magic == PALETTE_CACHE_MAGIC && hdr.version == PALETTE_CACHE_VERSION
+            && hdr.recSize == sizeof(palcache_t) && hdr.count <= WLED_MAX_CUSTOM_PALETTES
+            && (hdr.count == WLED_MAX_CUSTOM_PALETTES || paletteFileSize(hdr.count) == 0); // no new palette file
+  for (unsigned i = 0; valid && i < hdr.count; i++) {
+    palcache_t rec;
+    valid = f.read((uint8_t*)&rec, sizeof(rec)) == sizeof(rec) && rec.fileSize > 0 && rec.fileSize == paletteFileSize(i);
+    if (valid && rec.valid) palettes.push_back(CRGBPalette16(rec.entries));
+  }
+  f.close();
+  if (!valid) palettes.clear();
+  return valid;
+}
+
+void WS2812FX::loadCustomPalettes(bool rebuild) {
   byte tcp[72]; //support gradient palettes with up to 18 entries
   CRGBPalette16 targetPalette;
   customPalettes.clear(); // start fresh
-  for (int index = 0; index<10; index++) {
+  if (!rebuild && readPaletteCache(customPalettes)) {
+    DEBUG_PRINTF_P(PSTR("Custom palettes loaded from cache: %u\n"), customPalettes.size());
+    return;
+  }
+
+  File cache = WLED_FS.open(FPSTR(s_palette_cache), "w");
+  palcachehdr_t hdr = {PALETTE_CACHE_MAGIC, PALETTE_CACHE_VERSION, sizeof(palcache_t), 0};
+  if (cache) cache.write((const uint8_t*)&hdr, sizeof(hdr)); // placeholder, count is updated at the end
+
+  for (unsigned index = 0; index < WLED_MAX_CUSTOM_PALETTES; index++) {
     char fileName[32];
     sprintf_P(fileName, PSTR("/palette%d.json"), index);
 
@@ -2009,6 +2552,9 @@ void WS2812FX::loadCustomPalettes() {
       DEBUG_PRINT(F("Reading palette from "));
       DEBUG_PRINTLN(fileName);
 
+      palcache_t rec;
+      memset((void*)&rec, 0, sizeof(rec));
+      rec.fileSize = paletteFileSize(index);
       if (readObjectFromFile(fileName, nullptr, &pDoc)) {
         JsonArray pal = pDoc[F("palette")];
         if (!pal.isNull() && pal.size()>3) { // not an empty palette (at least 2 entries)
@@ -2035,14 +2581,24 @@ void WS2812FX::loadCustomPalettes() {
             }
           }
           customPalettes.push_back(targetPalette.loadDynamicGradientPalette(tcp));
+          memcpy(rec.entries, targetPalette.entries, sizeof(rec.entries));
+          rec.valid = true;
         } else {
           DEBUG_PRINTLN(F("Wrong palette format."));
         }
       }
+      if (cache) cache.write((const uint8_t*)&rec, sizeof(rec));
+      hdr.count++;
     } else {
       break;
     }
   }
+
+  if (cache) {
+    cache.seek(0);
+    cache.write((const uint8_t*)&hdr, sizeof(hdr));
+    cache.close();
+  }
 }
 
 //load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef WLED_BUS_ENCODE_H
+#define WLED_BUS_ENCODE_H
+/*
+ * Encoding of double buffered digital buses into NeoPixelBus buffer (see BusDigital::show())
+ *
+ * BusDirtyRange keeps track of pixels changed since last show() so only those are encoded again. NeoPixelBus with
+ * separate edit and send buffers (ESP32 RMT, I2S) swaps them on show() unless asked to keep them consistent, so after
+ * an inconsistent show() the edit buffer holds an old frame and everything has to be encoded on the next one.
+ * ditherPixel() is the per pixel step of temporal dithering.
+ */
+
+#include <stdint.h>
+
+typedef struct {
+  uint16_t from, to;    // pixels to encode [from, to), empty if from >= to
+  bool     consistent;  // NeoPixelBus has to keep its buffer consistent (only part of it is encoded)
+} BusEncodeRange;
+
+class BusDirtyRange {
+  public:
+    explicit BusDirtyRange(uint16_t len = 0) : _start(0), _end(len), _len(len), _bri(0), _cctBlend(0), _stale(true) {}
+
+    inline void mark(unsigned pix) {
+      if (pix <  _start) _start = pix;
+      if (pix >= _end)   _end   = pix + 1;
+    }
+
+    // NeoPixelBus buffer content is lost or was encoded differently (i.e. color order changed)
+    void invalidate() { _stale = true; }
+
+    // range to encode for show(): only changed pixels, unless everything needs to be re-encoded because brightness or
+    // CCT blending (applied when encoding) changed, buffer was swapped on last show() or all is set (i.e. dithering)
+    // group: pixels are encoded in groups of this size (TYPE_WS2812_1CH_X3: each IC controls 3 LEDs)
+    BusEncodeRange next(uint8_t bri, uint8_t cctBlend, bool all = false, unsigned group = 1) {
+      const bool consistent = (_start > 0 || _end < _len) && !all;
+      if (bri != _bri || cctBlend != _cctBlend || _stale || all) {
+        _start = 0;
+        _end   = _len;
+      }
+      if (group > 1) {
+        _start -= _start % group;
+        _end   += (group - _end % group) % group;
+      }
+      const BusEncodeRange r = {_start, _end < _len ? _end : _len, consistent};
+      _bri      = bri;
+      _cctBlend = cctBlend;
+      _stale    = !consistent;
+      _start    = _len;
+      _end      = 0;
+      return r;
+    }
+
+    uint8_t encodedBri() const { return _bri; } // brightness pixels were last encoded with
+
+  private:
+    uint16_t _start, _end;  // range of changed pixels (empty if start >= end)
+    uint16_t _len;
+    uint8_t  _bri;          // brightness pixels were encoded with
+    uint8_t  _cctBlend;     // CCT blending pixels were encoded with
+    bool     _stale;        // NeoPixelBus buffer was shown without keeping consistency
+};
+
+// temporal dithering: scale by brightness to 16 bit and carry the lower byte of each channel over to the next frame
+// (same scaling as NeoPixelBusLg luminance) so that averaged over several frames output matches unscaled value
+// instead of being truncated to 8 bit, this keeps color resolution and smooth fades at low brightness
+// data and err point to chans bytes (R, G, B[, W]), returns scaled pixel as WRGB
+template<unsigned chans>
+inline uint32_t ditherPixel(const uint8_t *data, uint8_t *err, uint8_t bri) {
+  const unsigned scale = bri ? bri + 1 : 0; // no residual light when off
+  uint8_t out[4] = {0, 0, 0, 0};
+  for (unsigned ch = 0; ch < chans; ch++) {
+    unsigned v = data[ch] * scale + err[ch]; // max 255*256 + 255
+    out[ch] = v >> 8;
+    err[ch] = v & 0xFF;
+  }
+  return uint32_t(out[3]) << 24 | uint32_t(out[0]) << 16 | uint32_t(out[1]) << 8 | out[2];
+}
+
+#endif
@@ -24,12 +24,13 @@
 #include "bus_manager.h"
 #include "bus_wrapper.h"
 #include <bits/unique_ptr.h>
+#include <algorithm>
 
 extern bool cctICused;
 extern bool useParallelI2S;
 
 //colors.cpp
-uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb);
+void colorKtoRGB(uint16_t kelvin, byte* rgb);
 
 //udp.cpp
 uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, const uint8_t* buffer, uint8_t bri=255, bool isRGBW=false);
@@ -61,6 +62,24 @@ uint8_t IRAM_ATTR ColorOrderMap::getPixelColorOrder(uint16_t pix, uint8_t defaul
   return defaultColorOrder;
 }
 
+void ColorOrderMap::getColorOrderRuns(uint16_t start, uint16_t len, uint8_t defaultColorOrder, std::vector<ColorOrderRun> &runs) const {
+  // color order can only change at mapping boundaries, so only these need to be resolved
+  std::vector<uint16_t> bounds;
+  bounds.reserve(2*count() + 1);
+  bounds.push_back(0);
+  for (const auto& map : _mappings) {
+    unsigned mapEnd = map.start + map.len;
+    if (map.start > start && map.start < start + len) bounds.push_back(map.start - start);
+    if (mapEnd    > start && mapEnd    < start + len) bounds.push_back(mapEnd - start);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  runs.clear();
+  for (uint16_t b : bounds) {
+    uint8_t co = getPixelColorOrder(start + b, defaultColorOrder);
+    if (runs.empty() || runs.back().colorOrder != co) runs.push_back({b, co});
+  }
+}
+
 
 void Bus::calculateCCT(uint32_t c, uint8_t &ww, uint8_t &cw) {
   unsigned cct = 0; //0 - full warm white, 255 - full cold white
@@ -99,6 +118,21 @@ uint32_t Bus::autoWhiteCalc(uint32_t c) const {
   return RGBW32(r, g, b, w);
 }
 
+// same as colorBalanceFromKelvin() but without per pixel multiplication & division
+void Bus::calcWhiteBalanceLUT(uint16_t kelvin) {
+  byte correctionRGB[4];
+  colorKtoRGB(kelvin, correctionRGB);
+  for (unsigned ch = 0; ch < 3; ch++) {
+    unsigned acc = 0;
+    for (unsigned i = 0; i < 256; i++, acc += correctionRGB[ch]) _wbLUT[ch][i] = acc / 255;
+  }
+  _wbKelvin = kelvin;
+}
+
+uint32_t IRAM_ATTR Bus::whiteBalance(uint32_t c) {
+  return RGBW32(_wbLUT[0][R(c)], _wbLUT[1][G(c)], _wbLUT[2][B(c)], W(c));
+}
+
 
 BusDigital::BusDigital(const BusConfig &bc, uint8_t nr)
 : Bus(bc.type, bc.start, bc.autoWhite, bc.count, bc.reversed, (bc.refreshReq || bc.type == TYPE_TM1814))
@@ -107,6 +141,11 @@ BusDigital::BusDigital(const BusConfig &bc, uint8_t nr)
 , _milliAmpsPerLed(bc.milliAmpsPerLed)
 , _milliAmpsMax(bc.milliAmpsMax)
 , _data(nullptr)
+, _ditherErr(nullptr)
+, _dirty(bc.count)
+, _busColorOrder(bc.colorOrder)
+, _writePixel(nullptr)
+, _setPixel(&BusDigital::setPixelGeneric)
 {
   DEBUGBUS_PRINTLN(F("Bus: Creating digital bus."));
   if (!isDigital(bc.type) || !bc.count) { DEBUGBUS_PRINTLN(F("Not digial or empty bus!")); return; }
@@ -127,9 +166,22 @@ BusDigital::BusDigital(const BusConfig &bc, uint8_t nr)
   _hasRgb = hasRGB(bc.type);
   _hasWhite = hasWhite(bc.type);
   _hasCCT = hasCCT(bc.type);
-  if (bc.doubleBuffer) {
+  // select per-pixel path once instead of checking bus type for every pixel
+  if (_hasRgb && !_hasCCT && bc.type != TYPE_WS2812_1CH_X3) _writePixel = PolyBus::getPixelWriter(_iType);
+  // temporal dithering is only supported on plain 8 bit RGB/RGBW buses, it needs unscaled pixel values (_data)
+  bool dither = bc.dither && _writePixel;
+  if (bc.doubleBuffer || dither) {
     _data = (uint8_t*)calloc(_len, Bus::getNumberOfChannels(_type));
     if (!_data) DEBUGBUS_PRINTLN(F("Bus: Buffer allocation failed!"));
+    else if (dither) {
+      _ditherErr = (uint8_t*)calloc(_len, Bus::getNumberOfChannels(_type));
+      if (!_ditherErr) DEBUGBUS_PRINTLN(F("Bus: Dither buffer allocation failed!"));
+    }
+  }
+  buildColorOrderRuns();
+  if (_writePixel) {
+    if (_data) _setPixel = _hasWhite ? &BusDigital::setPixelBuffered<4> : &BusDigital::setPixelBuffered<3>;
+    else       _setPixel = _hasWhite ? &BusDigital::setPixelDirect<true> : &BusDigital::setPixelDirect<false>;
   }
   uint16_t lenToCreate = bc.count;
   if (bc.type == TYPE_WS2812_1CH_X3) lenToCreate = NUM_ICS_WS2812_1CH_3X(bc.count); // only needs a third of "RGB" LEDs for NeoPixelBus
@@ -212,42 +264,22 @@ void BusDigital::show() {
 
   uint8_t cctWW = 0, cctCW = 0;
   unsigned newBri = estimateCurrentAndLimitBri();  // will fill _milliAmpsTotal (TODO: could use PolyBus::CalcTotalMilliAmpere())
-  if (newBri < _bri) PolyBus::setBrightness(_busPtr, _iType, newBri); // limit brightness to stay within current limits
+  // when dithering brightness is applied while encoding, NeoPixelBus luminance stays at 255
+  if (newBri < _bri && !_ditherErr) PolyBus::setBrightness(_busPtr, _iType, newBri); // limit brightness to stay within current limits
 
+  bool consistent = !_data; // faster if buffer consistency is not important
   if (_data) {
-    size_t channels = getNumberOfChannels();
     int16_t oldCCT = Bus::_cct; // temporarily save bus CCT
-    for (size_t i=0; i<_len; i++) {
-      size_t offset = i * channels;
-      unsigned co = _colorOrderMap.getPixelColorOrder(i+_start, _colorOrder);
-      uint32_t c;
-      if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3)
-        switch (i%3) {
-          case 0: c = RGBW32(_data[offset]  , _data[offset+1], _data[offset+2], 0); break;
-          case 1: c = RGBW32(_data[offset-1], _data[offset]  , _data[offset+1], 0); break;
-          case 2: c = RGBW32(_data[offset-2], _data[offset-1], _data[offset]  , 0); break;
-        }
-      } else {
-        if (hasRGB()) c = RGBW32(_data[offset], _data[offset+1], _data[offset+2], hasWhite() ? _data[offset+3] : 0);
-        else          c = RGBW32(0, 0, 0, _data[offset]);
-      }
-      if (hasCCT()) {
-        // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
-        // we need to extract and appy CCT value for each pixel individually even though all buses share the same _cct variable
-        // TODO: there is an issue if CCT is calculated from RGB value (_cct==-1), we cannot do that with double buffer
-        Bus::_cct = _data[offset+channels-1];
-        Bus::calculateCCT(c, cctWW, cctCW);
-        if (_type == TYPE_WS2812_WWA) c = RGBW32(cctWW, cctCW, 0, W(c)); // may need swapping
-      }
-      unsigned pix = i;
-      if (_reversed) pix = _len - pix -1;
-      pix += _skip;
-      PolyBus::setPixelColor(_busPtr, _iType, pix, c, co, (cctCW<<8) | cctWW);
-    }
+    // only re-encode pixels that changed since last show() (see bus_encode.h), if only a part was encoded NeoPixelBus
+    // has to keep its buffer consistent (less work than encoding all pixels)
+    // dithered output changes every frame, so all pixels need encoding; each WS2812_1CH_X3 IC controls 3 LEDs
+    const BusEncodeRange r = _dirty.next(newBri, Bus::_cctBlend, _ditherErr != nullptr, _type == TYPE_WS2812_1CH_X3 ? 3 : 1);
+    consistent = r.consistent;
+    if (r.from < r.to) encodePixels(r.from, r.to, cctWW, cctCW);
     #if !defined(STATUSLED) || STATUSLED>=0
-    if (_skip) PolyBus::setPixelColor(_busPtr, _iType, 0, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
+    if (_skip) PolyBus::setPixelColor(_busPtr, _iType, 0, 0, getColorOrderAt(0)); // paint skipped pixels black
     #endif
-    for (int i=1; i<_skip; i++) PolyBus::setPixelColor(_busPtr, _iType, i, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
+    for (int i=1; i<_skip; i++) PolyBus::setPixelColor(_busPtr, _iType, i, 0, getColorOrderAt(0)); // paint skipped pixels black
     Bus::_cct = oldCCT;
   } else {
     if (newBri < _bri) {
@@ -261,11 +293,111 @@ void BusDigital::show() {
       }
     }
   }
-  PolyBus::show(_busPtr, _iType, !_data); // faster if buffer consistency is not important
+  PolyBus::show(_busPtr, _iType, consistent);
   // restore bus brightness to its original value
   // this is done right after show, so this is only OK if LED updates are completed before show() returns
   // or async show has a separate buffer (ESP32 RMT and I2S are ok)
-  if (newBri < _bri) PolyBus::setBrightness(_busPtr, _iType, _bri);
+  if (newBri < _bri && !_ditherErr) PolyBus::setBrightness(_busPtr, _iType, _bri);
+}
+
+// encode pixels [from, to) from _data into NeoPixelBus buffer, color order is taken from run table
+void BusDigital::encodePixels(unsigned from, unsigned to, uint8_t &cctWW, uint8_t &cctCW) {
+  unsigned run = findColorOrderRun(from);
+  while (from < to) {
+    unsigned runEnd = run + 1 < _coRuns.size() ? _coRuns[run + 1].start : _len;
+    uint8_t  co     = _coRuns.empty() ? _busColorOrder : _coRuns[run].colorOrder;
+    unsigned end    = std::min(to, runEnd);
+    if (_ditherErr) {
+      if (hasWhite()) encodeDither<4>(from, end, co);
+      else            encodeDither<3>(from, end, co);
+    } else if (_writePixel) {
+      if (hasWhite()) encodePlain<4>(from, end, co);
+      else            encodePlain<3>(from, end, co);
+    } else encodeGeneric(from, end, co, cctWW, cctCW);
+    from = end;
+    run++;
+  }
+}
+
+// plain RGB/RGBW pixels with the same color order, no per pixel type checks
+template<unsigned chans>
+void BusDigital::encodePlain(unsigned from, unsigned to, uint8_t co) {
+  const PixelWriter writePixel = _writePixel;
+  const uint8_t *data = _data + from * chans;
+  for (unsigned i = from; i < to; i++, data += chans) {
+    uint32_t c = RGBW32(data[0], data[1], data[2], chans > 3 ? data[3] : 0);
+    unsigned pix = _reversed ? _len - i - 1 : i;
+    writePixel(_busPtr, pix + _skip, c, co, 0);
+  }
+}
+
+// temporal dithering (see ditherPixel()), brightness is applied here instead of by NeoPixelBus
+template<unsigned chans>
+void BusDigital::encodeDither(unsigned from, unsigned to, uint8_t co) {
+  const PixelWriter writePixel = _writePixel;
+  const uint8_t bri = _dirty.encodedBri();
+  const uint8_t *data = _data + from * chans;
+  uint8_t       *err  = _ditherErr + from * chans;
+  for (unsigned i = from; i < to; i++, data += chans, err += chans) {
+    unsigned pix = _reversed ? _len - i - 1 : i;
+    writePixel(_busPtr, pix + _skip, ditherPixel<chans>(data, err, bri), co, 0);
+  }
+}
+
+void BusDigital::encodeGeneric(unsigned from, unsigned to, uint8_t co, uint8_t &cctWW, uint8_t &cctCW) {
+  const size_t channels = getNumberOfChannels();
+  for (size_t i = from; i < to; i++) {
+    size_t offset = i * channels;
+    uint32_t c;
+    if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs (_len is always a multiple of 3)
+      switch (i%3) {
+        case 0: c = RGBW32(_data[offset]  , _data[offset+1], _data[offset+2], 0); break;
+        case 1: c = RGBW32(_data[offset-1], _data[offset]  , _data[offset+1], 0); break;
+        case 2: c = RGBW32(_data[offset-2], _data[offset-1], _data[offset]  , 0); break;
+      }
+    } else {
+      if (hasRGB()) c = RGBW32(_data[offset], _data[offset+1], _data[offset+2], hasWhite() ? _data[offset+3] : 0);
+      else          c = RGBW32(0, 0, 0, _data[offset]);
+    }
+    if (hasCCT()) {
+      // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
+      // we need to extract and appy CCT value for each pixel individually even though all buses share the same _cct variable
+      // TODO: there is an issue if CCT is calculated from RGB value (_cct==-1), we cannot do that with double buffer
+      Bus::_cct = _data[offset+channels-1];
+      Bus::calculateCCT(c, cctWW, cctCW);
+      if (_type == TYPE_WS2812_WWA) c = RGBW32(cctWW, cctCW, 0, W(c)); // may need swapping
+    }
+    unsigned pix = i;
+    if (_reversed) pix = _len - pix -1;
+    pix += _skip;
+    PolyBus::setPixelColor(_busPtr, _iType, pix, c, co, (cctCW<<8) | cctWW);
+  }
+}
+
+// color order of the bus pixels as sorted runs (instead of searching ColorOrderMap for every pixel on every frame)
+// if the whole bus has a single color order no lookup is needed at all
+void BusDigital::buildColorOrderRuns() {
+  _colorOrderMap.getColorOrderRuns(_start, _len, _colorOrder, _coRuns);
+  _busColorOrder = _coRuns.empty() ? _colorOrder : _coRuns[0].colorOrder;
+  if (_coRuns.size() < 2) _coRuns.clear();
+  _coRuns.shrink_to_fit();
+  _dirty.invalidate();
+}
+
+// index of color order run containing pixel pix (binary search)
+unsigned BusDigital::findColorOrderRun(unsigned pix) const {
+  unsigned lo = 0, hi = _coRuns.size();
+  while (hi - lo > 1) {
+    unsigned mid = (lo + hi) / 2;
+    if (_coRuns[mid].start <= pix) lo = mid;
+    else                           hi = mid;
+  }
+  return lo;
+}
+
+uint8_t IRAM_ATTR BusDigital::getColorOrderAt(unsigned pix) const {
+  if (_coRuns.empty()) return _busColorOrder;
+  return _coRuns[findColorOrderRun(pix)].colorOrder;
 }
 
 bool BusDigital::canShow() const {
@@ -276,25 +408,55 @@ bool BusDigital::canShow() const {
 void BusDigital::setBrightness(uint8_t b) {
   if (_bri == b) return;
   Bus::setBrightness(b);
-  PolyBus::setBrightness(_busPtr, _iType, b);
+  if (!_ditherErr) PolyBus::setBrightness(_busPtr, _iType, b); // dithering applies brightness when encoding
 }
 
 //If LEDs are skipped, it is possible to use the first as a status LED.
 //TODO only show if no new show due in the next 50ms
 void BusDigital::setStatusPixel(uint32_t c) {
   if (_valid && _skip) {
-    PolyBus::setPixelColor(_busPtr, _iType, 0, c, _colorOrderMap.getPixelColorOrder(_start, _colorOrder));
+    PolyBus::setPixelColor(_busPtr, _iType, 0, c, getColorOrderAt(0));
     if (canShow()) PolyBus::show(_busPtr, _iType);
   }
 }
 
 void IRAM_ATTR BusDigital::setPixelColor(unsigned pix, uint32_t c) {
   if (!_valid) return;
+  (this->*_setPixel)(pix, c);
+}
+
+// plain RGB/RGBW bus without buffer, written directly into NeoPixelBus buffer
+template<bool white>
+void BusDigital::setPixelDirect(unsigned pix, uint32_t c) {
+  if (white) c = autoWhiteCalc(c);
+  if (Bus::_cct >= 1900) c = whiteBalance(c); //color correction from CCT
+  const uint8_t co = getColorOrderAt(pix);
+  if (_reversed) pix = _len - pix -1;
+  pix += _skip;
+  _writePixel(_busPtr, pix, c, co, 0);
+}
+
+// plain RGB/RGBW bus with buffer, only changed pixels need to be re-encoded in show()
+template<unsigned chans>
+void BusDigital::setPixelBuffered(unsigned pix, uint32_t c) {
+  if (chans > 3) c = autoWhiteCalc(c);
+  if (Bus::_cct >= 1900) c = whiteBalance(c); //color correction from CCT
+  const uint8_t pixel[4] = {R(c), G(c), B(c), W(c)};
+  uint8_t* pixptr = _data + pix * chans;
+  if (memcmp(pixptr, pixel, chans) != 0) {
+    memcpy(pixptr, pixel, chans);
+    _dirty.mark(pix);
+  }
+}
+
+// all other bus types (CCT, WWA, 1CH_X3, white only)
+void IRAM_ATTR BusDigital::setPixelGeneric(unsigned pix, uint32_t c) {
   if (hasWhite()) c = autoWhiteCalc(c);
-  if (Bus::_cct >= 1900) c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
+  if (Bus::_cct >= 1900) c = whiteBalance(c); //color correction from CCT
   if (_data) {
-    size_t offset = pix * getNumberOfChannels();
-    uint8_t* dataptr = _data + offset;
+    const size_t channels = getNumberOfChannels();
+    uint8_t  pixel[5];
+    uint8_t* dataptr = pixel;
     if (hasRGB()) {
       *dataptr++ = R(c);
       *dataptr++ = G(c);
@@ -304,10 +466,15 @@ void IRAM_ATTR BusDigital::setPixelColor(unsigned pix, uint32_t c) {
     // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
     // we need to store CCT value for each pixel (if there is a color correction in play, convert K in CCT ratio)
     if (hasCCT()) *dataptr = Bus::_cct >= 1900 ? (Bus::_cct - 1900) >> 5 : (Bus::_cct < 0 ? 127 : Bus::_cct); // TODO: if _cct == -1 we simply ignore it
+    uint8_t* pixptr = _data + pix * channels;
+    if (memcmp(pixptr, pixel, channels) != 0) { // only changed pixels need to be re-encoded in show()
+      memcpy(pixptr, pixel, channels);
+      _dirty.mark(pix);
+    }
   } else {
+    const unsigned co = getColorOrderAt(pix);
     if (_reversed) pix = _len - pix -1;
     pix += _skip;
-    unsigned co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
     if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
       unsigned pOld = pix;
       pix = IC_INDEX_WS2812_1CH_3X(pix);
@@ -342,9 +509,9 @@ uint32_t IRAM_ATTR BusDigital::getPixelColor(unsigned pix) const {
     }
     return c;
   } else {
+    const unsigned co = getColorOrderAt(pix);
     if (_reversed) pix = _len - pix -1;
     pix += _skip;
-    const unsigned co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
     uint32_t c = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, (_type==TYPE_WS2812_1CH_X3) ? IC_INDEX_WS2812_1CH_3X(pix) : pix, co),_bri);
     if (_type == TYPE_WS2812_1CH_X3) { // map to correct IC, each controls 3 LEDs
       unsigned r = R(c);
@@ -371,13 +538,14 @@ unsigned BusDigital::getPins(uint8_t* pinArray) const {
 }
 
 unsigned BusDigital::getBusSize() const {
-  return sizeof(BusDigital) + (isOk() ? PolyBus::getDataSize(_busPtr, _iType) + (_data ? _len * getNumberOfChannels() : 0) : 0);
+  return sizeof(BusDigital) + (isOk() ? PolyBus::getDataSize(_busPtr, _iType) + (_data ? _len * getNumberOfChannels() : 0) + (_ditherErr ? _len * getNumberOfChannels() : 0) : 0);
 }
 
 void BusDigital::setColorOrder(uint8_t colorOrder) {
   // upper nibble contains W swap information
   if ((colorOrder & 0x0F) > 5) return;
   _colorOrder = colorOrder;
+  buildColorOrderRuns();
 }
 
 // credit @willmmiles & @netmindz https://github.com/wled-dev/WLED/pull/4056
@@ -415,7 +583,9 @@ void BusDigital::cleanup() {
   DEBUGBUS_PRINTLN(F("Digital Cleanup."));
   PolyBus::cleanup(_busPtr, _iType);
   free(_data);
+  free(_ditherErr);
   _data = nullptr;
+  _ditherErr = nullptr;
   _iType = I_NONE;
   _valid = false;
   _busPtr = nullptr;
@@ -498,7 +668,7 @@ void BusPwm::setPixelColor(unsigned pix, uint32_t c) {
   if (pix != 0 || !_valid) return; //only react to first pixel
   if (_type != TYPE_ANALOG_3CH) c = autoWhiteCalc(c);
   if (Bus::_cct >= 1900 && (_type == TYPE_ANALOG_3CH || _type == TYPE_ANALOG_4CH)) {
-    c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
+    c = whiteBalance(c); //color correction from CCT
   }
   uint8_t r = R(c);
   uint8_t g = G(c);
@@ -739,7 +909,7 @@ BusNetwork::BusNetwork(const BusConfig &bc)
 void BusNetwork::setPixelColor(unsigned pix, uint32_t c) {
   if (!_valid || pix >= _len) return;
   if (_hasWhite) c = autoWhiteCalc(c);
-  if (Bus::_cct >= 1900) c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
+  if (Bus::_cct >= 1900) c = whiteBalance(c); //color correction from CCT
   unsigned offset = pix * _UDPchannels;
   _data[offset]   = R(c);
   _data[offset+1] = G(c);
@@ -794,7 +964,7 @@ unsigned BusConfig::memUsage(unsigned nr) const {
   if (Bus::isVirtual(type)) {
     return sizeof(BusNetwork) + (count * Bus::getNumberOfChannels(type));
   } else if (Bus::isDigital(type)) {
-    return sizeof(BusDigital) + PolyBus::memUsage(count + skipAmount, PolyBus::getI(type, pins, nr)) + doubleBuffer * (count + skipAmount) * Bus::getNumberOfChannels(type);
+    return sizeof(BusDigital) + PolyBus::memUsage(count + skipAmount, PolyBus::getI(type, pins, nr)) + ((doubleBuffer || dither) + dither) * (count + skipAmount) * Bus::getNumberOfChannels(type);
   } else if (Bus::isOnOff(type)) {
     return sizeof(BusOnOff);
   } else {
@@ -973,6 +1143,13 @@ void BusManager::off() {
 void BusManager::show() {
   _gMilliAmpsUsed = 0;
   for (auto &bus : busses) {
+    unsigned wait = 0;
+    if (!bus->canShow()) { // still sending previous frame, record how long show() has to wait for it
+      unsigned long waitStart = micros();
+      while (!bus->canShow()) yield();
+      wait = micros() - waitStart;
+    }
+    bus->setShowWait(wait);
     bus->show();
     _gMilliAmpsUsed += bus->getUsedCurrent();
   }
@@ -1018,6 +1195,8 @@ bool PolyBus::_useParallelI2S = false;
 int16_t Bus::_cct = -1;
 uint8_t Bus::_cctBlend = 0;
 uint8_t Bus::_gAWM = 255;
+int16_t Bus::_wbKelvin = 0;
+uint8_t Bus::_wbLUT[3][256];
 
 uint16_t BusDigital::_milliAmpsTotal = 0;
 
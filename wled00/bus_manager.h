@@ -8,6 +8,7 @@
 
 #include "const.h"
 #include "pin_manager.h"
+#include "bus_encode.h"
 #include <vector>
 #include <memory>
 
@@ -69,6 +70,15 @@ typedef struct {
   uint8_t colorOrder;
 } ColorOrderMapEntry;
 
+// run of consecutive bus pixels sharing the same color order (see BusDigital::buildColorOrderRuns())
+typedef struct {
+  uint16_t start;       // first pixel of the run (relative to bus start), run ends where next run starts
+  uint8_t  colorOrder;
+} ColorOrderRun;
+
+// writes a single pixel into NeoPixelBus buffer applying color order (see PolyBus::getPixelWriter())
+typedef void (*PixelWriter)(void* busPtr, uint16_t pix, uint32_t c, uint8_t co, uint16_t wwcw);
+
 struct ColorOrderMap {
     bool add(uint16_t start, uint16_t len, uint8_t colorOrder);
 
@@ -86,6 +96,8 @@ struct ColorOrderMap {
     }
 
     [[gnu::hot]] uint8_t getPixelColorOrder(uint16_t pix, uint8_t defaultColorOrder) const;
+    // resolve mappings for pixels [start, start+len) into sorted runs (run starts are relative to start)
+    void getColorOrderRuns(uint16_t start, uint16_t len, uint8_t defaultColorOrder, std::vector<ColorOrderRun> &runs) const;
 
   private:
     std::vector<ColorOrderMapEntry> _mappings;
@@ -110,6 +122,7 @@ class Bus {
     , _reversed(reversed)
     , _valid(false)
     , _needsRefresh(refresh)
+    , _showWait(0)
     {
       _autoWhiteMode = Bus::hasWhite(type) ? aw : RGBW_MODE_MANUAL_ONLY;
     };
@@ -133,6 +146,7 @@ class Bus {
     virtual uint16_t getUsedCurrent() const                     { return 0; }
     virtual uint16_t getMaxCurrent() const                      { return 0; }
     virtual unsigned getBusSize() const                         { return sizeof(Bus); }
+    virtual bool     isDithering() const                        { return false; }
 
     inline  bool     hasRGB() const                             { return _hasRgb; }
     inline  bool     hasWhite() const                           { return _hasWhite; }
@@ -155,6 +169,8 @@ class Bus {
     inline  bool     isReversed() const                         { return _reversed; }
     inline  bool     isOffRefreshRequired() const               { return _needsRefresh; }
     inline  bool     containsPixel(uint16_t pix) const          { return pix >= _start && pix < _start + _len; }
+    inline  uint16_t getShowWait() const                        { return _showWait; }
+    inline  void     setShowWait(unsigned us)                   { _showWait = (7U * _showWait + std::min(us, 65535U)) >> 3; } // running average
 
     static inline std::vector<LEDType> getLEDTypes()            { return {{TYPE_NONE, "", PSTR("None")}}; } // not used. just for reference for derived classes
     static constexpr unsigned getNumberOfPins(uint8_t type)     { return isVirtual(type) ? 4 : isPWM(type) ? numPWMPins(type) : is2Pin(type) + 1; } // credit @PaoloTK
@@ -188,7 +204,7 @@ class Bus {
     static inline int16_t  getCCT()                   { return _cct; }
     static inline void     setGlobalAWMode(uint8_t m) { if (m < 5) _gAWM = m; else _gAWM = AW_GLOBAL_DISABLED; }
     static inline uint8_t  getGlobalAWMode()          { return _gAWM; }
-    static inline void     setCCT(int16_t cct)        { _cct = cct; }
+    static inline void     setCCT(int16_t cct)        { _cct = cct; if (cct >= 1900 && cct != _wbKelvin) calcWhiteBalanceLUT(cct); }
     static inline uint8_t  getCCTBlend()              { return _cctBlend; }
     static inline void     setCCTBlend(uint8_t b) {
       _cctBlend = (std::min((int)b,100) * 127) / 100;
@@ -213,6 +229,7 @@ class Bus {
       bool _hasCCT;//       : 1;
     //} __attribute__ ((packed));
     uint8_t  _autoWhiteMode;
+    uint16_t _showWait; // time (us) show() had to wait for bus to finish sending previous frame (running average)
     // global Auto White Calculation override
     static uint8_t _gAWM;
     // _cct has the following menaings (see calculateCCT() & BusManager::setSegmentCCT()):
@@ -225,8 +242,13 @@ class Bus {
     //   63 - semi additive/nonlinear (CCT 127 => 66% warm, 66% cold)
     //  127 - additive CCT blending (CCT 127 => 100% warm, 100% cold)
     static uint8_t _cctBlend;
+    // white balance correction for _cct in K as per channel lookup table (only rebuilt when Kelvin value changes)
+    static int16_t _wbKelvin;
+    static uint8_t _wbLUT[3][256];
 
     uint32_t autoWhiteCalc(uint32_t c) const;
+    static void calcWhiteBalanceLUT(uint16_t kelvin);
+    [[gnu::hot]] static uint32_t whiteBalance(uint32_t c); // _cct must be >= 1900
 };
 
 
@@ -250,6 +272,7 @@ class BusDigital : public Bus {
     uint16_t getUsedCurrent() const override { return _milliAmpsTotal; }
     uint16_t getMaxCurrent() const override  { return _milliAmpsMax; }
     unsigned getBusSize() const override;
+    bool     isDithering() const override    { return _ditherErr != nullptr; }
     void begin() override;
     void cleanup();
 
@@ -264,10 +287,29 @@ class BusDigital : public Bus {
     uint8_t  _milliAmpsPerLed;
     uint16_t _milliAmpsMax;
     uint8_t *_data;
+    uint8_t *_ditherErr; // temporal dithering: remainder of brightness scaling per channel, carried to next frame
     void    *_busPtr;
+    BusDirtyRange _dirty;               // double buffer (_data) only: pixels changed since last show()
+    std::vector<ColorOrderRun> _coRuns; // color order intervals, empty if whole bus uses _busColorOrder
+    uint8_t  _busColorOrder;            // resolved color order if bus is covered by a single mapping (or none)
+    // per-pixel path is selected once at construction, plain RGB/RGBW buses use type specialized writer
+    PixelWriter _writePixel;                              // nullptr if bus type needs generic PolyBus::setPixelColor()
+    void (BusDigital::*_setPixel)(unsigned pix, uint32_t c);
 
     static uint16_t _milliAmpsTotal; // is overwitten/recalculated on each show()
 
+    void setPixelGeneric(unsigned pix, uint32_t c);
+    template<bool white>      void setPixelDirect(unsigned pix, uint32_t c);   // plain RGB/RGBW, no buffer
+    template<unsigned chans>  void setPixelBuffered(unsigned pix, uint32_t c); // plain RGB/RGBW, double buffered
+    template<unsigned chans>  void encodePlain(unsigned from, unsigned to, uint8_t co);
+    template<unsigned chans>  void encodeDither(unsigned from, unsigned to, uint8_t co);
+    void encodeGeneric(unsigned from, unsigned to, uint8_t co, uint8_t &cctWW, uint8_t &cctCW);
+
+    void buildColorOrderRuns();
+    unsigned findColorOrderRun(unsigned pix) const;
+    [[gnu::hot]] uint8_t getColorOrderAt(unsigned pix) const; // pix is bus pixel index (before reversing/skipping)
+    void encodePixels(unsigned from, unsigned to, uint8_t &cctWW, uint8_t &cctCW); // encode _data into NeoPixelBus buffer
+
     inline uint32_t restoreColorLossy(uint32_t c, uint8_t restoreBri) const {
       if (restoreBri < 255) {
         uint8_t* chan = (uint8_t*) &c;
@@ -370,8 +412,9 @@ struct BusConfig {
   bool doubleBuffer;
   uint8_t milliAmpsPerLed;
   uint16_t milliAmpsMax;
+  bool dither;
 
-  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U, bool dblBfr=false, uint8_t maPerLed=LED_MILLIAMPS_DEFAULT, uint16_t maMax=ABL_MILLIAMPS_DEFAULT)
+  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U, bool dblBfr=false, uint8_t maPerLed=LED_MILLIAMPS_DEFAULT, uint16_t maMax=ABL_MILLIAMPS_DEFAULT, bool dith=false)
   : count(std::max(len,(uint16_t)1))
   , start(pstart)
   , colorOrder(pcolorOrder)
@@ -382,6 +425,7 @@ struct BusConfig {
   , doubleBuffer(dblBfr)
   , milliAmpsPerLed(maPerLed)
   , milliAmpsMax(maMax)
+  , dither(dith)
   {
     refreshReq = (bool) GET_BIT(busType,7);
     type = busType & 0x7F;  // bit 7 may be/is hacked to include refresh info (1=refresh in off state, 0=no refresh)
@@ -767,15 +767,14 @@ class PolyBus {
     return true;
   }
 
-  [[gnu::hot]] static void setPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint32_t c, uint8_t co, uint16_t wwcw = 0) {
+  // reorder channels to selected color order (WW & CW swap is handled by caller)
+  [[gnu::hot]] static inline RgbwColor orderChannels(uint32_t c, uint8_t co) {
     uint8_t r = c >> 16;
     uint8_t g = c >> 8;
     uint8_t b = c >> 0;
     uint8_t w = c >> 24;
     RgbwColor col;
-    uint8_t cctWW = wwcw & 0xFF, cctCW = (wwcw>>8) & 0xFF;
 
-    // reorder channels to selected order
     switch (co & 0x0F) {
       default: col.G = g; col.R = r; col.B = b; break; //0 = GRB, default
       case  1: col.G = r; col.R = g; col.B = b; break; //1 = RGB, common for WS2811
@@ -790,8 +789,88 @@ class PolyBus {
       case  1: col.W = col.B; col.B = w; break; // swap W & B
       case  2: col.W = col.G; col.G = w; break; // swap W & G
       case  3: col.W = col.R; col.R = w; break; // swap W & R
-      case  4: std::swap(cctWW, cctCW);  break; // swap WW & CW
     }
+    return col;
+  }
+
+  // per-type pixel writer for plain 3 and 4 channel buses, T is NeoPixelBus type, C is its color type
+  template <class T, class C>
+  [[gnu::hot]] static void writePixel(void* busPtr, uint16_t pix, uint32_t c, uint8_t co, uint16_t) {
+    (static_cast<T*>(busPtr))->SetPixelColor(pix, C(orderChannels(c, co)));
+  }
+
+  // returns specialized pixel writer for plain RGB/RGBW bus types (selected once when bus is created)
+  // or nullptr if bus type needs generic setPixelColor() (CCT, 16 bit, etc.)
+  static PixelWriter getPixelWriter(uint8_t busType) {
+    switch (busType) {
+    #ifdef ESP8266
+      case I_8266_U0_NEO_3: return writePixel<B_8266_U0_NEO_3, RgbColor>;
+      case I_8266_U1_NEO_3: return writePixel<B_8266_U1_NEO_3, RgbColor>;
+      case I_8266_DM_NEO_3: return writePixel<B_8266_DM_NEO_3, RgbColor>;
+      case I_8266_BB_NEO_3: return writePixel<B_8266_BB_NEO_3, RgbColor>;
+      case I_8266_U0_NEO_4: return writePixel<B_8266_U0_NEO_4, RgbwColor>;
+      case I_8266_U1_NEO_4: return writePixel<B_8266_U1_NEO_4, RgbwColor>;
+      case I_8266_DM_NEO_4: return writePixel<B_8266_DM_NEO_4, RgbwColor>;
+      case I_8266_BB_NEO_4: return writePixel<B_8266_BB_NEO_4, RgbwColor>;
+      case I_8266_U0_400_3: return writePixel<B_8266_U0_400_3, RgbColor>;
+      case I_8266_U1_400_3: return writePixel<B_8266_U1_400_3, RgbColor>;
+      case I_8266_DM_400_3: return writePixel<B_8266_DM_400_3, RgbColor>;
+      case I_8266_BB_400_3: return writePixel<B_8266_BB_400_3, RgbColor>;
+      case I_8266_U0_TM1_4: return writePixel<B_8266_U0_TM1_4, RgbwColor>;
+      case I_8266_U1_TM1_4: return writePixel<B_8266_U1_TM1_4, RgbwColor>;
+      case I_8266_DM_TM1_4: return writePixel<B_8266_DM_TM1_4, RgbwColor>;
+      case I_8266_BB_TM1_4: return writePixel<B_8266_BB_TM1_4, RgbwColor>;
+      case I_8266_U0_TM2_3: return writePixel<B_8266_U0_TM2_3, RgbColor>;
+      case I_8266_U1_TM2_3: return writePixel<B_8266_U1_TM2_3, RgbColor>;
+      case I_8266_DM_TM2_3: return writePixel<B_8266_DM_TM2_3, RgbColor>;
+      case I_8266_BB_TM2_3: return writePixel<B_8266_BB_TM2_3, RgbColor>;
+      case I_8266_U0_APA106_3: return writePixel<B_8266_U0_APA106_3, RgbColor>;
+      case I_8266_U1_APA106_3: return writePixel<B_8266_U1_APA106_3, RgbColor>;
+      case I_8266_DM_APA106_3: return writePixel<B_8266_DM_APA106_3, RgbColor>;
+      case I_8266_BB_APA106_3: return writePixel<B_8266_BB_APA106_3, RgbColor>;
+      case I_8266_U0_TM1914_3: return writePixel<B_8266_U0_TM1914_3, RgbColor>;
+      case I_8266_U1_TM1914_3: return writePixel<B_8266_U1_TM1914_3, RgbColor>;
+      case I_8266_DM_TM1914_3: return writePixel<B_8266_DM_TM1914_3, RgbColor>;
+      case I_8266_BB_TM1914_3: return writePixel<B_8266_BB_TM1914_3, RgbColor>;
+    #endif
+    #ifdef ARDUINO_ARCH_ESP32
+      // RMT buses
+      case I_32_RN_NEO_3: return writePixel<B_32_RN_NEO_3, RgbColor>;
+      case I_32_RN_NEO_4: return writePixel<B_32_RN_NEO_4, RgbwColor>;
+      case I_32_RN_400_3: return writePixel<B_32_RN_400_3, RgbColor>;
+      case I_32_RN_TM1_4: return writePixel<B_32_RN_TM1_4, RgbwColor>;
+      case I_32_RN_TM2_3: return writePixel<B_32_RN_TM2_3, RgbColor>;
+      case I_32_RN_APA106_3: return writePixel<B_32_RN_APA106_3, RgbColor>;
+      case I_32_RN_TM1914_3: return writePixel<B_32_RN_TM1914_3, RgbColor>;
+      // I2S1 bus or paralell buses (must match setPixelColor())
+      #ifndef CONFIG_IDF_TARGET_ESP32C3
+      case I_32_I2_NEO_3: if (_useParallelI2S) return writePixel<B_32_IP_NEO_3, RgbColor>; else return writePixel<B_32_I2_NEO_3, RgbColor>;
+      case I_32_I2_NEO_4: if (_useParallelI2S) return writePixel<B_32_IP_NEO_4, RgbColor>; else return writePixel<B_32_I2_NEO_4, RgbwColor>;
+      case I_32_I2_400_3: if (_useParallelI2S) return writePixel<B_32_IP_400_3, RgbColor>; else return writePixel<B_32_I2_400_3, RgbColor>;
+      case I_32_I2_TM1_4: if (_useParallelI2S) return writePixel<B_32_IP_TM1_4, RgbColor>; else return writePixel<B_32_I2_TM1_4, RgbwColor>;
+      case I_32_I2_TM2_3: if (_useParallelI2S) return writePixel<B_32_IP_TM2_3, RgbColor>; else return writePixel<B_32_I2_TM2_3, RgbColor>;
+      case I_32_I2_APA106_3: if (_useParallelI2S) return writePixel<B_32_IP_APA106_3, RgbColor>; else return writePixel<B_32_I2_APA106_3, RgbColor>;
+      case I_32_I2_TM1914_3: if (_useParallelI2S) return writePixel<B_32_IP_TM1914_3, RgbColor>; else return writePixel<B_32_I2_TM1914_3, RgbColor>;
+      #endif
+    #endif
+      case I_HS_DOT_3: return writePixel<B_HS_DOT_3, RgbColor>;
+      case I_SS_DOT_3: return writePixel<B_SS_DOT_3, RgbColor>;
+      case I_HS_LPD_3: return writePixel<B_HS_LPD_3, RgbColor>;
+      case I_SS_LPD_3: return writePixel<B_SS_LPD_3, RgbColor>;
+      case I_HS_LPO_3: return writePixel<B_HS_LPO_3, RgbColor>;
+      case I_SS_LPO_3: return writePixel<B_SS_LPO_3, RgbColor>;
+      case I_HS_WS1_3: return writePixel<B_HS_WS1_3, RgbColor>;
+      case I_SS_WS1_3: return writePixel<B_SS_WS1_3, RgbColor>;
+      case I_HS_P98_3: return writePixel<B_HS_P98_3, RgbColor>;
+      case I_SS_P98_3: return writePixel<B_SS_P98_3, RgbColor>;
+    }
+    return nullptr;
+  }
+
+  [[gnu::hot]] static void setPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint32_t c, uint8_t co, uint16_t wwcw = 0) {
+    RgbwColor col = orderChannels(c, co);
+    uint8_t cctWW = wwcw & 0xFF, cctCW = (wwcw>>8) & 0xFF;
+    if ((co >> 4) == 4) std::swap(cctWW, cctCW); // swap WW & CW
 
     switch (busType) {
       case I_NONE: break;
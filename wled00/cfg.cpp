@@ -188,6 +188,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       uint8_t ledType = elm["type"] | TYPE_WS2812_RGB;
       bool reversed = elm["rev"];
       bool refresh = elm["ref"] | false;
+      bool dither = elm[F("dith")] | false;
       uint16_t freqkHz = elm[F("freq")] | 0;  // will be in kHz for DotStar and Hz for PWM
       uint8_t AWmode = elm[F("rgbwm")] | RGBW_MODE_MANUAL_ONLY;
       uint8_t maPerLed = elm[F("ledma")] | LED_MILLIAMPS_DEFAULT;
@@ -200,7 +201,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       ledType |= refresh << 7; // hack bit 7 to indicate strip requires off refresh
 
       //busConfigs.push_back(std::move(BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maPerLed, maMax)));
-      busConfigs.emplace_back(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maPerLed, maMax);
+      busConfigs.emplace_back(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maPerLed, maMax, dither);
       doInitBusses = true;  // finalization done in beginStrip()
       if (!Bus::isVirtual(ledType)) s++; // have as many virtual buses as you want
     }
@@ -415,6 +416,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   strip.setTransition(transitionDelayDefault);
   CJSON(randomPaletteChangeTime, light_tr[F("rpc")]);
   CJSON(useHarmonicRandomPalette, light_tr[F("hrp")]);
+  CJSON(useTransitionBuffers, light_tr[F("buf")]);
 
   JsonObject light_nl = light["nl"];
   CJSON(nightlightMode, light_nl["mode"]);
@@ -435,6 +437,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_sync = interfaces["sync"];
   CJSON(udpPort, if_sync[F("port0")]); // 21324
   CJSON(udpPort2, if_sync[F("port1")]); // 65506
+  CJSON(clusterClockEnabled, if_sync[F("clk")]);
 
 #ifndef WLED_DISABLE_ESPNOW
   CJSON(useESPNowSync, if_sync[F("espnow")]);
@@ -646,6 +649,95 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
 
 
 static const char s_cfg_json[] PROGMEM = "/cfg.json";
+static const char s_cfg_bin[]  PROGMEM = "/cfg.bin";
+
+/*
+ * Binary config snapshot: cfg.json as MessagePack, written along with cfg.json and used on boot instead of parsing it.
+ * Only used if it was taken of the current cfg.json (i.e. not edited or uploaded since) by the same firmware build.
+ */
+#define CFG_SNAPSHOT_MAGIC  0x47464357 // "WCFG"
+#define CFG_SNAPSHOT_FORMAT 1
+
+typedef struct {
+  uint32_t magic;
+  uint16_t format;   // snapshot format version
+  uint16_t reserved;
+  uint32_t build;    // VERSION, other builds (usermods) may read config differently
+  uint32_t jsonHash; // FNV-1a of cfg.json the snapshot was taken of
+  uint32_t jsonLen;
+  uint32_t len;      // MessagePack length
+  uint32_t hash;     // FNV-1a of MessagePack
+} cfg_snapshot_t;
+
+// writes into file, keeping hash and length of what was written
+class CfgHashPrint : public Print {
+  public:
+    CfgHashPrint(File &f) : _f(f) {}
+    uint32_t hash = 2166136261UL;
+    size_t   len  = 0;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override {
+      hash = fnv1a(buf, size, hash);
+      len += size;
+      return _f.write(buf, size);
+    }
+  private:
+    File &_f;
+};
+
+static bool hashConfigFile(uint32_t &hash, size_t &len) {
+  File f = WLED_FS.open(FPSTR(s_cfg_json), "r");
+  if (!f) return false;
+  uint8_t buf[256];
+  hash = 2166136261UL;
+  len  = 0;
+  while (f.available()) {
+    size_t n = f.read(buf, sizeof(buf));
+    if (!n) break;
+    hash = fnv1a(buf, n, hash);
+    len += n;
+  }
+  f.close();
+  return true;
+}
+
+static void writeConfigSnapshot(JsonObject root, uint32_t jsonHash, size_t jsonLen) {
+  cfg_snapshot_t h = {CFG_SNAPSHOT_MAGIC, CFG_SNAPSHOT_FORMAT, 0, VERSION, jsonHash, (uint32_t)jsonLen, (uint32_t)measureMsgPack(root), 0};
+  uint8_t *buf = (uint8_t*)malloc(h.len);
+  if (!buf) {
+    WLED_FS.remove(FPSTR(s_cfg_bin)); // stale snapshot would not match anyway, free the space
+    return;
+  }
+  serializeMsgPack(root, buf, h.len);
+  h.hash = fnv1a(buf, h.len);
+  File f = WLED_FS.open(FPSTR(s_cfg_bin), "w");
+  if (f) {
+    f.write((const uint8_t*)&h, sizeof(h));
+    f.write(buf, h.len);
+    f.close();
+  }
+  free(buf);
+}
+
+// returns MessagePack of snapshot if it matches cfg.json (to be freed by caller), nullptr otherwise
+static uint8_t *readConfigSnapshot(uint32_t jsonHash, size_t jsonLen, size_t &len) {
+  File f = WLED_FS.open(FPSTR(s_cfg_bin), "r");
+  if (!f) return nullptr;
+  cfg_snapshot_t h;
+  uint8_t *buf = nullptr;
+  if (f.read((uint8_t*)&h, sizeof(h)) == sizeof(h) && h.magic == CFG_SNAPSHOT_MAGIC && h.format == CFG_SNAPSHOT_FORMAT
+      && h.build == VERSION && h.jsonHash == jsonHash && h.jsonLen == jsonLen && h.len <= f.size() - sizeof(h)) {
+    buf = (uint8_t*)malloc(h.len);
+    if (buf && (f.read(buf, h.len) != h.len || fnv1a(buf, h.len) != h.hash)) {
+      free(buf);
+      buf = nullptr;
+    }
+  }
+  f.close();
+  len = buf ? h.len : 0;
+  DEBUG_PRINTF_P(PSTR("Config snapshot %s.\n"), buf ? "valid" : "outdated");
+  return buf;
+}
 
 void deserializeConfigFromFS() {
   bool success = deserializeConfigSec();
@@ -658,9 +750,20 @@ void deserializeConfigFromFS() {
 
   if (!requestJSONBufferLock(1)) return;
 
-  DEBUG_PRINTLN(F("Reading settings from /cfg.json..."));
-
-  success = readObjectFromFile(s_cfg_json, nullptr, pDoc);
+  uint32_t jsonHash = 0;
+  size_t   jsonLen  = 0;
+  size_t   snapshotLen = 0;
+  uint8_t *snapshot = hashConfigFile(jsonHash, jsonLen) ? readConfigSnapshot(jsonHash, jsonLen, snapshotLen) : nullptr;
+  if (snapshot) {
+    DEBUG_PRINTLN(F("Reading settings from /cfg.bin..."));
+    success = !deserializeMsgPack(*pDoc, (char*)snapshot, snapshotLen); // zero-copy, strings stay in snapshot buffer
+    if (!success) { free(snapshot); snapshot = nullptr; }
+  }
+  if (!snapshot) {
+    DEBUG_PRINTLN(F("Reading settings from /cfg.json..."));
+    success = readObjectFromFile(s_cfg_json, nullptr, pDoc);
+  }
+  bootTimes.cfgBinary = snapshot != nullptr;
   if (!success) { // if file does not exist, optionally try reading from EEPROM and then save defaults to FS
     releaseJSONBufferLock();
     #ifdef WLED_ADD_EEPROM_SUPPORT
@@ -683,7 +786,9 @@ void deserializeConfigFromFS() {
   //       Therefore, must also initialize ethernet from this function
   JsonObject root = pDoc->as<JsonObject>();
   bool needsSave = deserializeConfig(root, true);
+  if (!snapshot && !needsSave) writeConfigSnapshot(root, jsonHash, jsonLen); // cfg.json changed or first boot of this build
   releaseJSONBufferLock();
+  free(snapshot);
 
   if (needsSave) serializeConfigToFS(); // usermods required new parameters
 }
@@ -700,8 +805,12 @@ void serializeConfigToFS() {
   serializeConfig(root);
 
   File f = WLED_FS.open(FPSTR(s_cfg_json), "w");
-  if (f) serializeJson(root, f);
-  f.close();
+  if (f) {
+    CfgHashPrint out(f);
+    serializeJson(root, out);
+    f.close();
+    writeConfigSnapshot(root, out.hash, out.len);
+  }
   releaseJSONBufferLock();
 
   configNeedsWrite = false;
@@ -864,6 +973,7 @@ void serializeConfig(JsonObject root) {
     ins[F("freq")]   = bus->getFrequency();
     ins[F("maxpwr")] = bus->getMaxCurrent();
     ins[F("ledma")]  = bus->getLEDCurrent();
+    ins[F("dith")]   = bus->isDithering();
   }
 
   JsonArray hw_com = hw.createNestedArray(F("com"));
@@ -938,6 +1048,7 @@ void serializeConfig(JsonObject root) {
   light_tr["dur"] = transitionDelayDefault / 100;
   light_tr[F("rpc")] = randomPaletteChangeTime;
   light_tr[F("hrp")] = useHarmonicRandomPalette;
+  light_tr[F("buf")] = useTransitionBuffers;
 
   JsonObject light_nl = light.createNestedObject("nl");
   light_nl["mode"] = nightlightMode;
@@ -955,6 +1066,7 @@ void serializeConfig(JsonObject root) {
   JsonObject if_sync = interfaces.createNestedObject("sync");
   if_sync[F("port0")] = udpPort;
   if_sync[F("port1")] = udpPort2;
+  if_sync[F("clk")] = clusterClockEnabled;
 
 #ifndef WLED_DISABLE_ESPNOW
   if_sync[F("espnow")] = useESPNowSync;
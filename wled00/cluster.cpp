@@ -0,0 +1,165 @@
+#include "wled.h"
+#include "cluster_clock.h"
+
+/*
+ * Cluster clock on the notifier port and states applied at a given cluster time
+ * {"at":t,"ps":3} sent to every node applies preset 3 in the same frame on all of them, t being cluster time in ms
+ * (info "cc":{"t":...} of any node plus some headroom for the requests to arrive).
+ * Playlist steps are timed in local time and follow cluster clock corrections (see clusterClockShift()), so a playlist
+ * started with "at" changes entries in the same frame on all nodes. Effect time (strip.now) follows the master while locked.
+ */
+
+#define CLUSTER_MAX_TIMED 4       // states waiting for their time
+#define CLUSTER_MAX_AHEAD 3600000 // states can be scheduled up to an hour ahead
+
+typedef struct {
+  uint32_t at;  // cluster ms
+  char    *json;
+} TimedState;
+
+static ClusterClock clusterClock;
+static uint32_t     clusterId = 0; // 0: clock not running
+static TimedState   timedStates[CLUSTER_MAX_TIMED];
+static uint32_t     timedStateDelay = 0; // ms the timed state being applied is behind its time
+
+static inline uint64_t localMicros() {
+#ifdef ESP8266
+  return micros64();
+#else
+  return esp_timer_get_time();
+#endif
+}
+
+// cluster time in ms, same as millis() if cluster clock is disabled
+uint32_t clusterMillis() {
+  if (!clusterClockEnabled) return millis();
+  return clusterClock.time(localMicros()) / 1000;
+}
+
+// ms cluster time moved against millis() since last call (clock stepped or slewed, master changed, clock enabled)
+// local deadlines that are meant to follow cluster time are shifted back by it
+int32_t clusterClockShift() {
+  static int64_t lastOffset = 0;
+  int64_t offset = clusterClockEnabled ? clusterClock.offset() : 0;
+  offset = offset >= 0 ? offset / 1000 : -((999 - offset) / 1000); // floor, us to ms
+  int32_t shift = offset - lastOffset;
+  lastOffset = offset;
+  return shift;
+}
+
+bool clusterClockLocked() {
+  return clusterClockEnabled && clusterId && clusterClock.isLocked();
+}
+
+static void clusterSend(IPAddress ip, const uint8_t *buf, size_t len) {
+  notifierUdp.beginPacket(ip, udpPort);
+  notifierUdp.write(buf, len);
+  notifierUdp.endPacket();
+}
+
+// returns true if packet was a cluster clock packet
+bool handleClusterPacket(const uint8_t *udpIn, size_t len, IPAddress remoteIP) {
+  if (len < 1 || udpIn[0] != CLUSTER_MAGIC) return false;
+  if (!clusterClockEnabled || !clusterId) return true;
+  uint8_t out[CLUSTER_PACKET_SIZE];
+  size_t outLen = clusterClock.receive(udpIn, len, uint32_t(remoteIP), localMicros(), out);
+  if (outLen) clusterSend(remoteIP, out, outLen); // answer right away, the time spent in between is not part of the round trip
+  return true;
+}
+
+// queue state for later, returns false if it is to be applied now
+bool queueTimedState(JsonObject root) {
+  uint32_t at = root[F("at")];
+  int32_t ahead = at - clusterMillis();
+  if (ahead <= 0 || ahead > CLUSTER_MAX_AHEAD) return false; // due already (or invalid)
+  for (auto &ts : timedStates) {
+    if (ts.json) continue;
+    root.remove("at"); // not queued again when applied
+    size_t len = measureJson(root) + 1;
+    ts.json = (char*)malloc(len);
+    if (!ts.json) return false;
+    serializeJson(root, ts.json, len);
+    ts.at = at;
+    DEBUG_PRINTF_P(PSTR("Cluster: state queued for %u (in %dms).\n"), at, ahead);
+    return true;
+  }
+  DEBUG_PRINTLN(F("Cluster: no free slot for timed state."));
+  return false;
+}
+
+static void applyTimedStates() {
+  uint32_t now = clusterMillis();
+  for (auto &ts : timedStates) {
+    if (!ts.json || (int32_t)(now - ts.at) < 0) continue;
+    if (!requestJSONBufferLock(24)) return; // retry on next loop
+    DeserializationError error = deserializeJson(*pDoc, (const char*)ts.json);
+    timedStateDelay = now - ts.at;
+    if (!error) deserializeState(pDoc->as<JsonObject>(), CALL_MODE_DIRECT_CHANGE);
+    timedStateDelay = 0;
+    releaseJSONBufferLock();
+    free(ts.json);
+    ts.json = nullptr;
+  }
+}
+
+// ms the timed state being applied right now is behind its time (0 otherwise), a playlist it starts is timed from "at"
+uint32_t getTimedStateDelay() {
+  return timedStateDelay;
+}
+
+// ms until next timed state is due (UINT32_MAX if none)
+uint32_t getTimeToNextTimedState() {
+  uint32_t next = UINT32_MAX;
+  uint32_t now = clusterMillis();
+  for (const auto &ts : timedStates) {
+    if (!ts.json) continue;
+    int32_t ahead = ts.at - now;
+    if (ahead <= 0) return 0;
+    if ((uint32_t)ahead < next) next = ahead;
+  }
+  return next;
+}
+
+void handleClusterClock() {
+  applyTimedStates();
+
+  uint32_t id = uint32_t(Network.localIP());
+  if (!clusterClockEnabled || !udpConnected || !id) {
+    clusterId = 0;
+    return;
+  }
+  uint64_t now = localMicros();
+  if (id != clusterId) { // (re)start election, cluster time continues
+    clusterClock.begin(id, now);
+    clusterId = id;
+  }
+  clusterClock.update(now);
+
+  uint8_t out[CLUSTER_PACKET_SIZE];
+  if (clusterClock.announceDue(now)) {
+    uint32_t effectOffset = millis() + strip.timebase - clusterMillis(); // followers align strip.now to the master's
+    IPAddress broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+    clusterSend(broadcastIp, out, clusterClock.buildAnnounce(out, now, effectOffset));
+  }
+  if (clusterClock.requestDue(now)) {
+    clusterSend(IPAddress(clusterClock.master()), out, clusterClock.buildRequest(out, localMicros()));
+  }
+  if (!clusterClock.isMaster() && clusterClock.isLocked()) {
+    strip.timebase = clusterClock.masterTimebase() + clusterMillis() - millis();
+  }
+}
+
+void serializeClusterClockInfo(JsonObject root) {
+  JsonObject cc = root.createNestedObject(F("cc"));
+  cc["t"] = clusterMillis(); // use as reference for "at"
+  if (!clusterClockEnabled || !clusterId) return;
+  uint64_t now = localMicros();
+  cc[F("lock")] = clusterClock.isLocked();
+  cc[F("mst")]  = clusterClock.isMaster();
+  if (clusterClock.master()) cc["m"] = IPAddress(clusterClock.master()).toString();
+  cc["n"]       = clusterClock.numNodes(now);
+  if (!clusterClock.isMaster() && clusterClock.jitter() != UINT32_MAX) {
+    cc[F("jit")] = clusterClock.jitter(); // us
+    cc[F("rtt")] = clusterClock.delay();  // us
+  }
+}
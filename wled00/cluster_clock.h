@@ -0,0 +1,208 @@
+#pragma once
+#ifndef WLED_CLUSTER_CLOCK_H
+#define WLED_CLUSTER_CLOCK_H
+/*
+ * Cluster clock: common timebase for all controllers on the notifier port
+ *
+ * Every node announces itself once a second. The node with the lowest id (IPv4 address) that claims to be master
+ * is followed by all others; if there is none for a while, the lowest id heard takes over, keeping its current
+ * cluster time so the time does not jump when the master disappears.
+ * Followers estimate their offset to the master with PTP-like request/response exchanges (4 timestamps) and use the
+ * sample with the lowest round trip of the last few ones, which is the one least affected by loop latency.
+ * All times are in us, local time is a free running 64 bit counter.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define CLUSTER_MAGIC           0xCC  // first byte of packet on notifier port (0: notifier, 1-5: realtime, 0x9C: TPM2.NET)
+#define CLUSTER_VERSION         1
+#define CLUSTER_TYPE_ANNOUNCE   1
+#define CLUSTER_TYPE_REQUEST    2
+#define CLUSTER_TYPE_RESPONSE   3
+#define CLUSTER_PACKET_SIZE     32    // max. size of any packet
+
+#define CLUSTER_MAX_NODES       16    // nodes considered for master election
+#define CLUSTER_ANNOUNCE_US     1000000
+#define CLUSTER_TIMEOUT_US      3500000 // node or master is gone if not heard for this long
+#define CLUSTER_SYNC_US         1000000 // request interval when locked
+#define CLUSTER_ACQUIRE_US      250000  // request interval until locked
+#define CLUSTER_SAMPLES         8     // clock filter length
+#define CLUSTER_MIN_SAMPLES     4     // samples needed before locking
+#define CLUSTER_STEP_US         20000 // offset errors larger than this are stepped, smaller ones slewed
+#define CLUSTER_LOCK_JITTER_US  5000  // max. jitter to be considered locked (well within one frame)
+
+class ClusterClock {
+  public:
+    void begin(uint32_t id, uint64_t now) {
+      _id = id;
+      _start = now;
+      _isMaster = false;
+      _master = 0;
+      _numNodes = 0;
+      resetFilter();
+    }
+
+    inline uint64_t time(uint64_t local) const { return local + _offset; } // cluster time
+    inline int64_t  offset() const   { return _offset; }
+    inline uint32_t jitter() const   { return _jitter; }
+    inline uint32_t delay() const    { return _delay; }
+    inline uint32_t master() const   { return _isMaster ? _id : _master; }
+    inline bool     isMaster() const { return _isMaster; }
+    inline bool     isLocked() const { return _isMaster || (_master && _samples >= CLUSTER_MIN_SAMPLES && _jitter < CLUSTER_LOCK_JITTER_US); }
+    inline uint32_t masterTimebase() const { return _masterTimebase; } // master's effect time - cluster time (ms)
+    size_t numNodes(uint64_t now) const {
+      size_t n = 0;
+      for (size_t i = 0; i < _numNodes; i++) if (now - _nodes[i].seen < CLUSTER_TIMEOUT_US) n++;
+      return n;
+    }
+
+    // master election, call regularly
+    void update(uint64_t now) {
+      uint32_t bestMaster = 0, lowest = _id;
+      for (size_t i = 0; i < _numNodes; i++) {
+        if (now - _nodes[i].seen >= CLUSTER_TIMEOUT_US) continue;
+        if (_nodes[i].id < lowest) lowest = _nodes[i].id;
+        if (_nodes[i].master && (!bestMaster || _nodes[i].id < bestMaster)) bestMaster = _nodes[i].id;
+      }
+      if (bestMaster && (!_isMaster || bestMaster < _id)) {
+        _isMaster = false;
+        if (bestMaster != _master) { _master = bestMaster; resetFilter(); }
+      } else if (!_isMaster) {
+        _master = 0; // keep offset, time continues where the old master left it
+        if (now - _start >= CLUSTER_TIMEOUT_US && lowest == _id) _isMaster = true;
+      }
+    }
+
+    bool announceDue(uint64_t now) {
+      if (_lastAnnounce && now - _lastAnnounce < CLUSTER_ANNOUNCE_US) return false;
+      _lastAnnounce = now;
+      return true;
+    }
+
+    bool requestDue(uint64_t now) {
+      if (_isMaster || !_master) return false;
+      if (_lastRequest && now - _lastRequest < (isLocked() ? CLUSTER_SYNC_US : CLUSTER_ACQUIRE_US)) return false;
+      _lastRequest = now;
+      return true;
+    }
+
+    // timebase: effect time - cluster time (ms), followed by all nodes if sent by master
+    size_t buildAnnounce(uint8_t *out, uint64_t now, uint32_t timebase) {
+      header(out, CLUSTER_TYPE_ANNOUNCE, 0);
+      out[8] = _isMaster;
+      put32(out + 9, timebase);
+      put64(out + 13, time(now));
+      return 21;
+    }
+
+    size_t buildRequest(uint8_t *out, uint64_t now) {
+      header(out, CLUSTER_TYPE_REQUEST, ++_seq);
+      _t1 = now;
+      put64(out + 8, now);
+      return 16;
+    }
+
+    // handles received packet, returns length of response to be sent to sender (0 if none)
+    size_t receive(const uint8_t *in, size_t len, uint32_t from, uint64_t now, uint8_t *out) {
+      if (len < 8 || in[0] != CLUSTER_MAGIC || in[1] != CLUSTER_VERSION || from == _id) return 0;
+      switch (in[2]) {
+        case CLUSTER_TYPE_ANNOUNCE:
+          if (len < 21) return 0;
+          heard(from, in[8], now);
+          if (from == _master) _masterTimebase = get32(in + 9);
+          return 0;
+        case CLUSTER_TYPE_REQUEST:
+          if (len < 16 || !_isMaster) return 0;
+          header(out, CLUSTER_TYPE_RESPONSE, in[3]);
+          memcpy(out + 8, in + 8, 8);  // t1 (requester's local time)
+          put64(out + 16, time(now));  // t2 (receive)
+          put64(out + 24, time(now));  // t3 (transmit), sent right away
+          return 32;
+        case CLUSTER_TYPE_RESPONSE:
+          if (len < 32 || from != _master || in[3] != _seq || get64(in + 8) != _t1) return 0;
+          sample((int64_t)get64(in + 16), (int64_t)get64(in + 24), now);
+          return 0;
+      }
+      return 0;
+    }
+
+  private:
+    typedef struct {
+      uint32_t id;
+      uint64_t seen;
+      bool     master;
+    } Node;
+
+    typedef struct {
+      int64_t  offset;
+      uint32_t delay;
+    } Sample;
+
+    uint32_t _id = 0, _master = 0, _masterTimebase = 0;
+    bool     _isMaster = false;
+    int64_t  _offset = 0;
+    uint64_t _start = 0, _lastAnnounce = 0, _lastRequest = 0, _t1 = 0;
+    uint8_t  _seq = 0;
+    Node     _nodes[CLUSTER_MAX_NODES];
+    size_t   _numNodes = 0;
+    Sample   _filter[CLUSTER_SAMPLES];
+    uint8_t  _samples = 0, _next = 0;
+    int64_t  _selected = 0;
+    uint32_t _jitter = UINT32_MAX, _delay = 0;
+
+    void resetFilter() {
+      _samples = _next = 0;
+      _jitter = UINT32_MAX;
+      _delay = 0;
+    }
+
+    void heard(uint32_t id, bool master, uint64_t now) {
+      size_t i = 0, oldest = 0;
+      for (; i < _numNodes && _nodes[i].id != id; i++) if (_nodes[i].seen < _nodes[oldest].seen) oldest = i;
+      if (i == _numNodes) {
+        if (_numNodes < CLUSTER_MAX_NODES) _numNodes++;
+        else i = oldest; // replace node not heard for the longest time
+      }
+      _nodes[i] = {id, now, master};
+      update(now);
+    }
+
+    // t2, t3: master's cluster time at receive and transmit, _t1 and t4 local time at transmit and receive
+    void sample(int64_t t2, int64_t t3, uint64_t t4) {
+      int64_t  rtt = (int64_t)(t4 - _t1) - (t3 - t2);
+      _filter[_next] = {((t2 - (int64_t)_t1) + (t3 - (int64_t)t4)) / 2, rtt > 0 ? (uint32_t)rtt : 0};
+      _next = (_next + 1) % CLUSTER_SAMPLES;
+      if (_samples < CLUSTER_SAMPLES) _samples++;
+
+      const Sample *best = &_filter[0]; // offset error is at most half the round trip, use the shortest one
+      for (size_t i = 1; i < _samples; i++) if (_filter[i].delay < best->delay) best = &_filter[i];
+      _delay = best->delay;
+
+      int64_t diff = best->offset - _selected;
+      if (diff < 0) diff = -diff;
+      if (_samples == 1) _jitter = UINT32_MAX;
+      else if (_jitter == UINT32_MAX) _jitter = diff > UINT32_MAX ? UINT32_MAX : (uint32_t)diff;
+      else _jitter = (3 * (uint64_t)_jitter + (diff > UINT32_MAX ? UINT32_MAX : diff)) / 4;
+      _selected = best->offset;
+
+      int64_t err = _selected - _offset;
+      if (_samples == 1 || err > CLUSTER_STEP_US || err < -CLUSTER_STEP_US) _offset = _selected;
+      else _offset += err / 4;
+    }
+
+    void header(uint8_t *out, uint8_t type, uint8_t seq) const {
+      out[0] = CLUSTER_MAGIC;
+      out[1] = CLUSTER_VERSION;
+      out[2] = type;
+      out[3] = seq;
+      put32(out + 4, _id);
+    }
+
+    static void put32(uint8_t *p, uint32_t v) { for (int i = 3; i >= 0; i--, v >>= 8) p[i] = v & 0xFF; }
+    static void put64(uint8_t *p, uint64_t v) { for (int i = 7; i >= 0; i--, v >>= 8) p[i] = v & 0xFF; }
+    static uint32_t get32(const uint8_t *p) { uint32_t v = 0; for (int i = 0; i < 4; i++) v = (v << 8) | p[i]; return v; }
+    static uint64_t get64(const uint8_t *p) { uint64_t v = 0; for (int i = 0; i < 8; i++) v = (v << 8) | p[i]; return v; }
+};
+
+#endif
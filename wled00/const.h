@@ -7,6 +7,15 @@
 
 #define GRADIENT_PALETTE_COUNT 59
 
+// custom palettes use IDs from 255 downward (up to the last built-in palette)
+#ifndef WLED_MAX_CUSTOM_PALETTES
+  #ifdef ESP8266
+    #define WLED_MAX_CUSTOM_PALETTES 20
+  #else
+    #define WLED_MAX_CUSTOM_PALETTES (255 - 13 - GRADIENT_PALETTE_COUNT) // 183
+  #endif
+#endif
+
 // You can define custom product info from build flags.
 // This is useful to allow API consumer to identify what type of WLED version
 // they are interacting with. Be aware that changing this might cause some third
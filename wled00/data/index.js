@@ -25,7 +25,7 @@ var pN = "", pI = 0, pNum = 0;
 var pmt = 1, pmtLS = 0, pmtLast = 0;
 var lastinfo = {};
 var isM = false, mw = 0, mh=0;
-var ws, wsRpt=0;
+var ws, wsRpt=0, wsState=null; // wsState: last full state, incremental WS updates are merged into it
 var cfg = {
 	theme:{base:"dark", bg:{url:"", rnd: false, rndGrayscale: false, rndBlur: false}, alpha:{bg:0.6,tab:0.8}, color:{bg:""}},
 	comp :{colors:{picker: true, rgb: false, quick: true, hex: false},
@@ -1411,6 +1411,11 @@ function makeWS() {
 		} else
 			i = lastinfo;
 		var s = json.state ? json.state : json;
+		if (json.d) { // incremental update, only changed keys
+			if (!wsState) return;
+			s = mergeState(wsState, json.d);
+		}
+		if (s.seg) wsState = s;
 		displayRover(i, s);
 		readState(s);
 	};
@@ -1418,14 +1423,31 @@ function makeWS() {
 		gId('connind').style.backgroundColor = "var(--c-r)";
 		if (wsRpt++ < 5) setTimeout(makeWS,1500); // retry WS connection
 		ws = null;
+		wsState = null;
 	}
 	ws.onopen = (e)=>{
 		//ws.send("{'v':true}"); // unnecessary (https://github.com/wled-dev/WLED/blob/main/wled00/ws.cpp#L18)
+		ws.send('{"sub":true}'); // full state+info is sent on connect, afterwards only changed state keys (and info every few seconds)
 		wsRpt = 0;
 		reqsLegal = true;
 	}
 }
 
+// apply incremental WS update {"bri":128,"seg":[{"id":0,"sx":100}]} to state, {"id":n,"stop":0} removes segment
+// and a null value removes key (i.e. segment name)
+function mergeState(s, d)
+{
+	let set = (o, k, v)=>{ if (v === null) delete o[k]; else o[k] = v; };
+	for (let k in d) if (k !== "seg") set(s, k, d[k]);
+	for (let ds of (d.seg||[])) {
+		let i = s.seg.findIndex((e)=>e.id==ds.id);
+		if (ds.stop === 0) { if (i >= 0) s.seg.splice(i,1); }
+		else if (i < 0) { s.seg.push(ds); s.seg.sort((a,b)=>a.id-b.id); }
+		else for (let k in ds) set(s.seg[i], k, ds[k]);
+	}
+	return s;
+}
+
 function readState(s,command=false)
 {
 	if (!s) return false;
@@ -69,6 +69,17 @@ typedef struct WiFiConfig {
   }
 } wifi_config;
 
+//cluster.cpp
+uint32_t clusterMillis();
+int32_t clusterClockShift();
+bool clusterClockLocked();
+bool handleClusterPacket(const uint8_t *udpIn, size_t len, IPAddress remoteIP);
+bool queueTimedState(JsonObject root);
+uint32_t getTimeToNextTimedState();
+uint32_t getTimedStateDelay();
+void handleClusterClock();
+void serializeClusterClockInfo(JsonObject root);
+
 //colors.cpp
 #define ColorFromPalette ColorFromPaletteWLED // override fastled version
 
@@ -225,6 +236,10 @@ void onHueData(void* arg, AsyncClient* client, void *data, size_t len);
 
 #include "FX.h" // must be below colors.cpp declarations (potentially due to duplicate declarations of e.g. color_blend)
 
+//http_api.cpp
+bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=true);
+bool handleHttpApi(const char *params, bool apply=true);
+
 //image_loader.cpp
 #ifdef WLED_ENABLE_GIF
 bool fileSeekCallback(unsigned long position);
@@ -265,6 +280,7 @@ void handleIR();
 
 bool deserializeSegment(JsonObject elem, byte it, byte presetId = 0);
 bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
+unsigned deserializeStateBatch(JsonArray patches, byte callMode = CALL_MODE_DIRECT_CHANGE);
 void serializeSegment(const JsonObject& root, const Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
 void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool selectedSegmentsOnly = false);
 void serializeInfo(JsonObject root);
@@ -299,6 +315,7 @@ void parseLxJson(int lxValue, byte segId, bool secondary);
 //mqtt.cpp
 bool initMqtt();
 void publishMqtt();
+void handleMqtt();
 
 //ntp.cpp
 void handleTime();
@@ -314,6 +331,11 @@ void checkTimers();
 void calculateSunriseAndSunset();
 void setTimeFromAPI(uint32_t timein);
 
+//schedule.cpp
+void reloadSchedule();
+void handleSchedule();
+uint32_t getTimeToNextCue();
+
 //overlay.cpp
 void handleOverlayDraw();
 void _overlayAnalogCountdown();
@@ -323,6 +345,7 @@ void _overlayAnalogClock();
 void shufflePlaylist();
 void unloadPlaylist();
 int16_t loadPlaylist(JsonObject playlistObject, byte presetId = 0);
+uint32_t getTimeToNextPlaylistEntry();
 void handlePlaylist();
 void serializePlaylist(JsonObject obj);
 
@@ -333,6 +356,9 @@ void initPresetsFile();
 void handlePresets();
 bool applyPreset(byte index, byte callMode = CALL_MODE_DIRECT_CHANGE);
 bool applyPresetFromPlaylist(byte index);
+void prefetchPreset(byte index);
+void invalidatePrefetchedPreset();
+void serializePlaylistStepInfo(JsonObject root);
 void applyPresetWithFallback(uint8_t presetID, uint8_t callMode, uint8_t effectID = 0, uint8_t paletteID = 0);
 inline bool applyTemporaryPreset() {return applyPreset(255);};
 void savePreset(byte index, const char* pname = nullptr, JsonObject saveobj = JsonObject());
@@ -347,7 +373,6 @@ void handleRemote();
 //set.cpp
 bool isAsterisksOnly(const char* str, byte maxLen);
 void handleSettingsSet(AsyncWebServerRequest *request, byte subPage);
-bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=true);
 
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
@@ -487,6 +512,7 @@ void userLoop();
 #include "soc/wdev_reg.h"
 #define HW_RND_REGISTER REG_READ(WDEV_RND_REG)
 #endif
+#include "perlin.h" // perlin.cpp
 #define inoise8 perlin8   // fastled legacy alias
 #define inoise16 perlin16 // fastled legacy alias
 #define hex2int(a) (((a)>='0' && (a)<='9') ? (a)-'0' : ((a)>='A' && (a)<='F') ? (a)-'A'+10 : ((a)>='a' && (a)<='f') ? (a)-'a'+10 : 0)
@@ -504,11 +530,17 @@ void prepareHostname(char* hostname);
 [[gnu::pure]] bool isAsterisksOnly(const char* str, byte maxLen);
 bool requestJSONBufferLock(uint8_t moduleID=255);
 void releaseJSONBufferLock();
+void serializeJSONBufferInfo(JsonObject root);
+unsigned getHeapMaxBlock();
+unsigned getHeapFragmentation();
+void sampleHeap();
+void serializeHeapInfo(JsonObject heap);
 uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLen);
 uint8_t extractModeSlider(uint8_t mode, uint8_t slider, char *dest, uint8_t maxLen, uint8_t *var = nullptr);
 int16_t extractModeDefaults(uint8_t mode, const char *segVar);
 void checkSettingsPIN(const char *pin);
 uint16_t crc16(const unsigned char* data_p, size_t length);
+uint32_t fnv1a(const uint8_t *data, size_t length, uint32_t hash = 2166136261UL);
 uint16_t beatsin88_t(accum88 beats_per_minute_88, uint16_t lowest = 0, uint16_t highest = 65535, uint32_t timebase = 0, uint16_t phase_offset = 0);
 uint16_t beatsin16_t(accum88 beats_per_minute, uint16_t lowest = 0, uint16_t highest = 65535, uint32_t timebase = 0, uint16_t phase_offset = 0);
 uint8_t beatsin8_t(accum88 beats_per_minute, uint8_t lowest = 0, uint8_t highest = 255, uint32_t timebase = 0, uint8_t phase_offset = 0);
@@ -517,15 +549,6 @@ void enumerateLedmaps();
 [[gnu::hot]] uint8_t get_random_wheel_index(uint8_t pos);
 [[gnu::hot, gnu::pure]] float mapf(float x, float in_min, float in_max, float out_min, float out_max);
 uint32_t hashInt(uint32_t s);
-int32_t perlin1D_raw(uint32_t x, bool is16bit = false);
-int32_t perlin2D_raw(uint32_t x, uint32_t y, bool is16bit = false);
-int32_t perlin3D_raw(uint32_t x, uint32_t y, uint32_t z, bool is16bit = false);
-uint16_t perlin16(uint32_t x);
-uint16_t perlin16(uint32_t x, uint32_t y);
-uint16_t perlin16(uint32_t x, uint32_t y, uint32_t z);
-uint8_t perlin8(uint16_t x);
-uint8_t perlin8(uint16_t x, uint16_t y);
-uint8_t perlin8(uint16_t x, uint16_t y, uint16_t z);
 
 // fast (true) random numbers using hardware RNG, all functions return values in the range lowerlimit to upperlimit-1
 // note: for true random numbers with high entropy, do not call faster than every 200ns (5MHz)
@@ -576,6 +599,9 @@ int16_t sin16_t(uint16_t theta);
 int16_t cos16_t(uint16_t theta);
 uint8_t sin8_t(uint8_t theta);
 uint8_t cos8_t(uint8_t theta);
+int16_t sin16_lut(uint16_t theta); // table based, accuracy +/-2 LSB, faster than sin16_t()
+int16_t cos16_lut(uint16_t theta);
+uint16_t atan2_16(int32_t y, int32_t x); // integer atan2, returns angle in sin16_t() units (0-65535 = 0 to 2*pi)
 float sin_approx(float theta); // uses integer math (converted to float), accuracy +/-0.0015 (compared to sinf())
 float cos_approx(float theta);
 float tan_approx(float x);
@@ -586,6 +612,7 @@ template <typename T> T atan_t(T x);
 float floor_t(float x);
 float fmod_t(float num, float denom);
 uint32_t sqrt32_bw(uint32_t x);
+uint32_t sqrt32_lut(uint32_t x);
 #define sin_t sin_approx
 #define cos_t cos_approx
 #define tan_t tan_approx
@@ -0,0 +1,379 @@
+#include "wled.h"
+#include "http_api.h"
+
+/*
+ * HTTP API ("win&A=128&FX=5&..."), see https://kno.wled.ge/interfaces/http-api/
+ */
+
+static inline bool updateApiVal(const char *v, byte* val, byte minv=0, byte maxv=255)
+{
+  if (!v) return false;
+  parseNumber(v, val, minv, maxv);
+  return true;
+}
+
+// values are read in place (until next non-digit) so nothing needs to be terminated
+static bool applyHttpApi(AsyncWebServerRequest *request, const char *params, bool apply)
+{
+  DEBUG_PRINTF_P(PSTR("API req: %s\n"), params);
+
+  const char *v[API_KEY_COUNT];
+  httpApiParse(params, v);
+
+  //segment select (sets main segment)
+  if (v[API_SM] && !realtimeMode) {
+    strip.setMainSegmentId(atoi(v[API_SM]));
+  }
+
+  byte selectedSeg = strip.getFirstSelectedSegId();
+
+  bool singleSegment = false;
+
+  if (v[API_SS]) {
+    unsigned t = atoi(v[API_SS]);
+    if (t < strip.getSegmentsNum()) {
+      selectedSeg = t;
+      singleSegment = true;
+    }
+  }
+
+  Segment& selseg = strip.getSegment(selectedSeg);
+  if (v[API_SV]) { //segment selected
+    unsigned t = atoi(v[API_SV]);
+    if (t == 2) for (unsigned i = 0; i < strip.getSegmentsNum(); i++) strip.getSegment(i).selected = false; // unselect other segments
+    selseg.selected = t;
+  }
+
+  // temporary values, write directly to segments, globals are updated by setValuesFromFirstSelectedSeg()
+  uint32_t col0    = selseg.colors[0];
+  uint32_t col1    = selseg.colors[1];
+  uint32_t col2    = selseg.colors[2];
+  byte colIn[4]    = {R(col0), G(col0), B(col0), W(col0)};
+  byte colInSec[4] = {R(col1), G(col1), B(col1), W(col1)};
+  byte effectIn    = selseg.mode;
+  byte speedIn     = selseg.speed;
+  byte intensityIn = selseg.intensity;
+  byte paletteIn   = selseg.palette;
+  byte custom1In   = selseg.custom1;
+  byte custom2In   = selseg.custom2;
+  byte custom3In   = selseg.custom3;
+  byte check1In    = selseg.check1;
+  byte check2In    = selseg.check2;
+  byte check3In    = selseg.check3;
+  uint16_t startI  = selseg.start;
+  uint16_t stopI   = selseg.stop;
+  uint16_t startY  = selseg.startY;
+  uint16_t stopY   = selseg.stopY;
+  uint8_t  grpI    = selseg.grouping;
+  uint16_t spcI    = selseg.spacing;
+  if (v[API_S]) { //segment start
+    startI = std::abs(atoi(v[API_S]));
+  }
+  if (v[API_S2]) { //segment stop
+    stopI = std::abs(atoi(v[API_S2]));
+  }
+  if (v[API_GP]) { //segment grouping
+    grpI = std::max(1,atoi(v[API_GP]));
+  }
+  if (v[API_SP]) { //segment spacing
+    spcI = std::max(0,atoi(v[API_SP]));
+  }
+  strip.suspend(); // must suspend strip operations before changing geometry
+  selseg.setGeometry(startI, stopI, grpI, spcI, UINT16_MAX, startY, stopY, selseg.map1D2D);
+  strip.resume();
+
+  if (v[API_RV]) selseg.reverse = *v[API_RV] != '0'; //Segment reverse
+
+  if (v[API_MI]) selseg.mirror = *v[API_MI] != '0'; //Segment mirror
+
+  if (v[API_SB]) { //Segment brightness/opacity
+    byte segbri = atoi(v[API_SB]);
+    selseg.setOption(SEG_OPTION_ON, segbri); // use transition
+    if (segbri) {
+      selseg.setOpacity(segbri);
+    }
+  }
+
+  if (v[API_SW]) { //segment power
+    switch (atoi(v[API_SW])) {
+      case 0:  selseg.setOption(SEG_OPTION_ON, false);      break; // use transition
+      case 1:  selseg.setOption(SEG_OPTION_ON, true);       break; // use transition
+      default: selseg.setOption(SEG_OPTION_ON, !selseg.on); break; // use transition
+    }
+  }
+
+  if (v[API_PS]) savePreset(atoi(v[API_PS])); //saves current in preset
+
+  if (v[API_P1]) presetCycMin = atoi(v[API_P1]); //sets first preset for cycle
+
+  if (v[API_P2]) presetCycMax = atoi(v[API_P2]); //sets last preset for cycle
+
+  //apply preset
+  if (updateApiVal(v[API_PL], &presetCycCurr, presetCycMin, presetCycMax)) {
+    applyPreset(presetCycCurr);
+  }
+
+  if (v[API_NP]) doAdvancePlaylist = true; //advances to next preset in a playlist
+
+  //set brightness
+  updateApiVal(v[API_A], &bri);
+
+  bool col0Changed = false, col1Changed = false, col2Changed = false;
+  //set colors
+  col0Changed |= updateApiVal(v[API_R], &colIn[0]);
+  col0Changed |= updateApiVal(v[API_G], &colIn[1]);
+  col0Changed |= updateApiVal(v[API_B], &colIn[2]);
+  col0Changed |= updateApiVal(v[API_W], &colIn[3]);
+
+  col1Changed |= updateApiVal(v[API_R2], &colInSec[0]);
+  col1Changed |= updateApiVal(v[API_G2], &colInSec[1]);
+  col1Changed |= updateApiVal(v[API_B2], &colInSec[2]);
+  col1Changed |= updateApiVal(v[API_W2], &colInSec[3]);
+
+  #ifdef WLED_ENABLE_LOXONE
+  //lox parser
+  if (v[API_LX]) { // Lox primary color
+    int lxValue = atoi(v[API_LX]);
+    if (parseLx(lxValue, colIn)) {
+      bri = 255;
+      nightlightActive = false; //always disable nightlight when toggling
+      col0Changed = true;
+    }
+  }
+  if (v[API_LY]) { // Lox secondary color
+    int lxValue = atoi(v[API_LY]);
+    if(parseLx(lxValue, colInSec)) {
+      bri = 255;
+      nightlightActive = false; //always disable nightlight when toggling
+      col1Changed = true;
+    }
+  }
+  #endif
+
+  //set hue
+  if (v[API_HU]) {
+    uint16_t temphue = atoi(v[API_HU]);
+    byte tempsat = 255;
+    if (v[API_SA]) {
+      tempsat = atoi(v[API_SA]);
+    }
+    // as before: the byte holding indexOf("H2") was never 0 (255 if missing), so HU= always set the secondary color
+    colorHStoRGB(temphue, tempsat, colInSec);
+    col1Changed = true;
+  }
+
+  //set white spectrum (kelvin)
+  if (v[API_K]) {
+    colorKtoRGB(atoi(v[API_K]), colInSec); // always secondary color, same as HU=
+    col1Changed = true;
+  }
+
+  //set color from HEX or 32bit DEC
+  if (v[API_CL]) {
+    colorFromDecOrHexString(colIn, v[API_CL]);
+    col0Changed = true;
+  }
+  if (v[API_C2]) {
+    colorFromDecOrHexString(colInSec, v[API_C2]);
+    col1Changed = true;
+  }
+  if (v[API_C3]) {
+    byte tmpCol[4];
+    colorFromDecOrHexString(tmpCol, v[API_C3]);
+    col2 = RGBW32(tmpCol[0], tmpCol[1], tmpCol[2], tmpCol[3]);
+    selseg.setColor(2, col2); // defined above (SS= or main)
+    col2Changed = true;
+  }
+
+  //set to random hue SR=0->1st SR=1->2nd
+  if (v[API_SR]) {
+    byte sec = atoi(v[API_SR]);
+    setRandomColor(sec? colInSec : colIn);
+    col0Changed |= (!sec); col1Changed |= sec;
+  }
+
+  // apply colors to selected segment, and all selected segments if applicable
+  if (col0Changed) {
+    col0 = RGBW32(colIn[0], colIn[1], colIn[2], colIn[3]);
+    selseg.setColor(0, col0);
+  }
+
+  if (col1Changed) {
+    col1 = RGBW32(colInSec[0], colInSec[1], colInSec[2], colInSec[3]);
+    selseg.setColor(1, col1);
+  }
+
+  //swap 2nd & 1st
+  if (v[API_SC]) {
+    std::swap(col0,col1);
+    col0Changed = col1Changed = true;
+  }
+
+  bool fxModeChanged = false, speedChanged = false, intensityChanged = false, paletteChanged = false;
+  bool custom1Changed = false, custom2Changed = false, custom3Changed = false, check1Changed = false, check2Changed = false, check3Changed = false;
+  // set effect parameters
+  if (updateApiVal(v[API_FX], &effectIn, 0, strip.getModeCount()-1)) {
+    if (request != nullptr) unloadPlaylist(); // unload playlist if changing FX using web request
+    fxModeChanged = true;
+  }
+  speedChanged     = updateApiVal(v[API_SX], &speedIn);
+  intensityChanged = updateApiVal(v[API_IX], &intensityIn);
+  paletteChanged   = updateApiVal(v[API_FP], &paletteIn, 0, strip.getPaletteCount()-1);
+  custom1Changed   = updateApiVal(v[API_X1], &custom1In);
+  custom2Changed   = updateApiVal(v[API_X2], &custom2In);
+  custom3Changed   = updateApiVal(v[API_X3], &custom3In);
+  check1Changed    = updateApiVal(v[API_M1], &check1In);
+  check2Changed    = updateApiVal(v[API_M2], &check2In);
+  check3Changed    = updateApiVal(v[API_M3], &check3In);
+
+  stateChanged |= (fxModeChanged || speedChanged || intensityChanged || paletteChanged || custom1Changed || custom2Changed || custom3Changed || check1Changed || check2Changed || check3Changed);
+
+  // apply to main and all selected segments to prevent #1618.
+  for (unsigned i = 0; i < strip.getSegmentsNum(); i++) {
+    Segment& seg = strip.getSegment(i);
+    if (i != selectedSeg && (singleSegment || !seg.isActive() || !seg.isSelected())) continue; // skip non main segments if not applying to all
+    if (fxModeChanged)    seg.setMode(effectIn, v[API_FXD]);  // apply defaults if FXD= is specified
+    if (speedChanged)     seg.speed     = speedIn;
+    if (intensityChanged) seg.intensity = intensityIn;
+    if (paletteChanged)   seg.setPalette(paletteIn);
+    if (col0Changed)      seg.setColor(0, col0);
+    if (col1Changed)      seg.setColor(1, col1);
+    if (col2Changed)      seg.setColor(2, col2);
+    if (custom1Changed)   seg.custom1   = custom1In;
+    if (custom2Changed)   seg.custom2   = custom2In;
+    if (custom3Changed)   seg.custom3   = custom3In;
+    if (check1Changed)    seg.check1    = (bool)check1In;
+    if (check2Changed)    seg.check2    = (bool)check2In;
+    if (check3Changed)    seg.check3    = (bool)check3In;
+  }
+
+  //set advanced overlay
+  if (v[API_OL]) {
+    overlayCurrent = atoi(v[API_OL]);
+  }
+
+  //apply macro (deprecated, added for compatibility with pre-0.11 automations)
+  if (v[API_M]) {
+    applyPreset(atoi(v[API_M]) + 16);
+  }
+
+  //toggle send UDP direct notifications
+  if (v[API_SN]) notifyDirect = (*v[API_SN] != '0');
+
+  //toggle receive UDP direct notifications
+  if (v[API_RN]) receiveGroups = (*v[API_RN] != '0') ? receiveGroups | 1 : receiveGroups & 0xFE;
+
+  //receive live data via UDP/Hyperion
+  if (v[API_RD]) receiveDirect = (*v[API_RD] != '0');
+
+  //main toggle on/off (parse before nightlight, #1214)
+  if (v[API_T]) {
+    nightlightActive = false; //always disable nightlight when toggling
+    switch (atoi(v[API_T]))
+    {
+      case 0: if (bri != 0){briLast = bri; bri = 0;} break; //off, only if it was previously on
+      case 1: if (bri == 0) bri = briLast; break; //on, only if it was previously off
+      default: toggleOnOff(); //toggle
+    }
+  }
+
+  //toggle nightlight mode
+  bool aNlDef = v[API_ND];
+  if (v[API_NL])
+  {
+    if (*v[API_NL] == '0')
+    {
+      nightlightActive = false;
+    } else {
+      nightlightActive = true;
+      if (!aNlDef) nightlightDelayMins = atoi(v[API_NL]);
+      else         nightlightDelayMins = nightlightDelayMinsDefault;
+      nightlightStartTime = millis();
+    }
+  } else if (aNlDef)
+  {
+    nightlightActive = true;
+    nightlightDelayMins = nightlightDelayMinsDefault;
+    nightlightStartTime = millis();
+  }
+
+  //set nightlight target brightness
+  if (v[API_NT]) {
+    nightlightTargetBri = atoi(v[API_NT]);
+    nightlightActiveOld = false; //re-init
+  }
+
+  //toggle nightlight fade
+  if (v[API_NF])
+  {
+    nightlightMode = atoi(v[API_NF]);
+
+    nightlightActiveOld = false; //re-init
+  }
+  if (nightlightMode > NL_MODE_SUN) nightlightMode = NL_MODE_SUN;
+
+  if (v[API_TT]) transitionDelay = atoi(v[API_TT]);
+  strip.setTransition(transitionDelay);
+
+  //set time (unix timestamp)
+  if (v[API_ST]) {
+    setTimeFromAPI(atoi(v[API_ST]));
+  }
+
+  //set countdown goal (unix timestamp)
+  if (v[API_CT]) {
+    countdownTime = atoi(v[API_CT]);
+    if (countdownTime - toki.second() > 0) countdownOverTriggered = false;
+  }
+
+  if (v[API_LO]) {
+    realtimeOverride = atoi(v[API_LO]);
+    if (realtimeOverride > 2) realtimeOverride = REALTIME_OVERRIDE_ALWAYS;
+    if (realtimeMode && useMainSegmentOnly) {
+      strip.getMainSegment().freeze = !realtimeOverride;
+    }
+  }
+
+  if (v[API_RB]) doReboot = true;
+
+  // clock mode, 0: normal, 1: countdown
+  if (v[API_NM]) countdownMode = (*v[API_NM] != '0');
+
+  if (v[API_U0]) { //user var 0
+    userVar0 = atoi(v[API_U0]);
+  }
+
+  if (v[API_U1]) { //user var 1
+    userVar1 = atoi(v[API_U1]);
+  }
+  // you can add more if you need (key in HttpApiKey, httpApiKeys[] and httpApiSlots[] in http_api.h)
+
+  // global colPri[], effectCurrent, ... are updated in stateChanged()
+  if (!apply) return true; // when called by JSON API, do not call colorUpdated() here
+
+  stateUpdated(v[API_NN] ? CALL_MODE_NO_NOTIFY : CALL_MODE_DIRECT_CHANGE); //NN: do not send UDP notifications this time
+
+  // internal call (IN), does not send XML response
+  if (request != nullptr && !v[API_IN]) {
+    auto response = request->beginResponseStream("text/xml");
+    XML_response(*response);
+    request->send(response);
+  }
+
+  return true;
+}
+
+//HTTP API request parser, req is "win&A=128&..." (web request URL, IR and remote commands)
+bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
+{
+  const char *params = req.c_str();
+  if (!strstr(params, "win")) return false;
+  params = strchr(params, '&'); // keys in first part ("/win") are ignored
+  return applyHttpApi(request, params ? params + 1 : "", apply);
+}
+
+//HTTP API parameters without "win" prefix, i.e. "A=128&FX=5" (UDP, MQTT, JSON "win" and presets)
+bool handleHttpApi(const char *params, bool apply)
+{
+  return applyHttpApi(nullptr, params, apply);
+}
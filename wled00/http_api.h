@@ -0,0 +1,105 @@
+#pragma once
+#ifndef WLED_HTTP_API_H
+#define WLED_HTTP_API_H
+/*
+ * HTTP API request tokenizer (see handleSet() in http_api.cpp)
+ *
+ * Single pass over "A=128&FX=5&..." without copying. Keys are looked up in a perfect hash table, the apply code
+ * reads values in place from the first occurrence of each key. Flags are searched like the String::indexOf() based
+ * parser did (anywhere in the request, ND and NN only as key) so existing scripts and presets behave the same.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#ifdef ARDUINO
+#include <pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define strncmp_P(a, b, n) strncmp((a), (b), (n))
+#define strstr_P(a, b) strstr((a), (b))
+#endif
+
+//HTTP API keys, order must match httpApiKeys[]
+enum HttpApiKey : uint8_t {
+  API_SM, API_SS, API_SV, API_S, API_S2, API_GP, API_SP, API_RV, API_MI, API_SB, API_SW, API_PS, API_P1, API_P2, API_PL, API_NP,
+  API_A, API_R, API_G, API_B, API_W, API_R2, API_G2, API_B2, API_W2, API_LX, API_LY, API_HU, API_SA, API_H2, API_K, API_K2,
+  API_CL, API_C2, API_C3, API_SR, API_SC, API_FX, API_FXD, API_SX, API_IX, API_FP, API_X1, API_X2, API_X3, API_M1, API_M2, API_M3,
+  API_OL, API_M, API_SN, API_RN, API_RD, API_T, API_ND, API_NL, API_NT, API_NF, API_TT, API_ST, API_CT, API_LO, API_RB, API_NM,
+  API_U0, API_U1, API_NN, API_IN,
+  API_KEY_COUNT
+};
+
+// keys ending with '=' need a value, the others are flags (a value is allowed but only read for SR)
+static const char httpApiKeys[API_KEY_COUNT][5] PROGMEM = {
+  "SM=", "SS=", "SV=", "S=",  "S2=", "GP=", "SP=",  "RV=", "MI=", "SB=", "SW=", "PS=", "P1=", "P2=", "PL=", "NP",
+  "A=",  "R=",  "G=",  "B=",  "W=",  "R2=", "G2=",  "B2=", "W2=", "LX=", "LY=", "HU=", "SA=", "H2",  "K=",  "K2",
+  "CL=", "C2=", "C3=", "SR",  "SC",  "FX=", "FXD=", "SX=", "IX=", "FP=", "X1=", "X2=", "X3=", "M1=", "M2=", "M3=",
+  "OL=", "M=",  "SN=", "RN=", "RD=", "T=",  "ND",   "NL=", "NT=", "NF=", "TT=", "ST=", "CT=", "LO=", "RB",  "NM=",
+  "U0=", "U1=", "NN",  "IN"
+};
+
+// perfect hash of the keys above: slot ((c0*3) ^ (c1*54) ^ c2) & 255 holds key index + 1 (0: no key)
+// collision free for the current keys only, when adding a key pick a free slot or new multipliers
+static const uint8_t httpApiSlots[256] PROGMEM = {
+   0,  0,  0,  0,  0, 21, 39,  0,  0,  0, 16, 35,  0,  0,  0,  0,
+   0,  0,  0,  0,  0, 10,  0,  0,  0,  7, 63,  0,  0,  0,  0,  0,
+   0,  0, 27,  0,  0, 48,  0,  0,  0,  0,  0,  0,  0,  0, 58,  0,
+   0,  0, 42,  0,  0,  6, 28,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0, 60, 38,  0, 59, 34,  0,  0,  0,  0, 24, 41,  0,  0, 62, 29,
+   0,  0, 57,  0, 30,  0,  0,  0,  0, 23,  0,  0,  0,  0, 43,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0, 40,  0, 47,  0, 32,  0,  0,
+   0, 61, 12,  0, 26,  5,  0,  0,  0,  0, 22,  2, 14,  0,  0,  0,
+   0,  9, 52,  0, 44,  0,  0,  0,  0, 25,  0,  0,  0, 51,  0,  0,
+   0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 67,  0,
+   0,  0,  0, 11,  0,  0, 13,  0,  0, 66,  0,  0,  0,  0, 53, 68,
+   0, 46, 55,  0,  0, 36,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+   0, 33,  0, 17,  0,  0, 20,  1,  0,  0, 45,  0,  0,  0,  0,  0,
+   0,  0,  8,  0, 64, 19,  0,  0,  0,  0,  0, 37,  0,  3,  0, 65,
+   0, 31, 56,  0,  0, 49,  0, 50,  0,  0,  0,  0,  0,  0,  0,  0,
+   0,  0,  0,  0,  0,  0, 18,  0, 15,  4,  0,  0, 54,  0,  0,  0,
+};
+
+// returns index of key (len characters, followed by '=' if hasValue) or -1 if unknown
+static inline int httpApiKey(const char *key, size_t len, bool hasValue)
+{
+  if (len == 0 || len > 3) return -1;
+  uint8_t c1 = len > 1 ? key[1] : 0;
+  uint8_t c2 = len > 2 ? key[2] : 0;
+  int k = (int)pgm_read_byte(httpApiSlots + ((((uint8_t)key[0] * 3) ^ (c1 * 54) ^ c2) & 0xFF)) - 1;
+  if (k < 0 || strncmp_P(key, httpApiKeys[k], len) != 0) return -1;
+  char next = pgm_read_byte(httpApiKeys[k] + len);
+  return (next == '\0' || (next == '=' && hasValue)) ? k : -1;
+}
+
+// first occurrence of flag k: anywhere (i.e. "H2" in "CL=H2F00FF"), ND and NN only at the start of a key
+// returns what follows the flag and one more character (SR=1 reads 1, SR&... reads 0), nullptr if not given
+static inline const char *httpApiFlag(const char *params, unsigned k)
+{
+  const bool atKey = k == API_ND || k == API_NN;
+  for (const char *p = strstr_P(params, httpApiKeys[k]); p; p = strstr_P(p + 1, httpApiKeys[k])) {
+    if (atKey && p != params && p[-1] != '&') continue;
+    return p[2] ? p + 3 : p + 2;
+  }
+  return nullptr;
+}
+
+// v[key] points to the value of the first occurrence of each key (nullptr if not given)
+static inline void httpApiParse(const char *params, const char *v[API_KEY_COUNT])
+{
+  for (unsigned k = 0; k < API_KEY_COUNT; k++) v[k] = nullptr;
+  for (const char *p = params; *p; ) {
+    const char *key = p;
+    while (*p && *p != '=' && *p != '&') p++;
+    int k = httpApiKey(key, p - key, *p == '=');
+    if (k >= 0 && !v[k] && pgm_read_byte(httpApiKeys[k] + (p - key)) == '=') v[k] = p + 1;
+    while (*p && *p != '&') p++;
+    if (*p) p++;
+  }
+  for (unsigned k = 0; k < API_KEY_COUNT; k++) {
+    if (pgm_read_byte(httpApiKeys[k] + 1) != '=' && pgm_read_byte(httpApiKeys[k] + 2) == '\0') v[k] = httpApiFlag(params, k);
+  }
+}
+
+#endif
@@ -57,29 +57,12 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   }
 
   if (elem["n"]) {
-    // name field exists
-    if (seg.name) { //clear old name
-      free(seg.name);
-      seg.name = nullptr;
-    }
-
-    const char * name = elem["n"].as<const char*>();
-    size_t len = 0;
-    if (name != nullptr) len = strlen(name);
-    if (len > 0) {
-      if (len > WLED_MAX_SEGNAME_LEN) len = WLED_MAX_SEGNAME_LEN;
-      seg.name = static_cast<char*>(malloc(len+1));
-      if (seg.name) strlcpy(seg.name, name, WLED_MAX_SEGNAME_LEN+1);
-    } else {
-      // but is empty (already deleted above)
-      elem.remove("n");
-    }
+    // name field exists (empty name clears old one)
+    seg.setName(elem["n"].as<const char*>()); // name is taken from segment pool
+    if (!seg.name) elem.remove("n");
   } else if (start != seg.start || stop != seg.stop) {
     // clearing or setting segment without name field
-    if (seg.name) {
-      free(seg.name);
-      seg.name = nullptr;
-    }
+    seg.clearName();
   }
 
   uint16_t grp       = elem["grp"] | seg.grouping;
@@ -291,11 +274,12 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   return true;
 }
 
-// deserializes WLED state
-// presetId is non-0 if called from handlePreset()
-bool deserializeState(JsonObject root, byte callMode, byte presetId)
+// applies WLED state without calling stateUpdated(), callMode may be changed by the request (i.e. "nn" or playlist)
+// returns true if stateUpdated() has to be called, presetToRestore is the preset to restore after it (0 if none)
+static bool applyState(JsonObject root, byte &callMode, byte presetId, byte &presetToRestore)
 {
-  bool stateResponse = root[F("v")] | false;
+  // state to be applied at a given cluster time (same frame on all synchronized nodes)
+  if (!presetId && !root[F("at")].isNull() && queueTimedState(root)) return false;
 
   #if defined(WLED_DEBUG) && defined(WLED_DEBUG_HOST)
   netDebugEnabled = root[F("debug")] | netDebugEnabled;
@@ -387,6 +371,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   JsonVariant segVar = root["seg"];
   if (!segVar.isNull()) {
     // we may be called during strip.service() so we must not modify segments while effects are executing
+    bool wasSuspended = strip.isSuspended(); // i.e. when applying a batch
     strip.suspend();
     const unsigned long start = millis();
     while (strip.isServicing() && millis() - start < strip.getFrameTime()) yield(); // wait until frame is over
@@ -415,7 +400,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
       }
       if (strip.getSegmentsNum() > 3 && deleted >= strip.getSegmentsNum()/2U) strip.purgeSegments(); // batch deleting more than half segments
     }
-    strip.resume();
+    if (!wasSuspended) strip.resume();
   }
 
   UsermodManager::readFromJsonState(root);
@@ -430,17 +415,13 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
 
   // HTTP API commands (must be handled before "ps")
   const char* httpwin = root["win"];
-  if (httpwin) {
-    String apireq = "win"; apireq += '&'; // reduce flash string usage
-    apireq += httpwin;
-    handleSet(nullptr, apireq, false);    // may set stateChanged
-  }
+  if (httpwin) handleHttpApi(httpwin, false); // may set stateChanged
 
   // Applying preset from JSON API has 2 cases: a) "pd" AKA "preset direct" and b) "ps" AKA "preset select"
   // a) "preset direct" can only be an integer value representing preset ID. "preset direct" assumes JSON API contains the rest of preset content (i.e. from UI call)
   //    "preset direct" JSON can contain "ps" API (i.e. call from UI to cycle presets) in such case stateChanged has to be false (i.e. no "win" or "seg" API)
   // b) "preset select" can be cycling ("1~5~""), random ("r" or "1~5r"), ID, etc. value allowed from JSON API. This type of call assumes no state changing content in API call
-  byte presetToRestore = 0;
+  presetToRestore = 0;
   if (!root[F("pd")].isNull() && stateChanged) {
     // a) already applied preset content (requires "seg" or "win" but will ignore the rest)
     currentPreset = root[F("pd")] | currentPreset;
@@ -453,7 +434,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
       DEBUG_PRINTF_P(PSTR("Preset select: %d\n"), presetCycCurr);
       // b) preset ID only or preset that does not change state (use embedded cycling limits if they exist in getVal())
       applyPreset(presetCycCurr, callMode); // async load from file system (only preset ID was specified)
-      return stateResponse;
+      return false;
     } else presetCycCurr = currentPreset; // restore presetCycCurr
   }
 
@@ -469,7 +450,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
       char fileName[32];
       sprintf_P(fileName, PSTR("/palette%d.json"), strip.customPalettes.size()-1);
       if (WLED_FS.exists(fileName)) WLED_FS.remove(fileName);
-      strip.loadCustomPalettes();
+      strip.loadCustomPalettes(true);
     }
   }
 
@@ -488,12 +469,53 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     //if (restart) forceReconnect = true;
   }
 
-  stateUpdated(callMode);
-  if (presetToRestore) currentPreset = presetToRestore;
+  return true;
+}
 
+// deserializes WLED state
+// presetId is non-0 if called from handlePreset()
+bool deserializeState(JsonObject root, byte callMode, byte presetId)
+{
+  bool stateResponse = root[F("v")] | false;
+  byte presetToRestore = 0;
+  if (applyState(root, callMode, presetId, presetToRestore)) {
+    stateUpdated(callMode);
+    if (presetToRestore) currentPreset = presetToRestore;
+  }
   return stateResponse;
 }
 
+// apply an array of state patches as a single change: strip is suspended for the whole batch so all patches
+// take effect on the same frame and stateUpdated() (notification, WS/MQTT update) is only called once at the end
+// the batch notifies if any of its patches would have (a patch with "nn" does not), otherwise CALL_MODE_NO_NOTIFY is used
+// returns number of patches applied
+unsigned deserializeStateBatch(JsonArray patches, byte callMode)
+{
+  unsigned applied = 0;
+  bool update = false;
+  byte batchCallMode = CALL_MODE_NO_NOTIFY;
+  byte presetToRestore = 0;
+  bool wasSuspended = strip.isSuspended();
+  strip.suspend();
+  const unsigned long start = millis();
+  while (strip.isServicing() && millis() - start < strip.getFrameTime()) yield(); // wait until frame is over
+  for (JsonObject patch : patches) {
+    if (patch.isNull()) continue;
+    byte patchCallMode = callMode;
+    if (applyState(patch, patchCallMode, 0, presetToRestore)) {
+      update = true;
+      if (patchCallMode != CALL_MODE_NO_NOTIFY) batchCallMode = patchCallMode;
+    }
+    applied++;
+  }
+  if (!wasSuspended) strip.resume();
+  if (update) {
+    stateUpdated(batchCallMode);
+    if (presetToRestore) currentPreset = presetToRestore;
+  }
+  return applied;
+}
+
 void serializeSegment(const JsonObject& root, const Segment& seg, byte id, bool forPreset, bool segmentBounds)
 {
   root["id"] = id;
@@ -634,6 +656,13 @@ void serializeInfo(JsonObject root)
   leds[F("count")] = strip.getLengthTotal();
   leds[F("pwr")] = BusManager::currentMilliamps();
   leds["fps"] = strip.getFps();
+  JsonObject frame = leds.createNestedObject(F("frame")); // frame pacing: missed deadlines, dropped effect steps, start delay vs. deadline (ms)
+  frame[F("miss")] = strip.getFramesMissed();
+  frame[F("skip")] = strip.getStepsSkipped();
+  frame[F("jit")]  = roundf(strip.getFrameJitter() * 10.0f) / 10.0f;
+  frame[F("jmax")] = strip.getFrameJitterMax();
+  JsonArray wait = frame.createNestedArray(F("wait")); // per bus time (us) show() waited for previous frame to be sent
+  for (size_t b = 0; b < BusManager::getNumBusses(); b++) wait.add(BusManager::getBus(b)->getShowWait());
   leds[F("maxpwr")] = BusManager::currentMilliamps()>0 ? BusManager::ablMilliampsMax() : 0;
   leds[F("maxseg")] = strip.getMaxSegments();
   //leds[F("actseg")] = strip.getActiveSegmentsNum();
@@ -705,6 +734,7 @@ void serializeInfo(JsonObject root)
   root[F("fxcount")] = strip.getModeCount();
   root[F("palcount")] = strip.getPaletteCount();
   root[F("cpalcount")] = strip.customPalettes.size(); //number of custom palettes
+  root[F("cpalmax")] = WLED_MAX_CUSTOM_PALETTES;
 
   JsonArray ledmaps = root.createNestedArray(F("maps"));
   for (size_t i=0; i<WLED_MAX_LEDMAPS; i++) {
@@ -729,6 +759,19 @@ void serializeInfo(JsonObject root)
   fs_info["u"] = fsBytesUsed / 1000;
   fs_info["t"] = fsBytesTotal / 1000;
   fs_info[F("pmt")] = presetsModifiedTime;
+  serializePlaylistStepInfo(root);
+  serializeClusterClockInfo(root);
+  serializeJSONBufferInfo(root);
+
+  JsonObject boot = root.createNestedObject(F("boot")); // boot phase timings (ms)
+  boot["fs"]       = bootTimes.fs;
+  boot[F("cfg")]   = bootTimes.cfg;
+  boot[F("bin")]   = bootTimes.cfgBinary; // config read from snapshot instead of cfg.json
+  boot[F("strip")] = bootTimes.strip;
+  boot["um"]       = bootTimes.um;
+  boot[F("srv")]   = bootTimes.srv;
+  boot[F("setup")] = bootTimes.setup;
+  boot[F("light")] = bootTimes.light;
 
   root[F("ndc")] = nodeListEnabled ? (int)Nodes.size() : -1;
 
@@ -764,6 +807,25 @@ void serializeInfo(JsonObject root)
 #endif
 
   root[F("freeheap")] = ESP.getFreeHeap();
+
+  // heap fragmentation (largest allocatable block vs. free heap) and its history, segment pool and transition arena usage
+  JsonObject heap = root.createNestedObject(F("heap"));
+  serializeHeapInfo(heap);
+  #ifdef SEGMENT_POOL_SIZE
+  const slab_stats_t &pool = Segment::getSegmentPool().stats();
+  JsonObject sp = heap.createNestedObject(F("pool"));
+  sp[F("sz")]   = Segment::getSegmentPool().capacity();
+  sp[F("use")]  = pool.used;                                // bytes in blocks handed out
+  sp[F("pg")]   = pool.pages;                               // pages assigned to a size class
+  sp[F("pk")]   = pool.peakPages;
+  sp["n"]       = pool.allocs;
+  sp[F("fb")]   = pool.fallbacks;                           // allocations served from heap
+  #endif
+  heap[F("tr")]     = Segment::getTransitionsActive();      // transitions running (arena slots in use)
+  heap[F("trpk")]   = Segment::getTransitionsPeak();        // max. concurrent transitions
+  heap[F("trdata")] = Segment::getTransitionDataUsed();     // bytes of effect data snapshots
+  heap[F("trheap")] = Segment::getTransitionHeapFallbacks(); // allocations that did not fit into arena
+  heap[F("trho")]   = Segment::getTransitionHandovers();    // effect data handed over without copy
   #if defined(ARDUINO_ARCH_ESP32)
   if (psramFound()) root[F("psram")] = ESP.getFreePsram();
   #endif
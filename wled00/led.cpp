@@ -104,6 +104,9 @@ void stateUpdated(byte callMode) {
 
     //set flag to update ws and mqtt
     interfaceUpdateCallMode = callMode;
+    #ifndef WLED_DISABLE_MQTT
+    publishMqtt(); // published at its own (higher) rate, only what changed
+    #endif
     stateChanged = false;
   } else {
     if (nightlightActive && !nightlightActiveOld && callMode != CALL_MODE_NOTIFICATION && callMode != CALL_MODE_NO_NOTIFY) {
@@ -6,6 +6,18 @@
 
 #ifndef WLED_DISABLE_MQTT
 #define MQTT_KEEP_ALIVE_TIME 60    // contact the MQTT broker every 60 seconds
+#ifndef WLED_MQTT_PUBLISH_INTERVAL
+  #define WLED_MQTT_PUBLISH_INTERVAL 100 // min. ms between state publishes, changes in between are coalesced
+#endif
+
+// state as last published, only changed topics are published
+static bool          mqttPublishPending = false;
+static bool          mqttPublishAll = true; // after (re)connect
+static unsigned long mqttLastPublish = 0;
+static uint8_t       mqttLastBri = 0;
+static uint32_t      mqttLastCol = 0;
+static uint32_t      mqttLastXml = 0;
+static uint32_t      mqttLastSeg[MAX_NUM_SEGMENTS]; // hash of segment state, 0: not published
 
 #if MQTT_MAX_TOPIC_LEN > 32
 #warning "MQTT topics length > 32 is not recommended for compatibility with usermods!"
@@ -24,6 +36,59 @@ static void parseMQTTBriPayload(char* payload)
 }
 
 
+// fast path for high rate brightness/color commands on /api (i.e. sliders, automations) bypassing handleSet() and the JSON buffer lock
+// accepts any combination of A=<bri>, T=<0|1|2>, CL=<color>, C2=<color> separated by &, returns false for anything else
+static bool parseMQTTFastApi(const char* payload)
+{
+  byte newBri = bri, c0[4], c1[4];
+  int  toggle = -1;
+  bool setBri = false, col0 = false, col1 = false;
+  const char *p = payload;
+  while (true) {
+    const char *eq = strchr(p, '=');
+    if (!eq || eq == p || eq - p > 2) return false;
+    const char *end = strchr(eq, '&');
+    if (!end) end = eq + strlen(eq);
+    size_t klen = eq - p, vlen = end - eq - 1;
+    if (vlen == 0 || vlen > 10) return false;
+    char val[11];
+    memcpy(val, eq + 1, vlen);
+    val[vlen] = 0;
+    if (klen == 1 && p[0] == 'A') {
+      for (size_t i = 0; i < vlen; i++) if (!isdigit(val[i])) return false; // no increments or random values
+      newBri = min(atoi(val), 255);
+      setBri = true;
+    } else if (klen == 1 && p[0] == 'T') {
+      if (vlen != 1 || val[0] < '0' || val[0] > '2') return false;
+      toggle = val[0] - '0';
+    } else if (klen == 2 && p[0] == 'C' && (p[1] == 'L' || p[1] == '2')) {
+      bool hex = (val[0] == 'h' || val[0] == 'H' || val[0] == '#');
+      for (size_t i = hex; i < vlen; i++) if (!(hex ? isxdigit(val[i]) : isdigit(val[i]))) return false;
+      colorFromDecOrHexString(p[1] == 'L' ? c0 : c1, val);
+      (p[1] == 'L' ? col0 : col1) = true;
+    } else return false;
+    if (*end == 0) break;
+    p = end + 1;
+  }
+
+  if (col0) memcpy(colPri, c0, sizeof(c0));
+  if (col1) memcpy(colSec, c1, sizeof(c1));
+  if (setBri) {
+    if (newBri == 0 && bri > 0) briLast = bri;
+    bri = newBri;
+  }
+  switch (toggle) { // same as T= in handleSet()
+    case 0: if (bri != 0) { briLast = bri; bri = 0; } break;
+    case 1: if (bri == 0) bri = briLast; break;
+    case 2: toggleOnOff(); break;
+  }
+  if (toggle >= 0) nightlightActive = false;
+  if (col0 || col1) colorUpdated(CALL_MODE_DIRECT_CHANGE);
+  else              stateUpdated(CALL_MODE_DIRECT_CHANGE);
+  return true;
+}
+
+
 static void onMqttConnect(bool sessionPresent)
 {
   //(re)subscribe to required topics
@@ -52,6 +117,11 @@ static void onMqttConnect(bool sessionPresent)
   UsermodManager::onMqttConnect(sessionPresent);
 
   DEBUG_PRINTLN(F("MQTT ready"));
+  #ifndef USERMOD_SMARTNEST
+  mqtt->publish(mqttStatusTopic, 0, true, "online"); // retain message for a LWT (once per connection)
+  #endif
+  mqttPublishAll = true;
+  memset(mqttLastSeg, 0, sizeof(mqttLastSeg));
   publishMqtt();
 }
 
@@ -106,14 +176,14 @@ static void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProp
     colorFromDecOrHexString(colPri, payloadStr);
     colorUpdated(CALL_MODE_DIRECT_CHANGE);
   } else if (strcmp_P(topic, PSTR("/api")) == 0) {
-    if (requestJSONBufferLock(15)) {
+    if (payloadStr[0] != '{' && parseMQTTFastApi(payloadStr)) {
+      // handled without HTTP API parser
+    } else if (requestJSONBufferLock(15)) {
       if (payloadStr[0] == '{') { //JSON API
         deserializeJson(*pDoc, payloadStr);
         deserializeState(pDoc->as<JsonObject>());
       } else { //HTTP API
-        String apireq = "win"; apireq += '&'; // reduce flash string usage
-        apireq += payloadStr;
-        handleSet(nullptr, apireq);
+        handleHttpApi(payloadStr);
       }
       releaseJSONBufferLock();
     }
@@ -155,36 +225,90 @@ class bufferPrint : public Print {
 }; // anonymous namespace
 
 
+// request state publish, done by handleMqtt() at a bounded rate
 void publishMqtt()
 {
-  if (!WLED_MQTT_CONNECTED) return;
+  mqttPublishPending = true;
+}
+
+
+#ifndef USERMOD_SMARTNEST
+static void publishTopic(char *subuf, const char *suffix, const char *payload, size_t len)
+{
+  strlcpy(subuf, mqttDeviceTopic, MQTT_MAX_TOPIC_LEN + 1);
+  strcat_P(subuf, suffix);
+  mqtt->publish(subuf, 0, retainMqttMsg, payload, len); // optionally retain message (#2263)
+}
+
+static size_t printHexColor(char *out, uint32_t c)
+{
+  if (W(c)) return sprintf_P(out, PSTR("\"%06X%02X\""), (unsigned)(c & 0xFFFFFF), (unsigned)W(c)); // RRGGBBWW
+  return sprintf_P(out, PSTR("\"%06X\""), (unsigned)(c & 0xFFFFFF));
+}
+
+// compact segment state using JSON API keys (can be sent back to /api as {"seg":[...]})
+static size_t segmentStateJson(const Segment &seg, unsigned id, char *out)
+{
+  size_t len = sprintf_P(out, PSTR("{\"id\":%u,\"start\":%u,\"stop\":%u,\"on\":%s,\"bri\":%u,\"fx\":%u,\"sx\":%u,\"ix\":%u,\"pal\":%u,\"col\":["),
+    id, seg.start, seg.stop, seg.on ? "true" : "false", seg.opacity, seg.mode, seg.speed, seg.intensity, seg.palette);
+  for (unsigned i = 0; i < NUM_COLORS; i++) {
+    if (i) out[len++] = ',';
+    len += printHexColor(out + len, seg.colors[i]);
+  }
+  out[len++] = ']';
+  out[len++] = '}';
+  out[len] = 0;
+  return len;
+}
+#endif
+
+void handleMqtt()
+{
+  if (!mqttPublishPending || millis() - mqttLastPublish < WLED_MQTT_PUBLISH_INTERVAL) return;
+  if (!WLED_MQTT_CONNECTED) return; // publish when connected
+  mqttPublishPending = false;
+  mqttLastPublish = millis();
   DEBUG_PRINTLN(F("Publish MQTT"));
 
   #ifndef USERMOD_SMARTNEST
-  char s[10];
+  char s[160];
   char subuf[MQTT_MAX_TOPIC_LEN + 16];
 
-  sprintf_P(s, PSTR("%u"), bri);
-  strlcpy(subuf, mqttDeviceTopic, MQTT_MAX_TOPIC_LEN + 1);
-  strcat_P(subuf, PSTR("/g"));
-  mqtt->publish(subuf, 0, retainMqttMsg, s);         // optionally retain message (#2263)
-
-  sprintf_P(s, PSTR("#%06X"), (colPri[3] << 24) | (colPri[0] << 16) | (colPri[1] << 8) | (colPri[2]));
-  strlcpy(subuf, mqttDeviceTopic, MQTT_MAX_TOPIC_LEN + 1);
-  strcat_P(subuf, PSTR("/c"));
-  mqtt->publish(subuf, 0, retainMqttMsg, s);         // optionally retain message (#2263)
+  if (mqttPublishAll || bri != mqttLastBri) {
+    publishTopic(subuf, PSTR("/g"), s, sprintf_P(s, PSTR("%u"), bri));
+    mqttLastBri = bri;
+  }
 
-  strlcpy(subuf, mqttDeviceTopic, MQTT_MAX_TOPIC_LEN + 1);
-  strcat_P(subuf, PSTR("/status"));
-  mqtt->publish(subuf, 0, true, "online");          // retain message for a LWT
+  uint32_t col = (colPri[3] << 24) | (colPri[0] << 16) | (colPri[1] << 8) | (colPri[2]);
+  if (mqttPublishAll || col != mqttLastCol) {
+    publishTopic(subuf, PSTR("/c"), s, sprintf_P(s, PSTR("#%06X"), col));
+    mqttLastCol = col;
+  }
 
   // TODO: use a DynamicBufferList.  Requires a list-read-capable MQTT client API.
   DynamicBuffer buf(1024);
   bufferPrint pbuf(buf.data(), buf.size());
   XML_response(pbuf);
-  strlcpy(subuf, mqttDeviceTopic, MQTT_MAX_TOPIC_LEN + 1);
-  strcat_P(subuf, PSTR("/v"));
-  mqtt->publish(subuf, 0, retainMqttMsg, buf.data(), pbuf.size());   // optionally retain message (#2263)
+  uint32_t hash = fnv1a((const uint8_t*)buf.data(), pbuf.size());
+  if (mqttPublishAll || hash != mqttLastXml) {
+    publishTopic(subuf, PSTR("/v"), buf.data(), pbuf.size());
+    mqttLastXml = hash;
+  }
+
+  // per segment state, removed segments are cleared with an empty message
+  for (unsigned i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    size_t len = 0;
+    if (i < strip.getSegmentsNum() && strip.getSegment(i).isActive()) len = segmentStateJson(strip.getSegment(i), i, s);
+    hash = len ? fnv1a((const uint8_t*)s, len) | 1 : 0;
+    if (hash == mqttLastSeg[i]) continue;
+    char seg[8];
+    sprintf_P(seg, PSTR("/seg/%u"), i);
+    strlcpy(subuf, mqttDeviceTopic, MQTT_MAX_TOPIC_LEN + 1);
+    strcat(subuf, seg);
+    mqtt->publish(subuf, 0, retainMqttMsg, len ? s : nullptr, len);
+    mqttLastSeg[i] = hash;
+  }
+  mqttPublishAll = false;
   #endif
 }
 
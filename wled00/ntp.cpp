@@ -173,6 +173,7 @@ void handleTime() {
     checkTimers();
     checkCountdown();
   }
+  handleSchedule();
 }
 
 void handleNetworkTime()
@@ -0,0 +1,26 @@
+#pragma once
+#ifndef WLED_PERLIN_H
+#define WLED_PERLIN_H
+/*
+ * Fixed point integer based Perlin noise (perlin.cpp), replaces fastled inoise8()/inoise16()
+ */
+
+#include <stdint.h>
+
+int32_t perlin1D_raw(uint32_t x, bool is16bit = false);
+int32_t perlin2D_raw(uint32_t x, uint32_t y, bool is16bit = false);
+int32_t perlin3D_raw(uint32_t x, uint32_t y, uint32_t z, bool is16bit = false);
+uint16_t perlin16(uint32_t x);
+uint16_t perlin16(uint32_t x, uint32_t y);
+uint16_t perlin16(uint32_t x, uint32_t y, uint32_t z);
+uint8_t perlin8(uint16_t x);
+uint8_t perlin8(uint16_t x, uint16_t y);
+uint8_t perlin8(uint16_t x, uint16_t y, uint16_t z);
+#define PERLIN_CHUNK 32 // number of noise samples effects generate per perlinXLine() call (stack buffer size)
+// noise field generators: fill count samples at (x + i*dx, y + i*dy[, z + i*dz]), bit-exact to perlin16()/perlin8() but faster
+void perlin16Line(uint16_t *out, unsigned count, uint32_t x, uint32_t y, uint32_t dx, uint32_t dy);
+void perlin16Line(uint16_t *out, unsigned count, uint32_t x, uint32_t y, uint32_t z, uint32_t dx, uint32_t dy, uint32_t dz);
+void perlin8Line(uint8_t *out, unsigned count, uint16_t x, uint16_t y, uint16_t dx, uint16_t dy);
+void perlin8Line(uint8_t *out, unsigned count, uint16_t x, uint16_t y, uint16_t z, uint16_t dx, uint16_t dy, uint16_t dz);
+
+#endif
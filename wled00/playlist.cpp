@@ -18,6 +18,8 @@ static PlaylistEntry *playlistEntries = nullptr;
 static byte           playlistLen;               //number of playlist entries
 static int8_t         playlistIndex = -1;
 static uint16_t       playlistEntryDur = 0;      //duration of the current entry in tenths of seconds
+static unsigned long  presetCycledTime = 0;      //millis() at which the current entry started (its deadline, see handlePlaylist())
+static unsigned long  playlistStartTime = 0;     //millis() at which the playlist was meant to start (earlier if started late by "at")
 
 //values we need to keep about the parent playlist while inside sub-playlist
 static int16_t        parentPlaylistIndex = -1;
@@ -137,17 +139,42 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
   }
 
   currentPlaylist = presetId;
+  playlistStartTime = millis() - getTimedStateDelay(); // first entry starts at the time given with "at"
   DEBUG_PRINTLN(F("Playlist loaded."));
   return currentPlaylist;
 }
 
 
+// preset of the next entry if it is known in advance (not when shuffling)
+static byte nextPlaylistPreset() {
+  if (playlistIndex + 1 < playlistLen) return playlistEntries[playlistIndex + 1].preset;
+  if (playlistRepeat == 1) return parentPlaylistPresetId > 0 ? parentPlaylistPresetId : playlistEndPreset;
+  return (playlistOptions & PL_OPTION_SHUFFLE) ? 0 : playlistEntries[0].preset;
+}
+
+
+// ms until the current entry ends (UINT32_MAX if it does not), the loop wakes up for it so entries change on time
+uint32_t getTimeToNextPlaylistEntry() {
+  if (currentPlaylist < 0 || playlistEntries == nullptr || playlistEntryDur == UINT16_MAX) return UINT32_MAX;
+  long left = 100L * playlistEntryDur - (long)(millis() - presetCycledTime);
+  return left < 0 ? 0 : left + 1; // entry ends once more than its duration has elapsed
+}
+
+
 void handlePlaylist() {
-  static unsigned long presetCycledTime = 0;
+  // entries are timed in local time, cluster clock corrections move the deadline along so entries of a playlist started
+  // on all nodes with "at" keep changing in the same frame (large jumps, i.e. first lock, restart entry timing instead)
+  int32_t shift = clusterClockShift();
   if (currentPlaylist < 0 || playlistEntries == nullptr) return;
-
-  if ((playlistEntryDur < UINT16_MAX && millis() - presetCycledTime > 100 * playlistEntryDur) || doAdvancePlaylist) {
-    presetCycledTime = millis();
+  if (shift && (unsigned)abs(shift) < 100U * playlistEntryDur) presetCycledTime -= shift;
+
+  unsigned long now = millis();
+  long elapsed = (long)(now - presetCycledTime); // may be negative after cluster clock stepped back
+  if ((playlistEntryDur < UINT16_MAX && (playlistEntryDur == 0 || elapsed > 100L * playlistEntryDur)) || doAdvancePlaylist) {
+    // keep entries on their schedule (next entry is timed from this deadline, not from when it was noticed) unless far behind
+    if (!doAdvancePlaylist && playlistEntryDur > 0 && elapsed < 200L * playlistEntryDur) presetCycledTime += 100 * playlistEntryDur;
+    else if (playlistIndex < 0 && !doAdvancePlaylist && (long)(now - playlistStartTime) < 1000) presetCycledTime = playlistStartTime;
+    else presetCycledTime = now;
     if (bri == 0 || nightlightActive) return;
 
     ++playlistIndex %= playlistLen; // -1 at 1st run (limit to playlistLen)
@@ -172,6 +199,8 @@ void handlePlaylist() {
     playlistEntryDur = playlistEntries[playlistIndex].dur > 0 ? playlistEntries[playlistIndex].dur : UINT16_MAX;
     applyPresetFromPlaylist(playlistEntries[playlistIndex].preset);
     doAdvancePlaylist = false;
+  } else if (playlistIndex >= 0 && playlistEntryDur < UINT16_MAX) {
+    prefetchPreset(nextPlaylistPreset()); // read next preset from FS now so it can be applied right at the deadline
   }
 }
 
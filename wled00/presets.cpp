@@ -16,6 +16,15 @@ static char *quickLoad = nullptr;
 static char *saveName = nullptr;
 static bool includeBri = true, segBounds = true, selectedOnly = false, playlistSave = false;;
 
+// next playlist preset read ahead of time (see prefetchPreset()), nullptr if preset was not found or did not fit
+static char *prefetchBuffer = nullptr;
+static byte prefetchedPreset = 0;
+static volatile bool prefetchStale = false; // presets file was replaced outside of loop() (upload), drop prefetched preset
+// playlist step statistics: time from playlist requesting preset until it is applied (us)
+static unsigned long playlistStepStart = 0;
+static unsigned long playlistStepLatency = 0, playlistStepLatencyMax = 0;
+static uint16_t playlistPrefetchHits = 0, playlistPrefetchMisses = 0;
+
 static const char presets_json[] PROGMEM = "/presets.json";
 static const char tmp_json[] PROGMEM = "/tmp.json";
 const char *getPresetsFileName(bool persistent) {
@@ -26,8 +35,21 @@ bool presetNeedsSaving() {
   return presetToSave;
 }
 
+static void dropPrefetchedPreset() {
+  prefetchStale = false;
+  free(prefetchBuffer);
+  prefetchBuffer = nullptr;
+  prefetchedPreset = 0;
+}
+
+// called from async web server task, prefetched preset is dropped in loop() before it is used again
+void invalidatePrefetchedPreset() {
+  prefetchStale = true;
+}
+
 static void doSaveState() {
   bool persist = (presetToSave < 251);
+  if (persist) dropPrefetchedPreset(); // may be overwritten
 
   unsigned long start = millis();
   while (strip.isUpdating() && millis()-start < (2*FRAMETIME_FIXED)+1) yield(); // wait 2 frames
@@ -124,12 +146,51 @@ bool applyPresetFromPlaylist(byte index)
   DEBUG_PRINTF_P(PSTR("Request to apply preset: %d\n"), index);
   presetToApply = index;
   callModeToApply = CALL_MODE_DIRECT_CHANGE;
+  playlistStepStart = micros() | 1; // 0 means no playlist step pending
   return true;
 }
 
+// read preset into RAM while playlist entry is still running so that applying it at the
+// end of the entry does not need to access the filesystem (called from handlePlaylist() in spare loop time)
+void prefetchPreset(byte index)
+{
+  if (prefetchStale) dropPrefetchedPreset();
+  if (index == 0 || index > 250 || index == prefetchedPreset || presetToApply || presetToSave || jsonBufferLock) return;
+  if (strip.isUpdating()) return; // accessing FS during sendout causes glitches, try again on next loop
+  if (!requestJSONBufferLock(23)) return;
+
+  dropPrefetchedPreset();
+  prefetchedPreset = index; // also if it does not exist or does not fit, so it is not retried on every loop
+  if (readObjectFromFileUsingId(getPresetsFileName(), index, pDoc)) {
+    size_t len = measureJson(*pDoc) + 1;
+    #ifdef ARDUINO_ARCH_ESP32
+    if (psramSafe && psramFound())
+      prefetchBuffer = (char*) ps_malloc(len);
+    else
+    #else
+    if (ESP.getMaxFreeBlockSize() > len + MIN_HEAP_SIZE)
+    #endif
+      prefetchBuffer = (char*) malloc(len);
+    if (prefetchBuffer) serializeJson(*pDoc, prefetchBuffer, len);
+  }
+  DEBUG_PRINTF_P(PSTR("Prefetched preset %u (%s).\n"), (unsigned)index, prefetchBuffer ? "ok" : "failed");
+  releaseJSONBufferLock();
+}
+
+void serializePlaylistStepInfo(JsonObject root)
+{
+  JsonObject pl = root.createNestedObject(F("plstep")); // playlist step apply latency (us) and prefetch hits/misses
+  pl[F("lat")]  = playlistStepLatency;
+  pl[F("max")]  = playlistStepLatencyMax;
+  pl[F("hit")]  = playlistPrefetchHits;
+  pl[F("miss")] = playlistPrefetchMisses;
+}
+
 bool applyPreset(byte index, byte callMode)
 {
   unloadPlaylist(); // applying a preset unloads the playlist (#3827)
+  dropPrefetchedPreset();
+  playlistStepStart = 0;
   DEBUG_PRINTF_P(PSTR("Request to apply preset: %u\n"), index);
   presetToApply = index;
   callModeToApply = callMode;
@@ -168,9 +229,21 @@ void handlePresets()
 
   DEBUG_PRINTF_P(PSTR("Applying preset: %u\n"), (unsigned)tmpPreset);
 
+  char *prefetched = nullptr; // take ownership as deserializeState() may call applyPreset() which drops prefetched preset
+  if (prefetchStale) dropPrefetchedPreset();
+  if (tmpPreset == prefetchedPreset) {
+    prefetched = prefetchBuffer;
+    prefetchBuffer = nullptr;
+    prefetchedPreset = 0;
+  }
+  if (playlistStepStart) {
+    if (prefetched) playlistPrefetchHits++;
+    else            playlistPrefetchMisses++;
+  }
+
   #if defined(ARDUINO_ARCH_ESP32S3) || defined(ARDUINO_ARCH_ESP32S2) || defined(ARDUINO_ARCH_ESP32C3)
   unsigned long start = millis();
-  while (strip.isUpdating() && millis() - start < FRAMETIME_FIXED) yield(); // wait for strip to finish updating, accessing FS during sendout causes glitches
+  if (!prefetched) while (strip.isUpdating() && millis() - start < FRAMETIME_FIXED) yield(); // wait for strip to finish updating, accessing FS during sendout causes glitches
   #endif
 
   #ifdef ARDUINO_ARCH_ESP32
@@ -178,7 +251,9 @@ void handlePresets()
     deserializeJson(*pDoc,tmpRAMbuffer);
   } else
   #endif
-  {
+  if (prefetched) {
+    deserializeJson(*pDoc, prefetched); // zero-copy, buffer is released after state is applied
+  } else {
   presetErrFlag = readObjectFromFileUsingId(getPresetsFileName(tmpPreset < 255), tmpPreset, pDoc) ? ERR_NONE : ERR_FS_PLOAD;
   }
   fdo = pDoc->as<JsonObject>();
@@ -189,10 +264,7 @@ void handlePresets()
   //HTTP API commands
   const char* httpwin = fdo["win"];
   if (httpwin) {
-    String apireq = "win"; // reduce flash string usage
-    apireq += F("&IN&"); // internal call
-    apireq += httpwin;
-    handleSet(nullptr, apireq, false); // may call applyPreset() via PL=
+    handleHttpApi(httpwin, false); // may call applyPreset() via PL=
     setValuesFromFirstSelectedSeg(); // fills legacy values
     changePreset = true;
   } else {
@@ -210,10 +282,16 @@ void handlePresets()
     tmpRAMbuffer = nullptr;
   }
   #endif
+  free(prefetched);
 
   releaseJSONBufferLock();
   if (changePreset) notify(tmpMode); // force UDP notification
   stateUpdated(tmpMode);  // was colorUpdated() if anything breaks
+  if (playlistStepStart) {
+    playlistStepLatency = micros() - playlistStepStart;
+    if (playlistStepLatency > playlistStepLatencyMax) playlistStepLatencyMax = playlistStepLatency;
+    playlistStepStart = 0;
+  }
   updateInterfaces(tmpMode);
 }
 
@@ -281,6 +359,7 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
 }
 
 void deletePreset(byte index) {
+  if (index == prefetchedPreset) dropPrefetchedPreset();
   StaticJsonDocument<24> empty;
   writeObjectToFileUsingId(getPresetsFileName(), index, &empty);
   presetsModifiedTime = toki.second(); //unix time
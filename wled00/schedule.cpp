@@ -0,0 +1,72 @@
+#include "wled.h"
+#include "schedule.h"
+
+/*
+ * Cue schedule loaded from /schedule.json, a compact list of [time,preset,weekdays,ref] entries:
+ * time     ms after reference (local midnight, sunrise or sunset), negative allowed for sunrise/sunset
+ * preset   preset to apply (use presets with "seg" objects for per-segment cues)
+ * weekdays optional, bit 0: enabled, bits 1-7: Monday-Sunday (default 255: every day)
+ * ref      optional, 0: midnight (default), 1: sunrise, 2: sunset
+ * i.e. [[25200000,1],[-1800000,2,255,2]] applies preset 1 at 7:00:00.000 and preset 2 half an hour before sunset
+ */
+
+static const char schedule_json[] PROGMEM = "/schedule.json";
+
+static CueSchedule cueSchedule;
+static bool    scheduleNeedsLoad = true;
+static int32_t localOffsetSecs = 0; // local time - UTC, updated every second
+static bool    localOffsetValid = false;
+
+// reload schedule file on next loop (i.e. after upload)
+void reloadSchedule() {
+  scheduleNeedsLoad = true;
+}
+
+static void loadSchedule() {
+  scheduleNeedsLoad = false;
+  cueSchedule.clear();
+  char fileName[16]; strncpy_P(fileName, schedule_json, 15); fileName[15] = 0; //use PROGMEM safe copy as FS.open() does not
+  File file = WLED_FS.open(fileName, "r");
+  if (!file) return;
+  char buf[64];
+  cueSchedule.beginParse();
+  while (file.available()) {
+    size_t len = file.read((uint8_t*)buf, sizeof(buf));
+    for (size_t i = 0; i < len; i++) cueSchedule.parse(buf[i]);
+  }
+  file.close();
+  cueSchedule.rebuild(0); // next fire times are recalculated on first handleSchedule() (clock "jumps" from 0)
+  DEBUG_PRINTF_P(PSTR("Schedule: %u cues loaded.\n"), cueSchedule.size());
+}
+
+static inline int32_t sunTimeMs(time_t t) {
+  return t ? (t % 86400) * 1000 : -1;
+}
+
+// called on every loop, firing a cue is a single comparison with the earliest cue in the heap
+void handleSchedule() {
+  if (scheduleNeedsLoad) loadSchedule();
+  if (!cueSchedule.size() || !tz) return;
+
+  Toki::Time t = toki.getTime();
+  if (toki.isTick() || !localOffsetValid) {
+    localOffsetSecs  = (int32_t)(tz->toLocal(t.sec + utcOffsetSecs) - t.sec);
+    localOffsetValid = true;
+  }
+  uint64_t now = (uint64_t)(t.sec + localOffsetSecs) * 1000 + t.ms;
+
+  cueSchedule.setSunTimes(sunTimeMs(sunrise), sunTimeMs(sunset), now); // only reschedules if sunrise/sunset changed
+  int cue = cueSchedule.pop(now); // only one cue per loop as presets are applied asynchronously
+  if (cue < 0) return;
+  DEBUG_PRINTF_P(PSTR("Schedule: cue %d, preset %u.\n"), cue, (unsigned)cueSchedule.get(cue).preset);
+  applyPreset(cueSchedule.get(cue).preset);
+}
+
+// ms until next cue is due (UINT32_MAX if none)
+uint32_t getTimeToNextCue() {
+  if (!cueSchedule.size()) return UINT32_MAX;
+  Toki::Time t = toki.getTime();
+  uint64_t now = (uint64_t)(t.sec + localOffsetSecs) * 1000 + t.ms;
+  uint64_t due = cueSchedule.nextDue();
+  return due <= now ? 0 : (due - now > UINT32_MAX ? UINT32_MAX : due - now);
+}
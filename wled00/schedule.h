@@ -0,0 +1,157 @@
+#pragma once
+#ifndef WLED_SCHEDULE_H
+#define WLED_SCHEDULE_H
+/*
+ * Cue schedule: timed preset activations with millisecond resolution
+ *
+ * Cues are kept in a min-heap ordered by their next fire time so checking the schedule is a single
+ * comparison and only fired cues are rescheduled (no periodic scan of all entries).
+ * All times are local time in ms since epoch, the schedule itself does not depend on the clock source.
+ */
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+#ifndef WLED_MAX_CUES
+  #ifdef ESP8266
+    #define WLED_MAX_CUES 64
+  #else
+    #define WLED_MAX_CUES 512
+  #endif
+#endif
+
+#define CUE_REF_MIDNIGHT 0
+#define CUE_REF_SUNRISE  1
+#define CUE_REF_SUNSET   2
+
+#define CUE_DAY_MS  86400000LL
+#define CUE_MAX_LATE 60000      // cues overdue by more than this (i.e. after time was set) are skipped
+#define CUE_NONE    UINT64_MAX
+
+typedef struct {
+  int32_t time;     // ms after reference (may be negative for sunrise/sunset)
+  uint8_t preset;   // preset to apply
+  uint8_t weekdays; // bit 0: enabled, bits 1-7: Monday-Sunday (same as timerWeekday)
+  uint8_t ref;      // CUE_REF_MIDNIGHT, CUE_REF_SUNRISE or CUE_REF_SUNSET
+} ScheduleCue;
+
+class CueSchedule {
+  public:
+    inline size_t   size() const                  { return _cues.size(); }
+    inline uint64_t nextDue() const               { return _heap.empty() ? CUE_NONE : _heap.front().due; }
+    inline const ScheduleCue& get(size_t n) const { return _cues[n]; }
+
+    void clear() {
+      _cues.clear(); _cues.shrink_to_fit();
+      _heap.clear(); _heap.shrink_to_fit();
+    }
+
+    bool add(const ScheduleCue &c) {
+      if (_cues.size() >= WLED_MAX_CUES || c.preset == 0 || c.ref > CUE_REF_SUNSET) return false;
+      if (c.time <= -CUE_DAY_MS || c.time >= CUE_DAY_MS) return false;
+      _cues.push_back(c);
+      return true;
+    }
+
+    // today's sunrise and sunset in ms after local midnight (-1 if there is none), also used for following days
+    void setSunTimes(int32_t sunrise, int32_t sunset, uint64_t now) {
+      if (sunrise == _sunrise && sunset == _sunset) return;
+      _sunrise = sunrise;
+      _sunset  = sunset;
+      rebuild(now);
+    }
+
+    // (re)calculate next fire time of all cues, needed after cues are added or clock was set
+    void rebuild(uint64_t now) {
+      _heap.clear();
+      _heap.reserve(_cues.size());
+      for (size_t i = 0; i < _cues.size(); i++) {
+        uint64_t due = nextFire(_cues[i], now);
+        if (due != CUE_NONE) _heap.push_back({due, (uint16_t)i});
+      }
+      std::make_heap(_heap.begin(), _heap.end(), later);
+      _lastNow = now;
+    }
+
+    // returns index of a cue due at now (and reschedules it) or -1 if none is due
+    int pop(uint64_t now) {
+      if (now + 1000 < _lastNow || now > _lastNow + CUE_MAX_LATE) rebuild(now); // clock was set
+      _lastNow = now;
+      while (!_heap.empty() && _heap.front().due <= now) {
+        HeapEntry e = _heap.front();
+        std::pop_heap(_heap.begin(), _heap.end(), later);
+        uint64_t due = nextFire(_cues[e.cue], now);
+        if (due != CUE_NONE) {
+          _heap.back() = {due, e.cue};
+          std::push_heap(_heap.begin(), _heap.end(), later);
+        } else _heap.pop_back();
+        if (now - e.due <= CUE_MAX_LATE) return e.cue;
+      }
+      return -1;
+    }
+
+    // incremental parser for compact schedule file: [[time,preset],[time,preset,weekdays,ref],...]
+    void beginParse() {
+      clear();
+      _depth = _field = 0;
+      _hasNum = false;
+    }
+    void parse(char c) {
+      if ((c >= '0' && c <= '9') || c == '-') {
+        if (c == '-') { _neg = true; _num = 0; }
+        else { if (!_hasNum && !_neg) _num = 0; _num = _num * 10 + (c - '0'); }
+        _hasNum = true;
+        return;
+      }
+      if (c == '[') {
+        if (++_depth == 2) { _vals[2] = 255; _vals[3] = CUE_REF_MIDNIGHT; _field = 0; }
+      } else if (c == ',' || c == ']') {
+        if (_depth == 2 && _hasNum && _field < 4) _vals[_field] = _neg ? -_num : _num;
+        if (_depth == 2) _field++;
+        if (c == ']' && _depth-- == 2 && _field >= 2) {
+          add({(int32_t)_vals[0], (uint8_t)_vals[1], (uint8_t)_vals[2], (uint8_t)_vals[3]});
+        }
+      } else return; // whitespace
+      _hasNum = _neg = false;
+    }
+
+  private:
+    typedef struct {
+      uint64_t due;
+      uint16_t cue;
+    } HeapEntry;
+
+    std::vector<ScheduleCue> _cues;
+    std::vector<HeapEntry>   _heap;
+    int32_t  _sunrise = -1, _sunset = -1;
+    uint64_t _lastNow = 0;
+    // parser state
+    int64_t  _num = 0, _vals[4];
+    uint8_t  _depth = 0, _field = 0;
+    bool     _hasNum = false, _neg = false;
+
+    static bool later(const HeapEntry &a, const HeapEntry &b) { return a.due > b.due; } // min-heap
+
+    // first fire time after now (CUE_NONE if cue is disabled or there is no sunrise/sunset)
+    uint64_t nextFire(const ScheduleCue &c, uint64_t now) const {
+      if (!(c.weekdays & 0x01)) return CUE_NONE;
+      int64_t base = 0;
+      if (c.ref != CUE_REF_MIDNIGHT) {
+        base = (c.ref == CUE_REF_SUNRISE) ? _sunrise : _sunset;
+        if (base < 0) return CUE_NONE;
+      }
+      int64_t today = now - now % CUE_DAY_MS;
+      for (int d = -1; d <= 7; d++) { // cue time may be before midnight of its day
+        int64_t day = today + d * CUE_DAY_MS;
+        if (day < 0) continue;
+        unsigned wd = ((day / CUE_DAY_MS) + 3) % 7 + 1; // 1970-01-01 was a Thursday, 1 = Monday
+        if (!((c.weekdays >> wd) & 0x01)) continue;
+        int64_t due = day + base + c.time;
+        if (due > (int64_t)now) return due;
+      }
+      return CUE_NONE;
+    }
+};
+
+#endif
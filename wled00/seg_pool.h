@@ -0,0 +1,120 @@
+#pragma once
+#ifndef WLED_SEG_POOL_H
+#define WLED_SEG_POOL_H
+/*
+ * Size-class (slab) pool for small segment allocations: effect data, names and transition structures/snapshots
+ *
+ * The pool is a single block preallocated at boot (if SEGMENT_POOL_SIZE is defined, see FX.h), divided into pages of
+ * SLAB_PAGE_SIZE bytes. A page is assigned to one size class (16..512 bytes) when it is first needed and split into
+ * equal blocks, it is given back when its last block is freed. Blocks of one size always come from the same pages, so playlists cycling effects with
+ * differently sized data do not leave holes in the heap that only the next smaller allocation fits into.
+ * Allocations larger than a page or not fitting into the pool return nullptr, the caller falls back to heap.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SLAB_PAGE_SIZE  512
+#define SLAB_MIN_BLOCK  16
+#define SLAB_CLASSES    6     // 16, 32, 64, 128, 256, 512 byte blocks (a 16 byte class page has 32 blocks)
+#define SLAB_MAX_PAGES  64
+#define SLAB_FREE_PAGE  0xFF
+#define SLAB_BORROW_UP  2     // a block of up to 2 classes larger is used if a page of that class has room
+
+typedef struct {
+  uint32_t allocs;    // allocations served from pool
+  uint32_t fallbacks; // allocations that did not fit (larger than a page or pool full)
+  uint32_t used;      // bytes in use (block sizes)
+  uint16_t pages;     // pages assigned to a size class
+  uint16_t peakPages;
+} slab_stats_t;
+
+class SlabPool {
+  public:
+    // mem is divided into pages (remainder unused), returns number of pages
+    size_t begin(void *mem, size_t size) {
+      _mem = static_cast<uint8_t*>(mem);
+      _pages = mem ? size / SLAB_PAGE_SIZE : 0;
+      if (_pages > SLAB_MAX_PAGES) _pages = SLAB_MAX_PAGES;
+      for (size_t i = 0; i < SLAB_MAX_PAGES; i++) { _cls[i] = SLAB_FREE_PAGE; _used[i] = 0; }
+      _stats = {};
+      return _pages;
+    }
+
+    inline size_t capacity() const { return _pages * SLAB_PAGE_SIZE; }
+    inline const slab_stats_t& stats() const { return _stats; }
+    inline void fallback() { _stats.fallbacks++; }
+
+    static uint8_t sizeClass(size_t len) {
+      uint8_t c = 0;
+      while (c < SLAB_CLASSES && (size_t(SLAB_MIN_BLOCK) << c) < len) c++;
+      return c; // SLAB_CLASSES if too large
+    }
+
+    // uninitialised block of at least len bytes (8 byte aligned if mem is), nullptr if it does not fit
+    void *alloc(size_t len) {
+      const uint8_t c = sizeClass(len);
+      if (len == 0 || c >= SLAB_CLASSES || !_pages) return nullptr;
+      int page = findPage(c);
+      for (uint8_t b = c + 1; page < 0 && b < SLAB_CLASSES && b <= c + SLAB_BORROW_UP; b++) {
+        page = findPage(b); // rather waste part of a larger block than take a new page
+      }
+      if (page < 0) {
+        for (size_t i = 0; i < _pages; i++) if (_cls[i] == SLAB_FREE_PAGE) { page = i; break; }
+        if (page < 0) return nullptr;
+        _cls[page] = c;
+        if (++_stats.pages > _stats.peakPages) _stats.peakPages = _stats.pages;
+      }
+      const uint8_t  bit  = __builtin_ctz(~_used[page]);
+      const uint32_t size = SLAB_MIN_BLOCK << _cls[page];
+      _used[page] |= 1UL << bit;
+      _stats.allocs++;
+      _stats.used += size;
+      return _mem + page * SLAB_PAGE_SIZE + bit * size;
+    }
+
+    // returns false if ptr is not from pool
+    bool free(void *ptr) {
+      if (!owns(ptr)) return false;
+      const size_t   offset = static_cast<uint8_t*>(ptr) - _mem;
+      const size_t   page   = offset / SLAB_PAGE_SIZE;
+      const uint32_t size   = SLAB_MIN_BLOCK << _cls[page];
+      const uint32_t mask   = 1UL << ((offset % SLAB_PAGE_SIZE) / size);
+      if (!(_used[page] & mask)) return true; // double free, ignore
+      _used[page] &= ~mask;
+      _stats.used -= size;
+      if (!_used[page]) {
+        _cls[page] = SLAB_FREE_PAGE;
+        _stats.pages--;
+      }
+      return true;
+    }
+
+    inline bool owns(const void *ptr) const {
+      const uint8_t *p = static_cast<const uint8_t*>(ptr);
+      return _pages && p >= _mem && p < _mem + capacity();
+    }
+
+    // usable size of a pool block (0 if not from pool)
+    size_t blockSize(const void *ptr) const {
+      if (!owns(ptr)) return 0;
+      const uint8_t c = _cls[(static_cast<const uint8_t*>(ptr) - _mem) / SLAB_PAGE_SIZE];
+      return c < SLAB_CLASSES ? SLAB_MIN_BLOCK << c : 0;
+    }
+
+  private:
+    uint8_t     *_mem = nullptr;
+    size_t       _pages = 0;
+    uint8_t      _cls[SLAB_MAX_PAGES];  // size class of page (SLAB_FREE_PAGE if unassigned)
+    uint32_t     _used[SLAB_MAX_PAGES]; // one bit per block
+    slab_stats_t _stats = {};
+
+    int findPage(uint8_t c) const {
+      const unsigned blocks = SLAB_PAGE_SIZE / (SLAB_MIN_BLOCK << c);
+      const uint32_t full   = blocks >= 32 ? UINT32_MAX : (1UL << blocks) - 1;
+      for (size_t i = 0; i < _pages; i++) if (_cls[i] == c && _used[i] != full) return i;
+      return -1;
+    }
+};
+
+#endif
@@ -160,6 +160,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       char sp[4] = "SP"; sp[2] = offset+s; sp[3] = 0; //bus clock speed (DotStar & PWM)
       char la[4] = "LA"; la[2] = offset+s; la[3] = 0; //LED mA
       char ma[4] = "MA"; ma[2] = offset+s; ma[3] = 0; //max mA
+      char dt[4] = "DT"; dt[2] = offset+s; dt[3] = 0; //temporal dithering
       if (!request->hasArg(lp)) {
         DEBUG_PRINTF_P(PSTR("# of buses: %d\n"), s+1);
         break;
@@ -212,7 +213,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       type |= request->hasArg(rf) << 7; // off refresh override
       // actual finalization is done in WLED::loop() (removing old busses and adding new)
       // this may happen even before this loop is finished so we do "doInitBusses" after the loop
-      busConfigs.emplace_back(type, pins, start, length, colorOrder | (channelSwap<<4), request->hasArg(cv), skip, awmode, freq, useGlobalLedBuffer, maPerLed, maMax);
+      busConfigs.emplace_back(type, pins, start, length, colorOrder | (channelSwap<<4), request->hasArg(cv), skip, awmode, freq, useGlobalLedBuffer, maPerLed, maMax, request->hasArg(dt));
       busesChanged = true;
     }
     //doInitBusses = busesChanged; // we will do that below to ensure all input data is processed
@@ -334,6 +335,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     t = request->arg(F("TP")).toInt();
     randomPaletteChangeTime = MIN(255,MAX(1,t));
     useHarmonicRandomPalette = request->hasArg(F("TH"));
+    useTransitionBuffers = request->hasArg(F("TC"));
 
     nightlightTargetBri = request->arg(F("TB")).toInt();
     t = request->arg(F("TL")).toInt();
@@ -390,6 +392,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     t = request->arg(F("UR")).toInt();
     if ((t>=0) && (t<30)) udpNumRetries = t;
+    clusterClockEnabled = request->hasArg(F("CK"));
 
 
     nodeListEnabled = request->hasArg(F("NL"));
@@ -811,401 +814,3 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
   if (subPage == SUBPAGE_SYNC) alexaInit();
   #endif
 }
-
-
-//HTTP API request parser
-bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
-{
-  if (!(req.indexOf("win") >= 0)) return false;
-
-  int pos = 0;
-  DEBUG_PRINTF_P(PSTR("API req: %s\n"), req.c_str());
-
-  //segment select (sets main segment)
-  pos = req.indexOf(F("SM="));
-  if (pos > 0 && !realtimeMode) {
-    strip.setMainSegmentId(getNumVal(&req, pos));
-  }
-
-  byte selectedSeg = strip.getFirstSelectedSegId();
-
-  bool singleSegment = false;
-
-  pos = req.indexOf(F("SS="));
-  if (pos > 0) {
-    unsigned t = getNumVal(&req, pos);
-    if (t < strip.getSegmentsNum()) {
-      selectedSeg = t;
-      singleSegment = true;
-    }
-  }
-
-  Segment& selseg = strip.getSegment(selectedSeg);
-  pos = req.indexOf(F("SV=")); //segment selected
-  if (pos > 0) {
-    unsigned t = getNumVal(&req, pos);
-    if (t == 2) for (unsigned i = 0; i < strip.getSegmentsNum(); i++) strip.getSegment(i).selected = false; // unselect other segments
-    selseg.selected = t;
-  }
-
-  // temporary values, write directly to segments, globals are updated by setValuesFromFirstSelectedSeg()
-  uint32_t col0    = selseg.colors[0];
-  uint32_t col1    = selseg.colors[1];
-  uint32_t col2    = selseg.colors[2];
-  byte colIn[4]    = {R(col0), G(col0), B(col0), W(col0)};
-  byte colInSec[4] = {R(col1), G(col1), B(col1), W(col1)};
-  byte effectIn    = selseg.mode;
-  byte speedIn     = selseg.speed;
-  byte intensityIn = selseg.intensity;
-  byte paletteIn   = selseg.palette;
-  byte custom1In   = selseg.custom1;
-  byte custom2In   = selseg.custom2;
-  byte custom3In   = selseg.custom3;
-  byte check1In    = selseg.check1;
-  byte check2In    = selseg.check2;
-  byte check3In    = selseg.check3;
-  uint16_t startI  = selseg.start;
-  uint16_t stopI   = selseg.stop;
-  uint16_t startY  = selseg.startY;
-  uint16_t stopY   = selseg.stopY;
-  uint8_t  grpI    = selseg.grouping;
-  uint16_t spcI    = selseg.spacing;
-  pos = req.indexOf(F("&S=")); //segment start
-  if (pos > 0) {
-    startI = std::abs(getNumVal(&req, pos));
-  }
-  pos = req.indexOf(F("S2=")); //segment stop
-  if (pos > 0) {
-    stopI = std::abs(getNumVal(&req, pos));
-  }
-  pos = req.indexOf(F("GP=")); //segment grouping
-  if (pos > 0) {
-    grpI = std::max(1,getNumVal(&req, pos));
-  }
-  pos = req.indexOf(F("SP=")); //segment spacing
-  if (pos > 0) {
-    spcI = std::max(0,getNumVal(&req, pos));
-  }
-  strip.suspend(); // must suspend strip operations before changing geometry
-  selseg.setGeometry(startI, stopI, grpI, spcI, UINT16_MAX, startY, stopY, selseg.map1D2D);
-  strip.resume();
-
-  pos = req.indexOf(F("RV=")); //Segment reverse
-  if (pos > 0) selseg.reverse = req.charAt(pos+3) != '0';
-
-  pos = req.indexOf(F("MI=")); //Segment mirror
-  if (pos > 0) selseg.mirror = req.charAt(pos+3) != '0';
-
-  pos = req.indexOf(F("SB=")); //Segment brightness/opacity
-  if (pos > 0) {
-    byte segbri = getNumVal(&req, pos);
-    selseg.setOption(SEG_OPTION_ON, segbri); // use transition
-    if (segbri) {
-      selseg.setOpacity(segbri);
-    }
-  }
-
-  pos = req.indexOf(F("SW=")); //segment power
-  if (pos > 0) {
-    switch (getNumVal(&req, pos)) {
-      case 0:  selseg.setOption(SEG_OPTION_ON, false);      break; // use transition
-      case 1:  selseg.setOption(SEG_OPTION_ON, true);       break; // use transition
-      default: selseg.setOption(SEG_OPTION_ON, !selseg.on); break; // use transition
-    }
-  }
-
-  pos = req.indexOf(F("PS=")); //saves current in preset
-  if (pos > 0) savePreset(getNumVal(&req, pos));
-
-  pos = req.indexOf(F("P1=")); //sets first preset for cycle
-  if (pos > 0) presetCycMin = getNumVal(&req, pos);
-
-  pos = req.indexOf(F("P2=")); //sets last preset for cycle
-  if (pos > 0) presetCycMax = getNumVal(&req, pos);
-
-  //apply preset
-  if (updateVal(req.c_str(), "PL=", &presetCycCurr, presetCycMin, presetCycMax)) {
-    applyPreset(presetCycCurr);
-  }
-
-  pos = req.indexOf(F("NP")); //advances to next preset in a playlist
-  if (pos > 0) doAdvancePlaylist = true;
-  
-  //set brightness
-  updateVal(req.c_str(), "&A=", &bri);
-
-  bool col0Changed = false, col1Changed = false, col2Changed = false;
-  //set colors
-  col0Changed |= updateVal(req.c_str(), "&R=", &colIn[0]);
-  col0Changed |= updateVal(req.c_str(), "&G=", &colIn[1]);
-  col0Changed |= updateVal(req.c_str(), "&B=", &colIn[2]);
-  col0Changed |= updateVal(req.c_str(), "&W=", &colIn[3]);
-
-  col1Changed |= updateVal(req.c_str(), "R2=", &colInSec[0]);
-  col1Changed |= updateVal(req.c_str(), "G2=", &colInSec[1]);
-  col1Changed |= updateVal(req.c_str(), "B2=", &colInSec[2]);
-  col1Changed |= updateVal(req.c_str(), "W2=", &colInSec[3]);
-
-  #ifdef WLED_ENABLE_LOXONE
-  //lox parser
-  pos = req.indexOf(F("LX=")); // Lox primary color
-  if (pos > 0) {
-    int lxValue = getNumVal(&req, pos);
-    if (parseLx(lxValue, colIn)) {
-      bri = 255;
-      nightlightActive = false; //always disable nightlight when toggling
-      col0Changed = true;
-    }
-  }
-  pos = req.indexOf(F("LY=")); // Lox secondary color
-  if (pos > 0) {
-    int lxValue = getNumVal(&req, pos);
-    if(parseLx(lxValue, colInSec)) {
-      bri = 255;
-      nightlightActive = false; //always disable nightlight when toggling
-      col1Changed = true;
-    }
-  }
-  #endif
-
-  //set hue
-  pos = req.indexOf(F("HU="));
-  if (pos > 0) {
-    uint16_t temphue = getNumVal(&req, pos);
-    byte tempsat = 255;
-    pos = req.indexOf(F("SA="));
-    if (pos > 0) {
-      tempsat = getNumVal(&req, pos);
-    }
-    byte sec = req.indexOf(F("H2"));
-    colorHStoRGB(temphue, tempsat, (sec>0) ? colInSec : colIn);
-    col0Changed |= (!sec); col1Changed |= sec;
-  }
-
-  //set white spectrum (kelvin)
-  pos = req.indexOf(F("&K="));
-  if (pos > 0) {
-    byte sec = req.indexOf(F("K2"));
-    colorKtoRGB(getNumVal(&req, pos), (sec>0) ? colInSec : colIn);
-    col0Changed |= (!sec); col1Changed |= sec;
-  }
-
-  //set color from HEX or 32bit DEC
-  pos = req.indexOf(F("CL="));
-  if (pos > 0) {
-    colorFromDecOrHexString(colIn, req.substring(pos + 3).c_str());
-    col0Changed = true;
-  }
-  pos = req.indexOf(F("C2="));
-  if (pos > 0) {
-    colorFromDecOrHexString(colInSec, req.substring(pos + 3).c_str());
-    col1Changed = true;
-  }
-  pos = req.indexOf(F("C3="));
-  if (pos > 0) {
-    byte tmpCol[4];
-    colorFromDecOrHexString(tmpCol, req.substring(pos + 3).c_str());
-    col2 = RGBW32(tmpCol[0], tmpCol[1], tmpCol[2], tmpCol[3]);
-    selseg.setColor(2, col2); // defined above (SS= or main)
-    col2Changed = true;
-  }
-
-  //set to random hue SR=0->1st SR=1->2nd
-  pos = req.indexOf(F("SR"));
-  if (pos > 0) {
-    byte sec = getNumVal(&req, pos);
-    setRandomColor(sec? colInSec : colIn);
-    col0Changed |= (!sec); col1Changed |= sec;
-  }
-
-  // apply colors to selected segment, and all selected segments if applicable
-  if (col0Changed) {
-    col0 = RGBW32(colIn[0], colIn[1], colIn[2], colIn[3]);
-    selseg.setColor(0, col0);
-  }
-
-  if (col1Changed) {
-    col1 = RGBW32(colInSec[0], colInSec[1], colInSec[2], colInSec[3]);
-    selseg.setColor(1, col1);
-  }
-
-  //swap 2nd & 1st
-  pos = req.indexOf(F("SC"));
-  if (pos > 0) {
-    std::swap(col0,col1);
-    col0Changed = col1Changed = true;
-  }
-
-  bool fxModeChanged = false, speedChanged = false, intensityChanged = false, paletteChanged = false;
-  bool custom1Changed = false, custom2Changed = false, custom3Changed = false, check1Changed = false, check2Changed = false, check3Changed = false;
-  // set effect parameters
-  if (updateVal(req.c_str(), "FX=", &effectIn, 0, strip.getModeCount()-1)) {
-    if (request != nullptr) unloadPlaylist(); // unload playlist if changing FX using web request
-    fxModeChanged = true;
-  }
-  speedChanged     = updateVal(req.c_str(), "SX=", &speedIn);
-  intensityChanged = updateVal(req.c_str(), "IX=", &intensityIn);
-  paletteChanged   = updateVal(req.c_str(), "FP=", &paletteIn, 0, strip.getPaletteCount()-1);
-  custom1Changed   = updateVal(req.c_str(), "X1=", &custom1In);
-  custom2Changed   = updateVal(req.c_str(), "X2=", &custom2In);
-  custom3Changed   = updateVal(req.c_str(), "X3=", &custom3In);
-  check1Changed    = updateVal(req.c_str(), "M1=", &check1In);
-  check2Changed    = updateVal(req.c_str(), "M2=", &check2In);
-  check3Changed    = updateVal(req.c_str(), "M3=", &check3In);
-
-  stateChanged |= (fxModeChanged || speedChanged || intensityChanged || paletteChanged || custom1Changed || custom2Changed || custom3Changed || check1Changed || check2Changed || check3Changed);
-
-  // apply to main and all selected segments to prevent #1618.
-  for (unsigned i = 0; i < strip.getSegmentsNum(); i++) {
-    Segment& seg = strip.getSegment(i);
-    if (i != selectedSeg && (singleSegment || !seg.isActive() || !seg.isSelected())) continue; // skip non main segments if not applying to all
-    if (fxModeChanged)    seg.setMode(effectIn, req.indexOf(F("FXD="))>0);  // apply defaults if FXD= is specified
-    if (speedChanged)     seg.speed     = speedIn;
-    if (intensityChanged) seg.intensity = intensityIn;
-    if (paletteChanged)   seg.setPalette(paletteIn);
-    if (col0Changed)      seg.setColor(0, col0);
-    if (col1Changed)      seg.setColor(1, col1);
-    if (col2Changed)      seg.setColor(2, col2);
-    if (custom1Changed)   seg.custom1   = custom1In;
-    if (custom2Changed)   seg.custom2   = custom2In;
-    if (custom3Changed)   seg.custom3   = custom3In;
-    if (check1Changed)    seg.check1    = (bool)check1In;
-    if (check2Changed)    seg.check2    = (bool)check2In;
-    if (check3Changed)    seg.check3    = (bool)check3In;
-  }
-
-  //set advanced overlay
-  pos = req.indexOf(F("OL="));
-  if (pos > 0) {
-    overlayCurrent = getNumVal(&req, pos);
-  }
-
-  //apply macro (deprecated, added for compatibility with pre-0.11 automations)
-  pos = req.indexOf(F("&M="));
-  if (pos > 0) {
-    applyPreset(getNumVal(&req, pos) + 16);
-  }
-
-  //toggle send UDP direct notifications
-  pos = req.indexOf(F("SN="));
-  if (pos > 0) notifyDirect = (req.charAt(pos+3) != '0');
-
-  //toggle receive UDP direct notifications
-  pos = req.indexOf(F("RN="));
-  if (pos > 0) receiveGroups = (req.charAt(pos+3) != '0') ? receiveGroups | 1 : receiveGroups & 0xFE;
-
-  //receive live data via UDP/Hyperion
-  pos = req.indexOf(F("RD="));
-  if (pos > 0) receiveDirect = (req.charAt(pos+3) != '0');
-
-  //main toggle on/off (parse before nightlight, #1214)
-  pos = req.indexOf(F("&T="));
-  if (pos > 0) {
-    nightlightActive = false; //always disable nightlight when toggling
-    switch (getNumVal(&req, pos))
-    {
-      case 0: if (bri != 0){briLast = bri; bri = 0;} break; //off, only if it was previously on
-      case 1: if (bri == 0) bri = briLast; break; //on, only if it was previously off
-      default: toggleOnOff(); //toggle
-    }
-  }
-
-  //toggle nightlight mode
-  bool aNlDef = false;
-  if (req.indexOf(F("&ND")) > 0) aNlDef = true;
-  pos = req.indexOf(F("NL="));
-  if (pos > 0)
-  {
-    if (req.charAt(pos+3) == '0')
-    {
-      nightlightActive = false;
-    } else {
-      nightlightActive = true;
-      if (!aNlDef) nightlightDelayMins = getNumVal(&req, pos);
-      else         nightlightDelayMins = nightlightDelayMinsDefault;
-      nightlightStartTime = millis();
-    }
-  } else if (aNlDef)
-  {
-    nightlightActive = true;
-    nightlightDelayMins = nightlightDelayMinsDefault;
-    nightlightStartTime = millis();
-  }
-
-  //set nightlight target brightness
-  pos = req.indexOf(F("NT="));
-  if (pos > 0) {
-    nightlightTargetBri = getNumVal(&req, pos);
-    nightlightActiveOld = false; //re-init
-  }
-
-  //toggle nightlight fade
-  pos = req.indexOf(F("NF="));
-  if (pos > 0)
-  {
-    nightlightMode = getNumVal(&req, pos);
-
-    nightlightActiveOld = false; //re-init
-  }
-  if (nightlightMode > NL_MODE_SUN) nightlightMode = NL_MODE_SUN;
-
-  pos = req.indexOf(F("TT="));
-  if (pos > 0) transitionDelay = getNumVal(&req, pos);
-  strip.setTransition(transitionDelay);
-
-  //set time (unix timestamp)
-  pos = req.indexOf(F("ST="));
-  if (pos > 0) {
-    setTimeFromAPI(getNumVal(&req, pos));
-  }
-
-  //set countdown goal (unix timestamp)
-  pos = req.indexOf(F("CT="));
-  if (pos > 0) {
-    countdownTime = getNumVal(&req, pos);
-    if (countdownTime - toki.second() > 0) countdownOverTriggered = false;
-  }
-
-  pos = req.indexOf(F("LO="));
-  if (pos > 0) {
-    realtimeOverride = getNumVal(&req, pos);
-    if (realtimeOverride > 2) realtimeOverride = REALTIME_OVERRIDE_ALWAYS;
-    if (realtimeMode && useMainSegmentOnly) {
-      strip.getMainSegment().freeze = !realtimeOverride;
-    }
-  }
-
-  pos = req.indexOf(F("RB"));
-  if (pos > 0) doReboot = true;
-
-  // clock mode, 0: normal, 1: countdown
-  pos = req.indexOf(F("NM="));
-  if (pos > 0) countdownMode = (req.charAt(pos+3) != '0');
-
-  pos = req.indexOf(F("U0=")); //user var 0
-  if (pos > 0) {
-    userVar0 = getNumVal(&req, pos);
-  }
-
-  pos = req.indexOf(F("U1=")); //user var 1
-  if (pos > 0) {
-    userVar1 = getNumVal(&req, pos);
-  }
-  // you can add more if you need
-
-  // global colPri[], effectCurrent, ... are updated in stateChanged()
-  if (!apply) return true; // when called by JSON API, do not call colorUpdated() here
-
-  pos = req.indexOf(F("&NN")); //do not send UDP notifications this time
-  stateUpdated((pos > 0) ? CALL_MODE_NO_NOTIFY : CALL_MODE_DIRECT_CHANGE);
-
-  // internal call, does not send XML response
-  pos = req.indexOf(F("IN"));
-  if ((request != nullptr) && (pos < 1)) {
-    auto response = request->beginResponseStream("text/xml");
-    XML_response(*response);
-    request->send(response);
-  }
-
-  return true;
-}
@@ -368,7 +368,7 @@ static void parseNotifyPacket(const uint8_t *udpIn) {
     stateChanged = true;
   }
 
-  if (applyEffects && version > 5) {
+  if (applyEffects && version > 5 && !clusterClockLocked()) { // cluster clock keeps a more accurate timebase
     uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
     t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
     t -= millis();
@@ -560,6 +560,9 @@ void handleNotifications()
     return;
   }
 
+  // cluster clock sync
+  if (!isSupp && handleClusterPacket(udpIn, len, notifierUdp.remoteIP())) return;
+
   //wled notifier, ignore if realtime packets active
   if (udpIn[0] == 0 && !realtimeMode && receiveGroups)
   {
@@ -663,13 +666,15 @@ void handleNotifications()
 
   if (requestJSONBufferLock(18)) {
     if (udpIn[0] >= 'A' && udpIn[0] <= 'Z') { //HTTP API
-      String apireq = "win"; apireq += '&'; // reduce flash string usage
-      apireq += (char*)udpIn;
-      handleSet(nullptr, apireq);
+      handleHttpApi((const char*)udpIn);
     } else if (udpIn[0] == '{') { //JSON API
       DeserializationError error = deserializeJson(*pDoc, udpIn);
       JsonObject root = pDoc->as<JsonObject>();
       if (!error && !root.isNull()) deserializeState(root);
+    } else if (udpIn[0] == '[') { //JSON API, batch of state patches
+      DeserializationError error = deserializeJson(*pDoc, udpIn);
+      JsonArray patches = pDoc->as<JsonArray>();
+      if (!error && !patches.isNull()) deserializeStateBatch(patches);
     }
     releaseJSONBufferLock();
   }
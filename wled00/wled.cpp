@@ -63,7 +63,11 @@ void WLED::loop()
   #endif
   handleImprovWifiScan();
   handleNotifications();
+  handleClusterClock();
   handleTransitions();
+  #ifndef WLED_DISABLE_MQTT
+  handleMqtt();
+  #endif
   #ifdef WLED_ENABLE_DMX
   handleDMXOutput();
   #endif
@@ -129,6 +133,7 @@ void WLED::loop()
     else if (!noWifiSleep)
       delay(1); //required to make sure ESP enters modem sleep (see #1184)
     #endif
+    if (!bootTimes.light && strip.getLastShow()) bootTimes.light = strip.getLastShow(); // time to first light
   }
   #ifdef WLED_DEBUG
   stripMillis = millis() - stripMillis;
@@ -168,14 +173,15 @@ void WLED::loop()
 
   // reconnect WiFi to clear stale allocations if heap gets too low
   if (millis() - heapTime > 15000) {
+    sampleHeap(); // fragmentation history
     uint32_t heap = ESP.getFreeHeap();
     if (heap < MIN_HEAP_SIZE && lastHeap < MIN_HEAP_SIZE) {
       DEBUG_PRINTF_P(PSTR("Heap too low! %u\n"), heap);
       forceReconnect = true;
-      strip.resetSegments(); // remove all but one segments from memory
+      strip.resetSegments(true); // remove all but one segments from memory
     } else if (heap < MIN_HEAP_SIZE) {
       DEBUG_PRINTLN(F("Heap low, purging segments."));
-      strip.purgeSegments();
+      strip.purgeSegments(true);
     }
     lastHeap = heap;
     heapTime = millis();
@@ -280,6 +286,20 @@ void WLED::loop()
   loops++;
   lastRun = millis();
 #endif        // WLED_DEBUG
+
+#if WLED_MAX_IDLE_SLEEP > 0
+  // nothing to render until next frame deadline, give CPU to other tasks (network, async web server) instead of polling
+  if (!realtimeMode && !offMode && !doInitBusses) {
+    unsigned idle = std::min({strip.getTimeToNextFrame(), (unsigned)getTimeToNextCue(), (unsigned)getTimeToNextTimedState(),
+                              (unsigned)getTimeToNextPlaylistEntry()}); // wake up for next cue, timed state and playlist entry too
+    if (idle > 1) {
+      delay(std::min(idle - 1, (unsigned)WLED_MAX_IDLE_SLEEP));
+      #ifdef WLED_DEBUG
+      lastRun = millis(); // idle time is not a loop delay
+      #endif
+    }
+  }
+#endif
 }
 
 #if WLED_WATCHDOG_TIMEOUT > 0
@@ -396,6 +416,7 @@ void WLED::setup()
 
   DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
 
+  unsigned long phaseStart = millis();
   bool fsinit = false;
   DEBUGFS_PRINTLN(F("Mount FS"));
 #ifdef ARDUINO_ARCH_ESP32
@@ -413,6 +434,7 @@ void WLED::setup()
   initPresetsFile();
 #endif
   updateFSInfo();
+  bootTimes.fs = millis() - phaseStart;
 
   // generate module IDs must be done before AP setup
   escapedMac = WiFi.macAddress();
@@ -423,7 +445,9 @@ void WLED::setup()
   multiWiFi.push_back(WiFiConfig(CLIENT_SSID,CLIENT_PASS)); // initialise vector with default WiFi
 
   DEBUG_PRINTLN(F("Reading config"));
+  phaseStart = millis();
   deserializeConfigFromFS();
+  bootTimes.cfg = millis() - phaseStart;
   DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
 
 #if defined(STATUSLED) && STATUSLED>=0
@@ -435,12 +459,16 @@ void WLED::setup()
 #endif
 
   DEBUG_PRINTLN(F("Initializing strip"));
+  phaseStart = millis();
   beginStrip();
+  bootTimes.strip = millis() - phaseStart;
   DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
 
   DEBUG_PRINTLN(F("Usermods setup"));
+  phaseStart = millis();
   userSetup();
   UsermodManager::setup();
+  bootTimes.um = millis() - phaseStart;
   DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
 
   if (strcmp(multiWiFi[0].clientSSID, DEFAULT_CLIENT_SSID) == 0)
@@ -503,7 +531,9 @@ void WLED::setup()
 
   // HTTP server page init
   DEBUG_PRINTLN(F("initServer"));
+  phaseStart = millis();
   initServer();
+  bootTimes.srv = millis() - phaseStart;
   DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
 
 #ifndef WLED_DISABLE_INFRARED
@@ -524,6 +554,9 @@ void WLED::setup()
   #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_DISABLE_BROWNOUT_DET)
   WRITE_PERI_REG(RTC_CNTL_BROWN_OUT_REG, 1); //enable brownout detector
   #endif
+  bootTimes.setup = millis();
+  DEBUG_PRINTF_P(PSTR("Boot: fs %ums, cfg %ums (%s), strip %ums, usermods %ums, server %ums, setup done at %ums.\n"),
+    bootTimes.fs, bootTimes.cfg, bootTimes.cfgBinary ? "snapshot" : "json", bootTimes.strip, bootTimes.um, bootTimes.srv, bootTimes.setup);
 }
 
 void WLED::beginStrip()
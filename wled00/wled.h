@@ -441,6 +441,7 @@ WLED_GLOBAL byte cacheInvalidate       _INIT(0);       // used to invalidate bro
 WLED_GLOBAL NodesMap Nodes;
 WLED_GLOBAL bool nodeListEnabled _INIT(true);
 WLED_GLOBAL bool nodeBroadcastEnabled _INIT(true);
+WLED_GLOBAL bool clusterClockEnabled _INIT(false);  // common timebase with other nodes on the notifier port (presets, playlists and effects in sync)
 
 #ifndef WLED_DISABLE_INFRARED
 WLED_GLOBAL int8_t irPin        _INIT(IRPIN);
@@ -612,6 +613,11 @@ WLED_GLOBAL unsigned long transitionStartTime;
 WLED_GLOBAL bool          jsonTransitionOnce       _INIT(false);  // flag to override transitionDelay (playlist, JSON API: "live" & "seg":{"i"} & "tt")
 WLED_GLOBAL uint8_t       randomPaletteChangeTime  _INIT(5);      // amount of time [s] between random palette changes (min: 1s, max: 255s)
 WLED_GLOBAL bool          useHarmonicRandomPalette _INIT(true);   // use *harmonic* random palette generation (nicer looking) or truly random
+#ifdef ESP8266
+WLED_GLOBAL bool          useTransitionBuffers     _INIT(false);  // render old and new effect into separate buffers during transition (see Segment::allocTransitionBuffers())
+#else
+WLED_GLOBAL bool          useTransitionBuffers     _INIT(true);   // render old and new effect into separate buffers during transition (see Segment::allocTransitionBuffers())
+#endif
 
 // nightlight
 WLED_GLOBAL bool nightlightActive _INIT(false);
@@ -1004,6 +1010,19 @@ WLED_GLOBAL volatile uint8_t jsonBufferLock _INIT(0);
   #define DEBUGFS_PRINTF(x...)
 #endif
 
+// boot phase timings (ms) reported in info
+typedef struct BootTimes {
+  uint16_t fs;        // file system mount
+  uint16_t cfg;       // reading config (snapshot or cfg.json) incl. bus creation
+  uint16_t strip;     // strip init incl. palettes, ledmap and boot preset
+  uint16_t um;        // usermods setup
+  uint16_t srv;       // web server init
+  uint32_t setup;     // end of setup (since power-up)
+  uint32_t light;     // first frame shown (since power-up)
+  bool     cfgBinary; // config read from binary snapshot
+} boot_times_t;
+WLED_GLOBAL boot_times_t bootTimes _INIT_N(({0, 0, 0, 0, 0, 0, 0, false}));
+
 // debug macro variable definitions
 #ifdef WLED_DEBUG
   WLED_GLOBAL unsigned long debugTime _INIT(0);
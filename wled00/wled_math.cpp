@@ -14,7 +14,8 @@
 // the math.h functions use several kB of flash and are to be avoided if possible
 // sin16_t / cos16_t are faster and much more accurate than the fastled variants
 // sin_approx and cos_approx are float wrappers for sin16_t/cos16_t and have an accuracy better than +/-0.0015 compared to sinf()
-// sin8_t / cos8_t are fastled replacements and use sin16_t / cos16_t. Slightly slower than fastled version but very accurate
+// sin8_t / cos8_t are fastled replacements and use a compile time generated table of sin16_t values, very fast and very accurate
+// sin16_lut / cos16_lut / atan2_16 / sqrt32_lut use compile time generated tables for integer-only hot paths (~1.5kB of flash)
 
 
 // Taylor series approximations, replaced with Bhaskara I's approximation
@@ -59,6 +60,51 @@ float tan_t(float x) {
 }
 */
 
+/*
+ * Compile time generated lookup tables
+ * note: generators are single-statement constexpr functions to stay C++11 compatible (ESP32 core 1.x)
+ */
+// index sequence (std::index_sequence is C++14)
+template<unsigned... I> struct LutIndices {};
+template<unsigned N, unsigned... I> struct MakeLutIndices : MakeLutIndices<N-1, N-1, I...> {};
+template<unsigned... I> struct MakeLutIndices<0, I...> { typedef LutIndices<I...> type; };
+
+template<typename T, unsigned N> struct Lut { T v[N]; };
+
+template<typename T, T (*F)(unsigned), unsigned... I>
+constexpr Lut<T, sizeof...(I)> makeLut(LutIndices<I...>) { return {{ F(I)... }}; }
+
+// Taylor series for compile time evaluation only, accurate to double precision for 0 <= x <= pi/2
+static constexpr double ctSinTerm(double x, double term, double sum, int n) {
+  return n > 12 ? sum : ctSinTerm(x, -term * x * x / ((2*n) * (2*n + 1)), sum + term, n + 1);
+}
+static constexpr double ctSin(double x) { return ctSinTerm(x, x, 0.0, 1); }
+// arctangent for compile time evaluation only, 0 <= x <= 1: atan(x) = 2*atan(x / (1 + sqrt(1 + x*x))) reduces x below 0.42
+static constexpr double ctSqrtIter(double x, double r, int n) { return n == 0 ? r : ctSqrtIter(x, 0.5 * (r + x / r), n - 1); }
+static constexpr double ctSqrt(double x) { return x == 0.0 ? 0.0 : ctSqrtIter(x, x > 1.0 ? x : 1.0, 40); }
+static constexpr double ctAtanTerm(double x, double term, double sum, int n) {
+  return n > 40 ? sum : ctAtanTerm(x, -term * x * x, sum + term / (2*n - 1), n + 1);
+}
+static constexpr double ctAtan(double x) { return 2.0 * ctAtanTerm(x / (1.0 + ctSqrt(1.0 + x * x)), x / (1.0 + ctSqrt(1.0 + x * x)), 0.0, 1); }
+
+// sin8_t table: replicates the former sin16_t() based calculation bit by bit
+static constexpr uint32_t ctBhaskaraPrecal(uint32_t theta) { return theta * (0x7FFF - theta); }
+static constexpr int32_t ctBhaskara(uint32_t theta) { return (int32_t)(((uint64_t)ctBhaskaraPrecal(theta) * (4 * 0x7FFF)) / (uint64_t)(1342095361 - ctBhaskaraPrecal(theta))); }
+static constexpr int32_t ctSin16(uint32_t theta) { return theta > 0x7FFF ? -ctBhaskara(0xFFFF - theta) : ctBhaskara(theta); }
+static constexpr int32_t ctSin8Sat(int32_t v) { return v > 0xFFFF ? 0xFFFF : v; }
+static constexpr uint8_t sin8Entry(unsigned i) { return ctSin8Sat(ctSin16(i * 257) + 0x7FFF + 128) >> 8; }
+// quarter wave sine, 256 steps for 0 to pi/2, 0x7FFF = 1.0
+static constexpr int16_t sin16Entry(unsigned i) { return (int16_t)(ctSin(i * (M_PI / 512.0)) * 32767.0 + 0.5); }
+// atan(i/256) for i = 0..256 in 16bit angle units (0x10000 = 2*pi)
+static constexpr uint16_t atan16Entry(unsigned i) { return (uint16_t)(ctAtan(i / 256.0) * (65536.0 / (2.0 * M_PI)) + 0.5); }
+// sqrt(i) for i = 64..255 in 4 fractional bits (entries below 64 are unused)
+static constexpr uint16_t sqrtEntry(unsigned i) { return (uint16_t)(ctSqrt(i) * 16.0 + 0.5); }
+
+static const Lut<uint8_t, 256>  sin8LUT   PROGMEM = makeLut<uint8_t,  sin8Entry>(MakeLutIndices<256>::type());
+static const Lut<int16_t, 257>  sin16LUT  PROGMEM = makeLut<int16_t,  sin16Entry>(MakeLutIndices<257>::type());
+static const Lut<uint16_t, 257> atan16LUT PROGMEM = makeLut<uint16_t, atan16Entry>(MakeLutIndices<257>::type());
+static const Lut<uint16_t, 256> sqrtLUT   PROGMEM = makeLut<uint16_t, sqrtEntry>(MakeLutIndices<256>::type());
+
 // 16-bit, integer based Bhaskara I's sine approximation: 16*x*(pi - x) / (5*pi^2 - 4*x*(pi - x))
 // input is 16bit unsigned (0-65535), output is 16bit signed (-32767 to +32767)
 // optimized integer implementation by @dedehai
@@ -80,15 +126,53 @@ int16_t cos16_t(uint16_t theta) {
 }
 
 uint8_t sin8_t(uint8_t theta) {
-  int32_t sin16 = sin16_t((uint16_t)theta * 257); // 255 * 257 = 0xFFFF
-  sin16 += 0x7FFF + 128; //shift result to range 0-0xFFFF, +128 for rounding
-  return min(sin16, int32_t(0xFFFF)) >> 8; // min performs saturation, and prevents overflow
+  return pgm_read_byte_near(&sin8LUT.v[theta]);
 }
 
 uint8_t cos8_t(uint8_t theta) {
   return sin8_t(theta + 64); //cos(x) = sin(x+pi/2)
 }
 
+// table based sine, linear interpolation between 1024 points per period, accuracy +/-2 LSB (sin16_t: +/-54 LSB)
+// input is 16bit unsigned (0-65535), output is 16bit signed (-32767 to +32767)
+int16_t sin16_lut(uint16_t theta) {
+  unsigned t = theta & 0x3FFF;
+  if (theta & 0x4000) t = 0x4000 - t; // second and fourth quadrant are mirrored
+  unsigned idx = t >> 6;
+  unsigned frac = t & 0x3F;
+  int val = (int16_t)pgm_read_word_near(&sin16LUT.v[idx]);
+  if (frac) val += (((int)(int16_t)pgm_read_word_near(&sin16LUT.v[idx+1]) - val) * (int)frac) >> 6;
+  return (theta & 0x8000) ? -val : val; // second half is negative
+}
+
+int16_t cos16_lut(uint16_t theta) {
+  return sin16_lut(theta + 0x4000); //cos(x) = sin(x+pi/2)
+}
+
+// integer atan2, returns angle in 16bit units (0-65535 = 0 to 2*pi) as used by sin16_t()/sin16_lut(), accuracy about +/-2 units (0.01°)
+uint16_t atan2_16(int32_t y, int32_t x) {
+  uint32_t ax = x < 0 ? -(uint32_t)x : x;
+  uint32_t ay = y < 0 ? -(uint32_t)y : y;
+  if (ax == 0 && ay == 0) return 0;
+  bool swapped = ay > ax; // reduce to first octant: 0 <= num/den <= 1
+  uint32_t num = swapped ? ax : ay;
+  uint32_t den = swapped ? ay : ax;
+  if (den >= (1U << 17)) { // keep (num << 14) within 32 bits
+    unsigned shift = 15 - __builtin_clz(den);
+    num >>= shift;
+    den >>= shift;
+  }
+  uint32_t t = ((num << 14) + (den >> 1)) / den; // 0 to 0x4000, rounded
+  unsigned idx = t >> 6;
+  unsigned frac = t & 0x3F;
+  unsigned angle = pgm_read_word_near(&atan16LUT.v[idx]);
+  if (frac) angle += ((pgm_read_word_near(&atan16LUT.v[idx+1]) - angle) * frac + 32) >> 6; // rounded
+  if (swapped) angle = 0x4000 - angle; // octant 1: pi/2 - angle
+  if (x < 0)   angle = 0x8000 - angle; // quadrant 2: pi - angle
+  if (y < 0)   angle = 0x10000 - angle; // quadrants 3 & 4: 2*pi - angle
+  return angle;
+}
+
 float sin_approx(float theta) {
   uint16_t scaled_theta = (int)(theta * (float)(0xFFFF / M_TWOPI)); // note: do not cast negative float to uint! cast to int first (undefined on C3)
   int32_t result = sin16_t(scaled_theta);
@@ -221,6 +305,19 @@ float fmod_t(float num, float denom) {
   return res;
 }
 
+// table based integer square root (exact, floor), table lookup plus one Newton iteration, faster than sqrt32_bw() for large numbers
+uint32_t sqrt32_lut(uint32_t x) {
+  if (x < 4) return x > 0;
+  unsigned shift = (31 - __builtin_clz(x)) & ~1U; // even shift so that 64 <= (x >> (shift-6)) < 256
+  uint32_t idx = shift >= 6 ? x >> (shift - 6) : x << (6 - shift);
+  uint32_t res = (pgm_read_word_near(&sqrtLUT.v[idx]) << (shift >> 1)) >> 7; // approximation, relative error < 1/128
+  res = (res + x / res) >> 1; // Newton iteration
+  if (res > 0xFFFF) res = 0xFFFF;
+  while (res * res > x) res--;
+  while (res < 0xFFFF && (res + 1) * (res + 1) <= x) res++;
+  return res;
+}
+
 // bit-wise integer square root calculation (exact)
 uint32_t sqrt32_bw(uint32_t x) {
   uint32_t res = 0;
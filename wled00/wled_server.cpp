@@ -176,7 +176,9 @@ static void handleUpload(AsyncWebServerRequest *request, const String& filename,
       doReboot = true;
       request->send(200, FPSTR(CONTENT_TYPE_PLAIN), F("Configuration restore successful.\nRebooting..."));
     } else {
-      if (filename.indexOf(F("palette")) >= 0 && filename.indexOf(F(".json")) >= 0) strip.loadCustomPalettes();
+      if (filename.indexOf(F("palette")) >= 0 && filename.indexOf(F(".json")) >= 0) strip.loadCustomPalettes(true);
+      if (filename.indexOf(F("schedule.json")) >= 0) reloadSchedule();
+      if (filename.indexOf(F("presets.json")) >= 0) invalidatePrefetchedPreset(); // prefetched playlist preset may be outdated
       request->send(200, FPSTR(CONTENT_TYPE_PLAIN), F("File Uploaded!"));
     }
     cacheInvalidate++;
@@ -293,6 +295,21 @@ void initServer()
     }
 
     DeserializationError error = deserializeJson(*pDoc, (uint8_t*)(request->_tempObject));
+    const String& url = request->url();
+    if (url.indexOf(F("batch")) > -1) {
+      // array of state patches applied as one change, compact ack with number of patches applied
+      JsonArray patches = pDoc->as<JsonArray>();
+      if (error || patches.isNull()) {
+        releaseJSONBufferLock();
+        serveJsonError(request, 400, ERR_JSON);
+        return;
+      }
+      char ack[16];
+      sprintf_P(ack, PSTR("{\"ok\":%u}"), deserializeStateBatch(patches));
+      releaseJSONBufferLock();
+      request->send(200, CONTENT_TYPE_JSON, ack);
+      return;
+    }
     JsonObject root = pDoc->as<JsonObject>();
     if (error || root.isNull()) {
       releaseJSONBufferLock();
@@ -301,7 +318,6 @@ void initServer()
     }
     if (root.containsKey("pin")) checkSettingsPIN(root["pin"].as<const char*>());
 
-    const String& url = request->url();
     isConfig = url.indexOf(F("cfg")) > -1;
     if (!isConfig) {
       /*
@@ -400,7 +416,7 @@ void initServer()
       lastEditTime = millis(); // make sure PIN does not lock during update
       strip.suspend();
       #ifdef ESP8266
-      strip.resetSegments();  // free as much memory as you can
+      strip.resetSegments(true);  // free as much memory as you can
       Update.runAsync(true);
       #endif
       Update.begin((ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000);
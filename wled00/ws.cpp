@@ -1,4 +1,6 @@
 #include "wled.h"
+#include "ws_clients.h"
+#include "ws_delta.h"
 
 /*
  * WebSockets server for bidirectional communication
@@ -11,15 +13,43 @@ unsigned long wsLastLiveTime = 0;
 
 #define WS_LIVE_INTERVAL 40
 
+// incremental state updates: a client sending {"sub":true} no longer receives full state+info on every
+// interface update but only state keys that changed since last broadcast (see ws_delta.h)
+// clients that are slow to drain their queue are skipped and receive a single full {"state":...} once they
+// catch up (instead of all deltas in between)
+// info is added as "info" periodically and when realtime mode changes (see ws_clients.h)
+static WsClientList   wsClients;
+static WsInfoSchedule wsInfo;
+static WsStateDelta   wsLastState; // state as sent with last broadcast (loop() only)
+
+// writes into fixed buffer, only counts if buffer is nullptr
+class WsBufferPrint : public Print {
+  public:
+    WsBufferPrint(uint8_t *buf = nullptr, size_t size = 0) : _buf(buf), _size(size), _len(0) {}
+    size_t write(uint8_t c) override { if (_buf && _len < _size) _buf[_len] = c; _len++; return 1; }
+    size_t length() const { return _len; }
+  private:
+    uint8_t *_buf;
+    size_t   _size;
+    size_t   _len;
+};
+
+// realtime mode and source as shown in info ("live", "lm", "lip")
+static uint32_t wsLiveKey() {
+  return (uint32_t)realtimeMode << 24 ^ (uint32_t)realtimeIP;
+}
+
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
   if(type == WS_EVT_CONNECT){
     //client connected
     DEBUG_PRINTLN(F("WS client connected."));
+    wsClients.add(client->id());
     sendDataWs(client);
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
     if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    wsClients.remove(client->id());
     DEBUG_PRINTLN(F("WS client disconnected."));
   } else if(type == WS_EVT_DATA){
     // data packet
@@ -52,6 +82,8 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
           verboseResponse = true;
         } else if (root.containsKey("lv")) {
           wsLiveClientId = root["lv"] ? client->id() : 0;
+        } else if (root.containsKey("sub")) {
+          wsClients.subscribe(client->id(), root["sub"]);
         } else {
           verboseResponse = deserializeState(root);
         }
@@ -101,9 +133,104 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
   }
 }
 
+// serialize JSON into a new WS buffer, empty buffer if out of memory
+static AsyncWebSocketBuffer wsSerialize(JsonDocument &doc, size_t len) {
+  // the following may no longer be necessary as heap management has been fixed by @willmmiles in AWS
+  size_t heap1 = ESP.getFreeHeap();
+  #ifdef ESP8266
+  if (len>heap1) return AsyncWebSocketBuffer();
+  #endif
+  AsyncWebSocketBuffer buffer(len);
+  #ifdef ESP8266
+  size_t heap2 = ESP.getFreeHeap();
+  #else
+  size_t heap2 = 0; // ESP32 variants do not have the same issue and will work without checking heap allocation
+  #endif
+  if (!buffer || heap1-heap2<len) return AsyncWebSocketBuffer();
+  serializeJson(doc, (char *)buffer.data(), len);
+  return buffer;
+}
+
+// broadcast if at least one client is subscribed to incremental updates
+// subscribers get changed state keys only (and info when due), other clients get full state+info as before
+// subsOnly: periodic info update, only subscribers are sent to
+static void sendStateChangesWs(bool subsOnly = false)
+{
+  if (!requestJSONBufferLock(12)) {
+    if (!subsOnly) ws.textAll(F("{\"error\":3}")); // ERR_NOBUF
+    return;
+  }
+
+  JsonObject state = pDoc->createNestedObject("state");
+  serializeState(state);
+
+  std::vector<WsStateChange> changes;
+  wsLastState.changes(state, changes);
+
+  // work on a copy of client list, it may change in async_tcp task while sending
+  std::vector<WsClientState> clients = wsClients.snapshot();
+  std::vector<AsyncWebSocketClient*> targets(clients.size(), nullptr);
+  bool needSync = false, needFull = false;
+  for (size_t i = 0; i < clients.size(); i++) {
+    WsClientState &c = clients[i];
+    AsyncWebSocketClient *wsc = ws.client(c.id);
+    if (!wsc || (!c.sub && subsOnly)) continue; // disconnected clients are removed in wsEvent()
+    if (c.sub && wsc->queueLength() > 0) { c.sync = true; continue; } // slow client, coalesce all changes into a full state later
+    targets[i] = wsc;
+    if (c.sub) needSync |= c.sync;
+    else       needFull = true;
+  }
+  const uint32_t live = wsLiveKey();
+  const bool sendInfo = wsInfo.due(millis(), live);
+  AsyncWebSocketBuffer sync, full;
+  if (needSync && !sendInfo) sync = wsSerialize(*pDoc, measureJson(*pDoc));
+  JsonObject info;
+  if (needFull || sendInfo) {
+    info = pDoc->createNestedObject("info");
+    serializeInfo(info);
+    full = wsSerialize(*pDoc, measureJson(*pDoc));
+    if (needSync && sendInfo) sync = full;
+  }
+  JsonObjectConst deltaInfo = sendInfo ? info : JsonObject();
+  WsBufferPrint counter;
+  WsStateDelta::print(counter, changes, deltaInfo);
+  AsyncWebSocketBuffer delta(counter.length());
+  if (delta) {
+    WsBufferPrint writer((uint8_t*)delta.data(), counter.length());
+    WsStateDelta::print(writer, changes, deltaInfo);
+  }
+  DEBUG_PRINTF_P(PSTR("WS state changes: %u keys, %u bytes.\n"), changes.size(), counter.length());
+
+  bool infoSent = true;
+  for (size_t i = 0; i < clients.size(); i++) {
+    WsClientState &c = clients[i];
+    AsyncWebSocketClient *wsc = targets[i];
+    if (!wsc) continue;
+    if (!c.sub) {
+      if (full) wsc->text(full);
+      else      wsc->close(1013); // out of memory, code 1013 = temporary overload, try again later
+    } else if (c.sync && sync) { wsc->text(sync); c.sync = false; }
+    else if (!c.sync && delta)  wsc->text(delta);
+    else { c.sync = true; infoSent = false; } // out of memory, retry with full state on next broadcast
+  }
+  wsClients.update(clients);
+  if (sendInfo && infoSent) wsInfo.sent(millis(), live);
+
+  releaseJSONBufferLock();
+}
+
 void sendDataWs(AsyncWebSocketClient * client)
 {
   if (!ws.count()) return;
+  if (!client) {
+    if (wsClients.subscribers()) {
+      sendStateChangesWs();
+      return;
+    }
+    // no subscribers left, drop baseline (next subscriber gets full state first)
+    wsLastState.clear();
+    wsInfo.reset();
+  }
 
   if (!requestJSONBufferLock(12)) {
     const char* error = PSTR("{\"error\":3}");
@@ -123,30 +250,14 @@ void sendDataWs(AsyncWebSocketClient * client)
   size_t len = measureJson(*pDoc);
   DEBUG_PRINTF_P(PSTR("JSON buffer size: %u for WS request (%u).\n"), pDoc->memoryUsage(), len);
 
-  // the following may no longer be necessary as heap management has been fixed by @willmmiles in AWS
-  size_t heap1 = ESP.getFreeHeap();
-  DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
-  #ifdef ESP8266
-  if (len>heap1) {
-    DEBUG_PRINTLN(F("Out of memory (WS)!"));
-    return;
-  }
-  #endif
-  AsyncWebSocketBuffer buffer(len);
-  #ifdef ESP8266
-  size_t heap2 = ESP.getFreeHeap();
-  DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
-  #else
-  size_t heap2 = 0; // ESP32 variants do not have the same issue and will work without checking heap allocation
-  #endif
-  if (!buffer || heap1-heap2<len) {
+  AsyncWebSocketBuffer buffer = wsSerialize(*pDoc, len);
+  if (!buffer) {
     releaseJSONBufferLock();
     DEBUG_PRINTLN(F("WS buffer allocation failed."));
     ws.closeAll(1013); //code 1013 = temporary overload, try again later
     ws.cleanupClients(0); //disconnect all clients to release memory
     return; //out of memory
   }
-  serializeJson(*pDoc, (char *)buffer.data(), len);
 
   DEBUG_PRINT(F("Sending WS data "));
   if (client) {
@@ -230,6 +341,8 @@ void handleWs()
     #endif
     bool success = true;
     if (wsLiveClientId) success = sendLiveLedsWs(wsLiveClientId);
+    // subscribers only get info with state changes, keep info panel and live overlay up to date
+    if (wsInfo.due(millis(), wsLiveKey()) && ws.count() && wsClients.subscribers()) sendStateChangesWs(true);
     wsLastLiveTime = millis();
     if (!success) wsLastLiveTime -= 20; //try again in 20ms if failed due to non-empty WS queue
   }
@@ -0,0 +1,104 @@
+#pragma once
+#ifndef WLED_WS_CLIENTS_H
+#define WLED_WS_CLIENTS_H
+/*
+ * Per client state of WebSocket clients subscribed to incremental state updates (see ws.cpp)
+ *
+ * Clients connect and disconnect in wsEvent(), which runs in the async_tcp task on ESP32, while broadcasts are sent
+ * from loop(). The list is therefore only accessed under a lock and broadcasts work on a snapshot, so no lock is
+ * held while calling into AsyncWebSocket (which has locks of its own).
+ * ESP8266 runs async callbacks in loop context and needs no lock.
+ */
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#ifndef ESP8266
+#include <mutex>
+#endif
+
+#ifndef WS_INFO_INTERVAL
+#define WS_INFO_INTERVAL 5000 // ms, subscribers get info at least this often (uptime, signal, heap in info panel)
+#endif
+
+typedef struct {
+  uint32_t id;
+  bool     sub;  // subscribed to incremental updates
+  bool     sync; // needs full state on next broadcast
+  uint16_t gen;  // incremented on (un)subscribe
+} WsClientState;
+
+class WsClientList {
+  public:
+    void add(uint32_t id) {
+      Guard g(_lock);
+      if (!find(id)) _clients.push_back({id, false, false, 0});
+    }
+
+    void remove(uint32_t id) {
+      Guard g(_lock);
+      _clients.erase(std::remove_if(_clients.begin(), _clients.end(), [id](const WsClientState &c) { return c.id == id; }), _clients.end());
+    }
+
+    // subscribe (or unsubscribe) client, full state will be sent with next broadcast, deltas follow from there
+    void subscribe(uint32_t id, bool sub) {
+      Guard g(_lock);
+      WsClientState *c = find(id);
+      if (!c) return;
+      c->sub  = sub;
+      c->sync = sub;
+      c->gen++;
+    }
+
+    unsigned subscribers() const {
+      Guard g(_lock);
+      unsigned n = 0;
+      for (const auto &c : _clients) n += c.sub;
+      return n;
+    }
+
+    std::vector<WsClientState> snapshot() const {
+      Guard g(_lock);
+      return _clients;
+    }
+
+    // store sync flags of a snapshot after broadcast, clients that disconnected or (un)subscribed meanwhile are left alone
+    void update(const std::vector<WsClientState> &clients) {
+      Guard g(_lock);
+      for (const auto &s : clients) {
+        WsClientState *c = find(s.id);
+        if (c && c->gen == s.gen) c->sync = s.sync;
+      }
+    }
+
+  private:
+    #ifndef ESP8266
+    typedef std::lock_guard<std::mutex> Guard;
+    mutable std::mutex _lock;
+    #else
+    struct Guard { explicit Guard(int) {} };
+    int _lock = 0;
+    #endif
+    std::vector<WsClientState> _clients;
+
+    WsClientState* find(uint32_t id) {
+      for (auto &c : _clients) if (c.id == id) return &c;
+      return nullptr;
+    }
+};
+
+// subscribers do not get info with state changes, it is sent periodically and immediately when realtime (live)
+// mode changes so the live overlay and info panel do not go stale
+class WsInfoSchedule {
+  public:
+    bool due(uint32_t now, uint32_t live) const { return !_sent || now - _last >= WS_INFO_INTERVAL || live != _live; }
+    void sent(uint32_t now, uint32_t live)      { _last = now; _live = live; _sent = true; }
+    void reset()                                { _sent = false; }
+
+  private:
+    uint32_t _last = 0;       // millis() of last info
+    uint32_t _live = 0;       // realtime mode and IP as sent with last info
+    bool     _sent = false;
+};
+
+#endif
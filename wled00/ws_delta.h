@@ -0,0 +1,173 @@
+#pragma once
+#ifndef WLED_WS_DELTA_H
+#define WLED_WS_DELTA_H
+/*
+ * Incremental WebSocket state updates (see ws.cpp)
+ *
+ * The state as sent with the last broadcast is kept as text (key name and serialized value of every key) and each
+ * key of the new state is compared against it byte by byte, so a change can not go unnoticed.
+ * Only changed keys are sent, i.e. {"d":{"bri":128,"seg":[{"id":0,"sx":100}]}}, a removed segment as {"id":n,"stop":0}
+ * and a key that is no longer serialized (i.e. segment name) as null.
+ * ArduinoJson has to be included first. Output works with anything that has write(uint8_t) and
+ * write(const uint8_t*, size_t), i.e. Print.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+typedef struct {
+  int16_t  seg;  // -1 for top level keys
+  const char *key;  // nullptr for removed segment
+  JsonVariantConst val;
+} WsStateChange;
+
+class WsStateDelta {
+  public:
+    // collect changed keys of serialized state and make it the new baseline
+    void changes(JsonObjectConst state, std::vector<WsStateChange> &out) {
+      std::vector<Entry> cur;
+      std::vector<char>  text;
+      std::vector<uint8_t> segs;
+      cur.reserve(_entries.size());
+      text.reserve(_text.size());
+      _matched.assign(_entries.size(), false);
+      size_t pos = 0;
+      for (JsonPairConst kv : state) {
+        if (strcmp(kv.key().c_str(), "seg") == 0) continue;
+        if (changed(cur, text, pos, kv.key().c_str(), 0, kv.value())) out.push_back({-1, kv.key().c_str(), kv.value()});
+      }
+      for (JsonObjectConst seg : state["seg"].as<JsonArrayConst>()) {
+        unsigned id = seg["id"];
+        segs.push_back(id);
+        for (JsonPairConst kv : seg) {
+          if (changed(cur, text, pos, kv.key().c_str(), id + 1, kv.value())) out.push_back({(int16_t)id, kv.key().c_str(), kv.value()});
+        }
+      }
+      for (uint8_t id : _segs) {
+        if (std::find(segs.begin(), segs.end(), id) == segs.end()) out.push_back({id, nullptr, JsonVariantConst()});
+      }
+      // keys gone from top level or from a segment that is still there, names are kept until next call
+      _removed.clear();
+      for (size_t i = 0; i < _entries.size(); i++) {
+        const Entry &e = _entries[i];
+        if (_matched[i] || (e.seg && std::find(segs.begin(), segs.end(), e.seg - 1) == segs.end())) continue;
+        _removed.push_back(i);
+      }
+      if (!_removed.empty()) {
+        _removedKeys.clear();
+        for (size_t i : _removed) {
+          _removedKeys.insert(_removedKeys.end(), &_text[_entries[i].off], &_text[_entries[i].off] + _entries[i].keyLen);
+          _removedKeys.push_back('\0');
+        }
+        const char *k = _removedKeys.data();
+        for (size_t i : _removed) {
+          out.push_back({(int16_t)(_entries[i].seg - 1), k, JsonVariantConst()});
+          k += _entries[i].keyLen + 1;
+        }
+        std::stable_sort(out.begin(), out.end(), [](const WsStateChange &a, const WsStateChange &b) { return a.seg < b.seg; });
+      }
+      _entries = std::move(cur);
+      _text    = std::move(text);
+      _segs    = std::move(segs);
+    }
+
+    // {"d":{changed keys}} with info added as "info" if not null
+    template<class Out> static void print(Out &out, const std::vector<WsStateChange> &changes, JsonObjectConst info) {
+      bool comma = false;
+      int  seg   = -1;
+      put(out, "{\"d\":{");
+      for (const auto &c : changes) {
+        if (c.seg != seg) { // changes are grouped by segment, top level keys first
+          if (seg < 0) put(out, comma ? ",\"seg\":[" : "\"seg\":[");
+          else         put(out, "},");
+          seg = c.seg;
+          char id[16];
+          snprintf(id, sizeof(id), "{\"id\":%d", seg);
+          put(out, id);
+          if (!c.key) put(out, ",\"stop\":0"); // segment was removed
+        }
+        if (!c.key || (seg >= 0 && strcmp(c.key, "id") == 0)) continue;
+        if (comma || seg >= 0) out.write(',');
+        out.write('"');
+        put(out, c.key);
+        put(out, "\":");
+        serializeJson(c.val, out);
+        comma = true;
+      }
+      if (seg >= 0) put(out, "}]");
+      out.write('}');
+      if (!info.isNull()) {
+        put(out, ",\"info\":");
+        serializeJson(info, out);
+      }
+      out.write('}');
+    }
+
+    // drop baseline, next changes() reports every key
+    void clear() {
+      _entries.clear(); _entries.shrink_to_fit();
+      _text.clear();    _text.shrink_to_fit();
+      _segs.clear();    _segs.shrink_to_fit();
+      _matched.clear(); _matched.shrink_to_fit();
+      _removed.clear(); _removed.shrink_to_fit();
+      _removedKeys.clear(); _removedKeys.shrink_to_fit();
+    }
+
+    size_t memoryUsage() const { return _entries.capacity() * sizeof(Entry) + _text.capacity() + _segs.capacity(); }
+
+  private:
+    typedef struct {
+      uint32_t off;     // of key name in text, serialized value follows
+      uint16_t keyLen;
+      uint16_t valLen;
+      uint8_t  seg;     // 0 for top level keys, segment id + 1 otherwise
+    } Entry;
+
+    // appends to text
+    class TextWriter {
+      public:
+        explicit TextWriter(std::vector<char> &text) : _text(text) {}
+        size_t write(uint8_t c) { _text.push_back(c); return 1; }
+        size_t write(const uint8_t *s, size_t n) { _text.insert(_text.end(), s, s + n); return n; }
+      private:
+        std::vector<char> &_text;
+    };
+
+    std::vector<Entry>   _entries; // keys as sent with last broadcast
+    std::vector<char>    _text;    // key names and serialized values of entries
+    std::vector<uint8_t> _segs;    // segment ids as sent with last broadcast
+    std::vector<bool>    _matched; // entries found in new state
+    std::vector<size_t>  _removed; // entries not found in new state
+    std::vector<char>    _removedKeys; // their key names (null terminated) as referenced by changes
+
+    template<class Out> static void put(Out &out, const char *s) { out.write((const uint8_t*)s, strlen(s)); }
+
+    bool sameKey(const Entry &e, const char *key, size_t keyLen, uint8_t seg) const {
+      return e.seg == seg && e.keyLen == keyLen && memcmp(&_text[e.off], key, keyLen) == 0;
+    }
+
+    // add key to new baseline and compare against last broadcast (keys are mostly in same order, so try next position first)
+    bool changed(std::vector<Entry> &cur, std::vector<char> &text, size_t &pos, const char *key, uint8_t seg, JsonVariantConst val) {
+      const size_t keyLen = strlen(key);
+      Entry e = {(uint32_t)text.size(), (uint16_t)keyLen, 0, seg};
+      text.insert(text.end(), key, key + keyLen);
+      TextWriter w(text);
+      e.valLen = serializeJson(val, w);
+      cur.push_back(e);
+      const char *v = &text[e.off + keyLen];
+      size_t i = pos;
+      if (i >= _entries.size() || !sameKey(_entries[i], key, keyLen, seg)) {
+        for (i = 0; i < _entries.size() && !sameKey(_entries[i], key, keyLen, seg); i++);
+        if (i == _entries.size()) return true; // new key
+      }
+      pos = i + 1;
+      _matched[i] = true;
+      const Entry &last = _entries[i];
+      return last.valLen != e.valLen || memcmp(&_text[last.off + keyLen], v, e.valLen) != 0;
+    }
+};
+
+#endif
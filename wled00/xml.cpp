@@ -312,6 +312,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
       char sp[4] = "SP"; sp[2] = offset+s; sp[3] = 0; //bus clock speed
       char la[4] = "LA"; la[2] = offset+s; la[3] = 0; //LED current
       char ma[4] = "MA"; ma[2] = offset+s; ma[3] = 0; //max per-port PSU current
+      char dt[4] = "DT"; dt[2] = offset+s; dt[3] = 0; //temporal dithering
       settingsScript.print(F("addLEDs(1);"));
       uint8_t pins[5];
       int nPins = bus->getPins(pins);
@@ -326,6 +327,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
       printSetFormCheckbox(settingsScript,cv,bus->isReversed());
       printSetFormValue(settingsScript,sl,bus->skippedLeds());
       printSetFormCheckbox(settingsScript,rf,bus->isOffRefreshRequired());
+      printSetFormCheckbox(settingsScript,dt,bus->isDithering());
       printSetFormValue(settingsScript,aw,bus->getAutoWhiteMode());
       printSetFormValue(settingsScript,wo,bus->getColorOrder() >> 4);
       unsigned speed = bus->getFrequency();
@@ -376,6 +378,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
     printSetFormValue(settingsScript,PSTR("TD"),transitionDelayDefault);
     printSetFormValue(settingsScript,PSTR("TP"),randomPaletteChangeTime);
     printSetFormCheckbox(settingsScript,PSTR("TH"),useHarmonicRandomPalette);
+    printSetFormCheckbox(settingsScript,PSTR("TC"),useTransitionBuffers);
     printSetFormValue(settingsScript,PSTR("BF"),briMultiplier);
     printSetFormValue(settingsScript,PSTR("TB"),nightlightTargetBri);
     printSetFormValue(settingsScript,PSTR("TL"),nightlightDelayMinsDefault);
@@ -426,6 +429,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
     printSetFormCheckbox(settingsScript,PSTR("SB"),notifyButton);
     printSetFormCheckbox(settingsScript,PSTR("SH"),notifyHue);
     printSetFormValue(settingsScript,PSTR("UR"),udpNumRetries);
+    printSetFormCheckbox(settingsScript,PSTR("CK"),clusterClockEnabled);
 
     printSetFormCheckbox(settingsScript,PSTR("NL"),nodeListEnabled);
     printSetFormCheckbox(settingsScript,PSTR("NB"),nodeBroadcastEnabled);